@@ -0,0 +1,235 @@
+#pragma once
+#include "mirage_math/batch.hpp"
+#include "mirage_math/line.hpp"
+#include "mirage_math/mat3.hpp"
+#include "mirage_math/mat4.hpp"
+#include "mirage_math/perf_counters.hpp"
+#include "mirage_math/plane.hpp"
+#include "mirage_math/quaternion.hpp"
+#include "mirage_math/transform.hpp"
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace Mirage::Math::Bench {
+
+// Element counts of the per-element benchmarks, from L1 resident up to main memory
+inline void batchSizes( benchmark::internal::Benchmark* bench ) { bench->RangeMultiplier( 16 )->Range( 16, 1 << 20 ); }
+
+inline size_t batchSize( const benchmark::State& state ) { return static_cast<size_t>( state.range( 0 ) ); }
+
+inline void setItemsProcessed( benchmark::State& state, size_t count )
+{
+  state.SetItemsProcessed( state.iterations() * static_cast<int64_t>( count ) );
+}
+
+// Hardware counters per element next to the timings, when built with MIRAGE_MATH_PERF_COUNTERS
+inline void setPerfCounters( benchmark::State& state, size_t count, const PerfCounts& counts )
+{
+  if ( !threadPerfCounters().available() )
+  {
+    return;
+  }
+  const PerfRates rates              = counts.per( static_cast<uint64_t>( state.iterations() ) * count );
+  state.counters["cycles/elem"]      = rates.cycles;
+  state.counters["instr/elem"]       = rates.instructions;
+  state.counters["IPC"]              = counts.ipc();
+  state.counters["cache-miss/elem"]  = rates.cacheMisses;
+  state.counters["branch-miss/elem"] = rates.branchMisses;
+}
+
+// Times body, which processes count elements per call and keeps its results alive. The counters only see
+// the calling thread, so they leave out the workers of PAR runs.
+template<typename Body>
+void runBatch( benchmark::State& state, size_t count, Body&& body )
+{
+  const PerfCounts begin = threadPerfCounters().read();
+  for ( auto _ : state )
+  {
+    body();
+    benchmark::ClobberMemory();
+  }
+  setPerfCounters( state, count, threadPerfCounters().read() - begin );
+  setItemsProcessed( state, count );
+}
+
+// Seeded so that every run measures the same inputs
+class Random
+{
+  std::mt19937 m_engine;
+
+public:
+  explicit Random( uint32_t seed = 42 ) : m_engine( seed ) {}
+
+  float scalar( float min = -1.0F, float max = 1.0F )
+  {
+    return std::uniform_real_distribution<float>( min, max )( m_engine );
+  }
+
+  // Away from zero, for divisors and scales
+  float positive() { return scalar( 0.5F, 2.0F ); }
+  float angle() { return scalar( -PI, PI ); }
+
+  template<size_t N>
+  Vec<float, N> vec()
+  {
+    Vec<float, N> result;
+    for ( size_t i = 0; i != N; ++i )
+    {
+      result[i] = scalar();
+    }
+    return result;
+  }
+
+  Vec3 vec3() { return vec<3>(); }
+  Vec3 unitVec3() { return normalized( vec3() ); }
+
+  Point3 point3() { return Point3{ scalar( -10.0F, 10.0F ), scalar( -10.0F, 10.0F ), scalar( -10.0F, 10.0F ) }; }
+
+  template<size_t N>
+  Mat<float, N, N> mat()
+  {
+    Mat<float, N, N> result;
+    for ( size_t i = 0; i != N; ++i )
+    {
+      result[i] = vec<N>();
+    }
+    return result;
+  }
+
+  Mat3 mat3() { return mat<3>(); }
+  Mat3 symmetric()
+  {
+    const Mat3 result = mat3();
+    return result + transpose( result );
+  }
+  Mat4 mat4() { return mat<4>(); }
+
+  Quaternion unitQuaternion()
+  {
+    Quaternion result{ scalar(), scalar(), scalar(), scalar() };
+    result.normalizeInPlace();
+    return result;
+  }
+
+  Mat3 rotation() { return unitQuaternion().getRotationMatrix(); }
+
+  Transform4 transform()
+  {
+    const Mat3 basis = rotation() * positive();
+    return Transform4{ basis[0], basis[1], basis[2], point3() };
+  }
+
+  Plane plane()
+  {
+    const Vec3 normal = unitVec3();
+    return Plane{ normal.x(), normal.y(), normal.z(), scalar( -10.0F, 10.0F ) };
+  }
+
+  Line line() { return Line{ point3(), vec3() }; }
+
+  template<typename T>
+  std::vector<T> many( size_t count, T ( Random::*make )() )
+  {
+    std::vector<T> result;
+    result.reserve( count );
+    for ( size_t i = 0; i != count; ++i )
+    {
+      result.push_back( ( this->*make )() );
+    }
+    return result;
+  }
+};
+
+// Applies op to element i of every input for every i, once per iteration. This is the scalar baseline
+// the batched kernels are compared against.
+template<typename Op, typename... Inputs>
+void mapElements( benchmark::State& state, Op op, const std::vector<Inputs>&... inputs )
+{
+  using Result = std::decay_t<std::invoke_result_t<Op&, const Inputs&...>>;
+  // std::vector<bool> would measure bit packing instead of op
+  using Stored = std::conditional_t<std::is_same_v<Result, bool>, uint8_t, Result>;
+
+  const size_t        count = std::min( { inputs.size()... } );
+  std::vector<Stored> results( count );
+  runBatch( state, count, [&] {
+    for ( size_t i = 0; i != count; ++i )
+    {
+      results[i] = static_cast<Stored>( op( inputs[i]... ) );
+    }
+    benchmark::DoNotOptimize( results.data() );
+  } );
+}
+
+// Component streams of an array of vectors, for the structure-of-arrays queries
+template<size_t N>
+struct Streams
+{
+  std::array<std::vector<float>, N> components;
+
+  explicit Streams( size_t count )
+  {
+    for ( auto& component : components )
+    {
+      component.resize( count );
+    }
+  }
+
+  template<typename T>
+  explicit Streams( const std::vector<T>& elements ) : Streams( elements.size() )
+  {
+    for ( size_t i = 0; i != elements.size(); ++i )
+    {
+      for ( size_t c = 0; c != N; ++c )
+      {
+        components[c][i] = elements[i][c];
+      }
+    }
+  }
+
+  [[nodiscard]] inline SoAVec3 view() const
+    requires( N == 3 )
+  {
+    return SoAVec3{ components[0], components[1], components[2] };
+  }
+
+  [[nodiscard]] inline MutableSoAVec3 mutableView()
+    requires( N == 3 )
+  {
+    return MutableSoAVec3{ components[0], components[1], components[2] };
+  }
+
+  [[nodiscard]] inline SoAPlane planes() const
+    requires( N == 4 )
+  {
+    return SoAPlane{ components[0], components[1], components[2], components[3] };
+  }
+};
+
+// Random lines, both as objects and as component streams
+struct LineSet
+{
+  std::vector<Line> lines;
+  Streams<3>        points;
+  Streams<3>        vectors;
+
+  LineSet( Random& rng, size_t count ) : lines( rng.many( count, &Random::line ) ), points( count ), vectors( count )
+  {
+    for ( size_t i = 0; i != count; ++i )
+    {
+      for ( size_t c = 0; c != 3; ++c )
+      {
+        points.components[c][i]  = lines[i].point()[c];
+        vectors.components[c][i] = lines[i].vector()[c];
+      }
+    }
+  }
+
+  [[nodiscard]] inline SoALine view() const { return SoALine{ points.view(), vectors.view() }; }
+};
+
+} // namespace Mirage::Math::Bench
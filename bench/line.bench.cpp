@@ -0,0 +1,80 @@
+#include "bench_utils.hpp"
+#include "mirage_math/line.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace Mirage::Math;
+using namespace Mirage::Math::Bench;
+
+static void BM_LineAt( benchmark::State& state )
+{
+  Random        rng;
+  const LineSet lines( rng, batchSize( state ) );
+  const auto    t = rng.many( batchSize( state ), &Random::positive );
+  mapElements( state, []( const Line& line, float parameter ) { return line.at( parameter ); }, lines.lines, t );
+}
+BENCHMARK( BM_LineAt )->Apply( batchSizes );
+
+static void BM_LinePointDistance( benchmark::State& state )
+{
+  Random        rng;
+  const LineSet lines( rng, batchSize( state ) );
+  const auto    points = rng.many( batchSize( state ), &Random::point3 );
+  mapElements(
+    state, []( const Line& line, const Point3& point ) { return distance( point, line ); }, lines.lines, points );
+}
+BENCHMARK( BM_LinePointDistance )->Apply( batchSizes );
+
+static void BM_LineLineDistance( benchmark::State& state )
+{
+  Random        rng;
+  const LineSet a( rng, batchSize( state ) );
+  const LineSet b( rng, batchSize( state ) );
+  mapElements(
+    state, []( const Line& first, const Line& second ) { return distance( first, second ); }, a.lines, b.lines );
+}
+BENCHMARK( BM_LineLineDistance )->Apply( batchSizes );
+
+static void BM_ClosestParametersKernel( benchmark::State& state )
+{
+  Random        rng;
+  const LineSet a( rng, batchSize( state ) );
+  const LineSet b( rng, batchSize( state ) );
+  mapElements(
+    state,
+    []( const Line& first, const Line& second ) {
+      ClosestParameters parameters;
+      closestParameters( first, second, parameters );
+      return parameters;
+    },
+    a.lines,
+    b.lines );
+}
+BENCHMARK( BM_ClosestParametersKernel )->Apply( batchSizes );
+
+static void BM_ClosestParametersScalar( benchmark::State& state )
+{
+  Random        rng;
+  const LineSet a( rng, batchSize( state ) );
+  const LineSet b( rng, batchSize( state ) );
+  mapElements(
+    state,
+    []( const Line& first, const Line& second ) { return getClosestParameters( first, second ); },
+    a.lines,
+    b.lines );
+}
+BENCHMARK( BM_ClosestParametersScalar )->Apply( batchSizes );
+
+static void BM_ClosestParametersBatch( benchmark::State& state )
+{
+  Random                rng;
+  const LineSet         a( rng, batchSize( state ) );
+  const LineSet         b( rng, batchSize( state ) );
+  std::vector<float>    t1( batchSize( state ) );
+  std::vector<float>    t2( batchSize( state ) );
+  std::vector<uint64_t> skew( maskWordCount( batchSize( state ) ) );
+  runBatch( state, batchSize( state ), [&] {
+    benchmark::DoNotOptimize( getClosestParameters( a.view(), b.view(), t1, t2, skew ) );
+  } );
+}
+BENCHMARK( BM_ClosestParametersBatch )->Apply( batchSizes );
@@ -0,0 +1,141 @@
+#include "bench_utils.hpp"
+#include "mirage_math/mat.hpp"
+
+using namespace Mirage::Math;
+using namespace Mirage::Math::Bench;
+
+template<size_t N>
+using MatN = Mat<float, N, N>;
+
+template<size_t N>
+static void BM_MatIdentity( benchmark::State& state )
+{
+  for ( auto _ : state )
+  {
+    benchmark::DoNotOptimize( MatN<N>::identity() );
+  }
+}
+BENCHMARK_TEMPLATE( BM_MatIdentity, 3 );
+BENCHMARK_TEMPLATE( BM_MatIdentity, 4 );
+
+template<size_t N>
+static void BM_MatAdd( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat<N> );
+  const auto b = rng.many( batchSize( state ), &Random::mat<N> );
+  mapElements( state, []( const MatN<N>& left, const MatN<N>& right ) { return left + right; }, a, b );
+}
+BENCHMARK_TEMPLATE( BM_MatAdd, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatAdd, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_MatSubtract( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat<N> );
+  const auto b = rng.many( batchSize( state ), &Random::mat<N> );
+  mapElements( state, []( const MatN<N>& left, const MatN<N>& right ) { return left - right; }, a, b );
+}
+BENCHMARK_TEMPLATE( BM_MatSubtract, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatSubtract, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_MatNegate( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat<N> );
+  mapElements( state, []( const MatN<N>& mat ) { return -mat; }, a );
+}
+BENCHMARK_TEMPLATE( BM_MatNegate, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatNegate, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_MatMultiply( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat<N> );
+  const auto b = rng.many( batchSize( state ), &Random::mat<N> );
+  mapElements( state, []( const MatN<N>& left, const MatN<N>& right ) { return left * right; }, a, b );
+}
+BENCHMARK_TEMPLATE( BM_MatMultiply, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatMultiply, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_MatMultiplyVec( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat<N> );
+  const auto v = rng.many( batchSize( state ), &Random::vec<N> );
+  mapElements( state, []( const MatN<N>& mat, const Vec<float, N>& vec ) { return mat * vec; }, a, v );
+}
+BENCHMARK_TEMPLATE( BM_MatMultiplyVec, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatMultiplyVec, 4 )->Apply( batchSizes );
+
+// One matrix applied to many vectors, the common case in practice
+template<size_t N>
+static void BM_MatMultiplyVecShared( benchmark::State& state )
+{
+  Random        rng;
+  const MatN<N> mat = rng.mat<N>();
+  const auto    v   = rng.many( batchSize( state ), &Random::vec<N> );
+  mapElements( state, [&mat]( const Vec<float, N>& vec ) { return mat * vec; }, v );
+}
+BENCHMARK_TEMPLATE( BM_MatMultiplyVecShared, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatMultiplyVecShared, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_MatScale( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat<N> );
+  const auto s = rng.many( batchSize( state ), &Random::positive );
+  mapElements( state, []( const MatN<N>& mat, float scale ) { return mat * scale; }, a, s );
+}
+BENCHMARK_TEMPLATE( BM_MatScale, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatScale, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_MatDivide( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat<N> );
+  const auto s = rng.many( batchSize( state ), &Random::positive );
+  mapElements( state, []( const MatN<N>& mat, float div ) { return mat / div; }, a, s );
+}
+BENCHMARK_TEMPLATE( BM_MatDivide, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatDivide, 4 )->Apply( batchSizes );
+
+// The compound operators, one after the other on a copy
+template<size_t N>
+static void BM_MatCompoundAssign( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat<N> );
+  const auto b = rng.many( batchSize( state ), &Random::mat<N> );
+  const auto s = rng.many( batchSize( state ), &Random::positive );
+  mapElements(
+    state,
+    []( MatN<N> mat, const MatN<N>& other, float value ) {
+      mat += other;
+      mat *= value;
+      mat -= other;
+      mat /= value;
+      return mat;
+    },
+    a,
+    b,
+    s );
+}
+BENCHMARK_TEMPLATE( BM_MatCompoundAssign, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatCompoundAssign, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_MatTranspose( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat<N> );
+  mapElements( state, []( const MatN<N>& mat ) { return transpose( mat ); }, a );
+}
+BENCHMARK_TEMPLATE( BM_MatTranspose, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_MatTranspose, 4 )->Apply( batchSizes );
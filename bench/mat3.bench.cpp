@@ -0,0 +1,110 @@
+#include "bench_utils.hpp"
+#include "mirage_math/mat3.hpp"
+
+using namespace Mirage::Math;
+using namespace Mirage::Math::Bench;
+
+static void BM_Mat3Determinant( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat3 );
+  mapElements( state, []( const Mat3& mat ) { return determinant( mat ); }, a );
+}
+BENCHMARK( BM_Mat3Determinant )->Apply( batchSizes );
+
+static void BM_Mat3Inverse( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat3 );
+  mapElements( state, []( const Mat3& mat ) { return inverse( mat ); }, a );
+}
+BENCHMARK( BM_Mat3Inverse )->Apply( batchSizes );
+
+static void BM_Mat3EigenDecomposition( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::symmetric );
+  mapElements( state, []( const Mat3& mat ) { return eigenDecomposition( mat ); }, a );
+}
+BENCHMARK( BM_Mat3EigenDecomposition )->Apply( batchSizes );
+
+static void BM_Mat3MakeRotationX( benchmark::State& state )
+{
+  Random     rng;
+  const auto t = rng.many( batchSize( state ), &Random::angle );
+  mapElements( state, []( float angle ) { return makeRotationX( angle ); }, t );
+}
+BENCHMARK( BM_Mat3MakeRotationX )->Apply( batchSizes );
+
+static void BM_Mat3MakeRotationY( benchmark::State& state )
+{
+  Random     rng;
+  const auto t = rng.many( batchSize( state ), &Random::angle );
+  mapElements( state, []( float angle ) { return makeRotationY( angle ); }, t );
+}
+BENCHMARK( BM_Mat3MakeRotationY )->Apply( batchSizes );
+
+static void BM_Mat3MakeRotationZ( benchmark::State& state )
+{
+  Random     rng;
+  const auto t = rng.many( batchSize( state ), &Random::angle );
+  mapElements( state, []( float angle ) { return makeRotationZ( angle ); }, t );
+}
+BENCHMARK( BM_Mat3MakeRotationZ )->Apply( batchSizes );
+
+static void BM_Mat3MakeRotation( benchmark::State& state )
+{
+  Random     rng;
+  const auto t    = rng.many( batchSize( state ), &Random::angle );
+  const auto axes = rng.many( batchSize( state ), &Random::unitVec3 );
+  mapElements( state, []( float angle, const Vec3& axis ) { return makeRotation( angle, axis ); }, t, axes );
+}
+BENCHMARK( BM_Mat3MakeRotation )->Apply( batchSizes );
+
+static void BM_Mat3MakeReflection( benchmark::State& state )
+{
+  Random     rng;
+  const auto axes = rng.many( batchSize( state ), &Random::unitVec3 );
+  mapElements( state, []( const Vec3& axis ) { return makeReflection( axis ); }, axes );
+}
+BENCHMARK( BM_Mat3MakeReflection )->Apply( batchSizes );
+
+static void BM_Mat3MakeInvolution( benchmark::State& state )
+{
+  Random     rng;
+  const auto axes = rng.many( batchSize( state ), &Random::unitVec3 );
+  mapElements( state, []( const Vec3& axis ) { return makeInvolution( axis ); }, axes );
+}
+BENCHMARK( BM_Mat3MakeInvolution )->Apply( batchSizes );
+
+static void BM_Mat3MakeScale( benchmark::State& state )
+{
+  Random     rng;
+  const auto scales = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements( state, []( const Vec3& scale ) { return makeScale( scale.x(), scale.y(), scale.z() ); }, scales );
+}
+BENCHMARK( BM_Mat3MakeScale )->Apply( batchSizes );
+
+static void BM_Mat3MakeScaleAlongAxis( benchmark::State& state )
+{
+  Random     rng;
+  const auto s    = rng.many( batchSize( state ), &Random::positive );
+  const auto axes = rng.many( batchSize( state ), &Random::unitVec3 );
+  mapElements( state, []( float scale, const Vec3& axis ) { return makeScale( scale, axis ); }, s, axes );
+}
+BENCHMARK( BM_Mat3MakeScaleAlongAxis )->Apply( batchSizes );
+
+static void BM_Mat3MakeSkew( benchmark::State& state )
+{
+  Random     rng;
+  const auto t          = rng.many( batchSize( state ), &Random::angle );
+  const auto directions = rng.many( batchSize( state ), &Random::unitVec3 );
+  const auto projected  = rng.many( batchSize( state ), &Random::unitVec3 );
+  mapElements(
+    state,
+    []( float angle, const Vec3& direction, const Vec3& along ) { return makeSkew( angle, direction, along ); },
+    t,
+    directions,
+    projected );
+}
+BENCHMARK( BM_Mat3MakeSkew )->Apply( batchSizes );
@@ -0,0 +1,32 @@
+#include "bench_utils.hpp"
+#include "mirage_math/mat4.hpp"
+
+using namespace Mirage::Math;
+using namespace Mirage::Math::Bench;
+
+static void BM_Mat4Inverse( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat4 );
+  mapElements( state, []( const Mat4& mat ) { return inverse( mat ); }, a );
+}
+BENCHMARK( BM_Mat4Inverse )->Apply( batchSizes );
+
+// Products through the generic Mat operator, for comparison with compose() on transforms
+static void BM_Mat4Multiply( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::mat4 );
+  const auto b = rng.many( batchSize( state ), &Random::mat4 );
+  mapElements( state, []( const Mat4& left, const Mat4& right ) { return Mat4{ left * right }; }, a, b );
+}
+BENCHMARK( BM_Mat4Multiply )->Apply( batchSizes );
+
+static void BM_Mat4MultiplyVec( benchmark::State& state )
+{
+  Random     rng;
+  const Mat4 mat = rng.mat4();
+  const auto v   = rng.many( batchSize( state ), &Random::vec<4> );
+  mapElements( state, [&mat]( const Vec4& vec ) { return mat * vec; }, v );
+}
+BENCHMARK( BM_Mat4MultiplyVec )->Apply( batchSizes );
@@ -0,0 +1,180 @@
+#include "bench_utils.hpp"
+#include "mirage_math/batch_transform.hpp"
+#include "mirage_math/plane.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace Mirage::Math;
+using namespace Mirage::Math::Bench;
+
+static void BM_PlaneNormalizeInPlace( benchmark::State& state )
+{
+  Random     rng;
+  const auto planes = rng.many( batchSize( state ), &Random::vec<4> );
+  mapElements(
+    state,
+    []( const Vec4& coefficients ) {
+      Plane plane{ coefficients.x(), coefficients.y(), coefficients.z(), coefficients.w() };
+      plane.normalizeInPlace();
+      return plane;
+    },
+    planes );
+}
+BENCHMARK( BM_PlaneNormalizeInPlace )->Apply( batchSizes );
+
+static void BM_PlaneDotPoint( benchmark::State& state )
+{
+  Random     rng;
+  const auto planes = rng.many( batchSize( state ), &Random::plane );
+  const auto points = rng.many( batchSize( state ), &Random::point3 );
+  mapElements( state, []( const Plane& plane, const Point3& point ) { return dot( plane, point ); }, planes, points );
+}
+BENCHMARK( BM_PlaneDotPoint )->Apply( batchSizes );
+
+static void BM_PlaneDotVec( benchmark::State& state )
+{
+  Random     rng;
+  const auto planes  = rng.many( batchSize( state ), &Random::plane );
+  const auto vectors = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements( state, []( const Plane& plane, const Vec3& vec ) { return dot( plane, vec ); }, planes, vectors );
+}
+BENCHMARK( BM_PlaneDotVec )->Apply( batchSizes );
+
+static void BM_PlaneMakeReflection( benchmark::State& state )
+{
+  Random     rng;
+  const auto planes = rng.many( batchSize( state ), &Random::plane );
+  mapElements( state, []( const Plane& plane ) { return makeReflection( plane ); }, planes );
+}
+BENCHMARK( BM_PlaneMakeReflection )->Apply( batchSizes );
+
+static void BM_TransformPlanesScalar( benchmark::State& state )
+{
+  Random           rng;
+  const Transform4 transform = rng.transform();
+  const auto       planes    = rng.many( batchSize( state ), &Random::plane );
+  mapElements( state, [&transform]( const Plane& plane ) { return plane * transform; }, planes );
+}
+BENCHMARK( BM_TransformPlanesScalar )->Apply( batchSizes );
+
+static void BM_TransformPlanesBatch( benchmark::State& state, Execution execution )
+{
+  Random             rng;
+  const Transform4   transform = rng.transform();
+  const auto         planes    = rng.many( batchSize( state ), &Random::plane );
+  std::vector<Plane> moved( planes.size() );
+  runBatch( state, planes.size(), [&] {
+    transformPlanes( transform, planes, moved, { .execution = execution } );
+    benchmark::DoNotOptimize( moved.data() );
+  } );
+}
+BENCHMARK_CAPTURE( BM_TransformPlanesBatch, seq, Execution::SEQ )->Apply( batchSizes );
+BENCHMARK_CAPTURE( BM_TransformPlanesBatch, unseq, Execution::UNSEQ )->Apply( batchSizes );
+BENCHMARK_CAPTURE( BM_TransformPlanesBatch, par, Execution::PAR )->Apply( batchSizes )->UseRealTime();
+
+// The intersections through the std::optional queries are the scalar baselines of the batched
+// getIntersections() overloads
+
+static void BM_PlaneLineIntersectionScalar( benchmark::State& state )
+{
+  Random        rng;
+  const auto    planes = rng.many( batchSize( state ), &Random::plane );
+  const LineSet lines( rng, batchSize( state ) );
+  mapElements(
+    state,
+    []( const Plane& plane, const Line& line ) { return getIntersection( plane, line ); },
+    planes,
+    lines.lines );
+}
+BENCHMARK( BM_PlaneLineIntersectionScalar )->Apply( batchSizes );
+
+static void BM_PlaneLineIntersectionBatch( benchmark::State& state )
+{
+  Random                rng;
+  const Streams<4>      planes( rng.many( batchSize( state ), &Random::plane ) );
+  const LineSet         lines( rng, batchSize( state ) );
+  Streams<3>            points( batchSize( state ) );
+  std::vector<uint64_t> valid( maskWordCount( batchSize( state ) ) );
+  runBatch( state, batchSize( state ), [&] {
+    benchmark::DoNotOptimize( getIntersections( planes.planes(), lines.view(), points.mutableView(), valid ) );
+  } );
+}
+BENCHMARK( BM_PlaneLineIntersectionBatch )->Apply( batchSizes );
+
+static void BM_SharedPlaneLineIntersectionScalar( benchmark::State& state )
+{
+  Random        rng;
+  const Plane   plane = rng.plane();
+  const LineSet lines( rng, batchSize( state ) );
+  mapElements( state, [&plane]( const Line& line ) { return getIntersection( plane, line ); }, lines.lines );
+}
+BENCHMARK( BM_SharedPlaneLineIntersectionScalar )->Apply( batchSizes );
+
+static void BM_SharedPlaneLineIntersectionBatch( benchmark::State& state )
+{
+  Random                rng;
+  const Plane           plane = rng.plane();
+  const LineSet         lines( rng, batchSize( state ) );
+  Streams<3>            points( batchSize( state ) );
+  std::vector<uint64_t> valid( maskWordCount( batchSize( state ) ) );
+  runBatch( state, batchSize( state ), [&] {
+    benchmark::DoNotOptimize( getIntersections( plane, lines.view(), points.mutableView(), valid ) );
+  } );
+}
+BENCHMARK( BM_SharedPlaneLineIntersectionBatch )->Apply( batchSizes );
+
+static void BM_ThreePlaneIntersectionScalar( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::plane );
+  const auto b = rng.many( batchSize( state ), &Random::plane );
+  const auto c = rng.many( batchSize( state ), &Random::plane );
+  mapElements(
+    state,
+    []( const Plane& first, const Plane& second, const Plane& third ) {
+      return getIntersection( first, second, third );
+    },
+    a,
+    b,
+    c );
+}
+BENCHMARK( BM_ThreePlaneIntersectionScalar )->Apply( batchSizes );
+
+static void BM_ThreePlaneIntersectionBatch( benchmark::State& state )
+{
+  Random                rng;
+  const Streams<4>      a( rng.many( batchSize( state ), &Random::plane ) );
+  const Streams<4>      b( rng.many( batchSize( state ), &Random::plane ) );
+  const Streams<4>      c( rng.many( batchSize( state ), &Random::plane ) );
+  Streams<3>            points( batchSize( state ) );
+  std::vector<uint64_t> valid( maskWordCount( batchSize( state ) ) );
+  runBatch( state, batchSize( state ), [&] {
+    benchmark::DoNotOptimize( getIntersections( a.planes(), b.planes(), c.planes(), points.mutableView(), valid ) );
+  } );
+}
+BENCHMARK( BM_ThreePlaneIntersectionBatch )->Apply( batchSizes );
+
+static void BM_TwoPlaneIntersectionScalar( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::plane );
+  const auto b = rng.many( batchSize( state ), &Random::plane );
+  mapElements(
+    state, []( const Plane& first, const Plane& second ) { return getIntersection( first, second ); }, a, b );
+}
+BENCHMARK( BM_TwoPlaneIntersectionScalar )->Apply( batchSizes );
+
+static void BM_TwoPlaneIntersectionBatch( benchmark::State& state )
+{
+  Random                rng;
+  const Streams<4>      a( rng.many( batchSize( state ), &Random::plane ) );
+  const Streams<4>      b( rng.many( batchSize( state ), &Random::plane ) );
+  Streams<3>            points( batchSize( state ) );
+  Streams<3>            vectors( batchSize( state ) );
+  std::vector<uint64_t> valid( maskWordCount( batchSize( state ) ) );
+  runBatch( state, batchSize( state ), [&] {
+    benchmark::DoNotOptimize(
+      getIntersections( a.planes(), b.planes(), points.mutableView(), vectors.mutableView(), valid ) );
+  } );
+}
+BENCHMARK( BM_TwoPlaneIntersectionBatch )->Apply( batchSizes );
@@ -0,0 +1,101 @@
+#include "bench_utils.hpp"
+#include "mirage_math/batch_transform.hpp"
+#include "mirage_math/quaternion.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace Mirage::Math;
+using namespace Mirage::Math::Bench;
+
+static void BM_QuaternionGetRotationMatrix( benchmark::State& state )
+{
+  Random     rng;
+  const auto q = rng.many( batchSize( state ), &Random::unitQuaternion );
+  mapElements( state, []( const Quaternion& quat ) { return quat.getRotationMatrix(); }, q );
+}
+BENCHMARK( BM_QuaternionGetRotationMatrix )->Apply( batchSizes );
+
+// The branch of setRotationFromMatrix() a rotation takes
+static int rotationBranch( const Mat3& rotation )
+{
+  const float m00 = rotation( 0, 0 );
+  const float m11 = rotation( 1, 1 );
+  const float m22 = rotation( 2, 2 );
+  if ( m00 + m11 + m22 > 0.0F )
+  {
+    return 0;
+  }
+  if ( m00 > m11 && m00 > m22 )
+  {
+    return 1;
+  }
+  return m11 > m22 ? 2 : 3;
+}
+
+// Random rotations take every branch of the trace test in no particular order; grouped by branch, the same
+// rotations are predictable, which separates the cost of mispredicts from the arithmetic
+static void BM_QuaternionSetRotationFromMatrix( benchmark::State& state, bool grouped )
+{
+  Random rng;
+  auto   rotations = rng.many( batchSize( state ), &Random::rotation );
+  if ( grouped )
+  {
+    std::stable_sort( rotations.begin(), rotations.end(), []( const Mat3& a, const Mat3& b ) {
+      return rotationBranch( a ) < rotationBranch( b );
+    } );
+  }
+  mapElements(
+    state,
+    []( const Mat3& rotation ) {
+      Quaternion quat;
+      quat.setRotationFromMatrix( rotation );
+      return quat;
+    },
+    rotations );
+}
+BENCHMARK_CAPTURE( BM_QuaternionSetRotationFromMatrix, random, false )->Apply( batchSizes );
+BENCHMARK_CAPTURE( BM_QuaternionSetRotationFromMatrix, grouped, true )->Apply( batchSizes );
+
+static void BM_QuaternionMultiply( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::unitQuaternion );
+  const auto b = rng.many( batchSize( state ), &Random::unitQuaternion );
+  mapElements( state, []( const Quaternion& left, const Quaternion& right ) { return left * right; }, a, b );
+}
+BENCHMARK( BM_QuaternionMultiply )->Apply( batchSizes );
+
+static void BM_QuaternionTransform( benchmark::State& state )
+{
+  Random     rng;
+  const auto v = rng.many( batchSize( state ), &Random::vec3 );
+  const auto q = rng.many( batchSize( state ), &Random::unitQuaternion );
+  mapElements( state, []( const Vec3& vec, const Quaternion& quat ) { return transform( vec, quat ); }, v, q );
+}
+BENCHMARK( BM_QuaternionTransform )->Apply( batchSizes );
+
+// One rotation applied to many vectors: per element with the quaternion, against converting it once
+// and running the batch transform
+static void BM_QuaternionRotateVectorsScalar( benchmark::State& state )
+{
+  Random           rng;
+  const Quaternion quat    = rng.unitQuaternion();
+  const auto       vectors = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements( state, [&quat]( const Vec3& vec ) { return transform( vec, quat ); }, vectors );
+}
+BENCHMARK( BM_QuaternionRotateVectorsScalar )->Apply( batchSizes );
+
+static void BM_QuaternionRotateVectorsBatch( benchmark::State& state )
+{
+  Random            rng;
+  const Quaternion  quat    = rng.unitQuaternion();
+  const auto        vectors = rng.many( batchSize( state ), &Random::vec3 );
+  std::vector<Vec3> turned( vectors.size() );
+  runBatch( state, vectors.size(), [&] {
+    const Mat3       rotation = quat.getRotationMatrix();
+    const Transform4 transform{ rotation[0], rotation[1], rotation[2], Point3{ 0.0F, 0.0F, 0.0F } };
+    transformVectors( transform, vectors, turned );
+    benchmark::DoNotOptimize( turned.data() );
+  } );
+}
+BENCHMARK( BM_QuaternionRotateVectorsBatch )->Apply( batchSizes );
@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+"""Benchmark regression gate for mirage_math_bench.
+
+Runs the benchmark suite with repetitions and compares the results against a stored baseline:
+
+    regression.py run --binary BENCH --output results.json
+    regression.py compare baseline.json results.json
+    regression.py check --binary BENCH --baseline baseline.json
+
+A benchmark regresses when the median of its repetitions is slower than the baseline median by more
+than --threshold, and the difference is also larger than --noise times the combined spread of both
+runs (the median absolute deviation, scaled to a standard deviation). The second condition keeps
+noisy benchmarks from failing the gate on jitter; with a single repetition only the threshold applies.
+Benchmarks of the baseline that are missing from the results, or that reported an error, fail the gate
+as well. With --filter only the baseline benchmarks matching it are expected.
+
+Exit codes: 0 when nothing regressed, 1 on a regression or a missing or failed benchmark, 2 on bad input.
+"""
+
+import argparse
+import json
+import math
+import re
+import statistics
+import subprocess
+import sys
+from pathlib import Path
+
+# Scales the median absolute deviation to the standard deviation of normally distributed samples
+MAD_TO_SIGMA = 1.4826
+
+TIME_UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+EXIT_OK = 0
+EXIT_REGRESSION = 1
+EXIT_BAD_INPUT = 2
+
+
+class InputError(Exception):
+    pass
+
+
+def run_benchmarks(binary, output, repetitions, min_time, bench_filter):
+    command = [
+        str(binary),
+        f"--benchmark_out={output}",
+        "--benchmark_out_format=json",
+        f"--benchmark_repetitions={repetitions}",
+        f"--benchmark_min_time={min_time}",
+        # Spreads slow drift of the machine over every benchmark instead of the last ones run
+        "--benchmark_enable_random_interleaving=true",
+    ]
+    if bench_filter:
+        command.append(f"--benchmark_filter={bench_filter}")
+    Path(output).parent.mkdir(parents=True, exist_ok=True)
+    if subprocess.run(command, check=False).returncode != 0:
+        raise InputError(f"{binary} failed")
+
+
+def load_samples(path, metric):
+    """Returns the context of a results file, the per-repetition times in ns of every benchmark, and the
+    error message of every benchmark that failed."""
+    try:
+        with open(path, encoding="utf-8") as file:
+            results = json.load(file)
+    except (OSError, json.JSONDecodeError) as error:
+        raise InputError(f"cannot read {path}: {error}") from error
+
+    samples = {}
+    errors = {}
+    for entry in results.get("benchmarks", []):
+        if entry.get("run_type", "iteration") != "iteration":
+            continue
+        name = entry.get("run_name", entry["name"])
+        if entry.get("error_occurred"):
+            errors[name] = entry.get("error_message", "")
+            continue
+        samples.setdefault(name, []).append(entry[metric] * TIME_UNIT_NS[entry.get("time_unit", "ns")])
+    return results.get("context", {}), samples, errors
+
+
+def make_name_filter(bench_filter):
+    """Matches names the way --benchmark_filter selects them: a regex search, negated by a leading '-'."""
+    if not bench_filter:
+        return lambda name: True
+    negate = bench_filter.startswith("-")
+    try:
+        pattern = re.compile(bench_filter[1:] if negate else bench_filter)
+    except re.error as error:
+        raise InputError(f"bad filter {bench_filter!r}: {error}") from error
+    return lambda name: (pattern.search(name) is None) == negate
+
+
+def median_and_sigma(values):
+    median = statistics.median(values)
+    mad = statistics.median(abs(value - median) for value in values)
+    return median, mad * MAD_TO_SIGMA
+
+
+def format_time(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3g} {unit}"
+    return f"{ns:.3g} ns"
+
+
+def compare(baseline_path, current_path, metric, threshold, noise, verbose, bench_filter=""):
+    baseline_context, baseline, _ = load_samples(baseline_path, metric)
+    current_context, current, errors = load_samples(current_path, metric)
+    if not current and not errors:
+        raise InputError(f"{current_path} has no benchmark results")
+
+    # A filtered run only covers part of the baseline
+    selected = make_name_filter(bench_filter)
+    baseline = {name: values for name, values in baseline.items() if selected(name)}
+
+    for key in ("host_name", "num_cpus", "library_build_type"):
+        if baseline_context.get(key) != current_context.get(key):
+            print(f"warning: {key} differs from the baseline "
+                  f"({baseline_context.get(key)} vs {current_context.get(key)})")
+
+    rows = []
+    regressions = 0
+    failures = 0
+    for name in sorted(set(baseline) | set(current) | set(errors)):
+        if name in errors:
+            rows.append((name, "FAILED", "", "", "", ""))
+            failures += 1
+            continue
+        if name not in current:
+            rows.append((name, "MISSING", "", "", "", ""))
+            failures += 1
+            continue
+        current_median, current_sigma = median_and_sigma(current[name])
+        if name not in baseline:
+            rows.append((name, "new", "", format_time(current_median), "", ""))
+            continue
+        baseline_median, baseline_sigma = median_and_sigma(baseline[name])
+
+        change = current_median / baseline_median - 1.0 if baseline_median > 0 else 0.0
+        spread = noise * math.hypot(baseline_sigma, current_sigma)
+        significant = abs(current_median - baseline_median) > spread
+        if change > threshold and significant:
+            status = "REGRESSED"
+            regressions += 1
+        elif change < -threshold and significant:
+            status = "improved"
+        else:
+            status = "ok"
+        rows.append((name, status, format_time(baseline_median), format_time(current_median), f"{change:+.1%}",
+                     f"{spread / baseline_median:.1%}" if baseline_median > 0 else ""))
+
+    shown = [row for row in rows if verbose or row[1] != "ok"]
+    if shown:
+        header = ("benchmark", "status", "baseline", "current", "change", "noise")
+        widths = [max(len(row[i]) for row in [header, *shown]) for i in range(len(header))]
+        for row in [header, *shown]:
+            print("  ".join(cell.ljust(width) for cell, width in zip(row, widths)).rstrip())
+    for name, message in sorted(errors.items()):
+        print(f"{name} failed: {message}")
+
+    compared = sum(1 for row in rows if row[1] in ("ok", "improved", "REGRESSED"))
+    print(f"{compared} benchmarks compared, {regressions} regressed, {failures} missing or failed "
+          f"(threshold {threshold:.0%}, noise {noise:g} sigma, {metric})")
+    return EXIT_REGRESSION if regressions or failures else EXIT_OK
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    def add_run_arguments(command):
+        command.add_argument("--binary", required=True, help="mirage_math_bench executable")
+        command.add_argument("--repetitions", type=int, default=10)
+        command.add_argument("--min-time", type=float, default=0.1, help="seconds per repetition")
+        command.add_argument("--filter", default="", help="benchmark name regex")
+
+    def add_compare_arguments(command):
+        command.add_argument("--metric", choices=("real_time", "cpu_time"), default="real_time")
+        command.add_argument("--threshold", type=float, default=0.05, help="relative slowdown that fails")
+        command.add_argument("--noise", type=float, default=3.0, help="required difference in sigmas")
+        command.add_argument("--verbose", action="store_true", help="list unchanged benchmarks too")
+
+    run = commands.add_parser("run", help="run the benchmarks and write JSON results")
+    add_run_arguments(run)
+    run.add_argument("--output", required=True)
+
+    comparison = commands.add_parser("compare", help="compare two JSON results")
+    comparison.add_argument("baseline")
+    comparison.add_argument("current")
+    comparison.add_argument("--filter", default="", help="benchmark name regex the results were run with")
+    add_compare_arguments(comparison)
+
+    check = commands.add_parser("check", help="run the benchmarks and compare them against a baseline")
+    add_run_arguments(check)
+    check.add_argument("--baseline", required=True)
+    check.add_argument("--output", help="where to keep the results, next to the baseline by default")
+    add_compare_arguments(check)
+
+    args = parser.parse_args()
+    try:
+        if args.command == "run":
+            run_benchmarks(args.binary, args.output, args.repetitions, args.min_time, args.filter)
+            return EXIT_OK
+        if args.command == "check":
+            if not Path(args.baseline).is_file():
+                raise InputError(f"no baseline at {args.baseline}, record one with the run command first")
+            output = args.output or str(Path(args.baseline).with_suffix(".current.json"))
+            run_benchmarks(args.binary, output, args.repetitions, args.min_time, args.filter)
+            return compare(args.baseline, output, args.metric, args.threshold, args.noise, args.verbose, args.filter)
+        return compare(args.baseline, args.current, args.metric, args.threshold, args.noise, args.verbose,
+                       args.filter)
+    except InputError as error:
+        print(f"error: {error}", file=sys.stderr)
+        return EXIT_BAD_INPUT
+
+
+if __name__ == "__main__":
+    sys.exit(main())
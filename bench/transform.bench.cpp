@@ -0,0 +1,139 @@
+#include "bench_utils.hpp"
+#include "mirage_math/batch_transform.hpp"
+#include "mirage_math/transform.hpp"
+#include <vector>
+
+using namespace Mirage::Math;
+using namespace Mirage::Math::Bench;
+
+static void BM_Transform4Inverse( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::transform );
+  mapElements( state, []( const Transform4& transform ) { return inverse( transform ); }, a );
+}
+BENCHMARK( BM_Transform4Inverse )->Apply( batchSizes );
+
+static void BM_Transform4Compose( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::transform );
+  const auto b = rng.many( batchSize( state ), &Random::transform );
+  mapElements(
+    state, []( const Transform4& first, const Transform4& second ) { return compose( first, second ); }, a, b );
+}
+BENCHMARK( BM_Transform4Compose )->Apply( batchSizes );
+
+static void BM_Transform4Translation( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::transform );
+  const auto p = rng.many( batchSize( state ), &Random::point3 );
+  mapElements(
+    state,
+    []( Transform4 transform, const Point3& point ) {
+      transform.setTranslation( transform.getTranslation() + point );
+      return transform;
+    },
+    a,
+    p );
+}
+BENCHMARK( BM_Transform4Translation )->Apply( batchSizes );
+
+// Per-element operators, as the scalar baseline of the batch transforms below
+
+static void BM_TransformPointsScalar( benchmark::State& state )
+{
+  Random           rng;
+  const Transform4 transform = rng.transform();
+  const auto       points    = rng.many( batchSize( state ), &Random::point3 );
+  mapElements( state, [&transform]( const Point3& point ) { return transform * point; }, points );
+}
+BENCHMARK( BM_TransformPointsScalar )->Apply( batchSizes );
+
+static void BM_TransformVectorsScalar( benchmark::State& state )
+{
+  Random           rng;
+  const Transform4 transform = rng.transform();
+  const auto       vectors   = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements( state, [&transform]( const Vec3& vec ) { return transform * vec; }, vectors );
+}
+BENCHMARK( BM_TransformVectorsScalar )->Apply( batchSizes );
+
+static void BM_TransformNormalsScalar( benchmark::State& state )
+{
+  Random           rng;
+  const Transform4 transform = rng.transform();
+  const auto       normals   = rng.many( batchSize( state ), &Random::unitVec3 );
+  mapElements( state, [&transform]( const Vec3& normal ) { return normal * transform; }, normals );
+}
+BENCHMARK( BM_TransformNormalsScalar )->Apply( batchSizes );
+
+// The batch transforms with each execution. PAR is timed on the wall clock since the workers' CPU time
+// is not counted, and runs inline below the default parallel threshold.
+
+static void BM_TransformPointsBatch( benchmark::State& state, Execution execution )
+{
+  Random              rng;
+  const Transform4    transform = rng.transform();
+  const auto          points    = rng.many( batchSize( state ), &Random::point3 );
+  std::vector<Point3> moved( points.size() );
+  runBatch( state, points.size(), [&] {
+    transformPoints( transform, points, moved, { .execution = execution } );
+    benchmark::DoNotOptimize( moved.data() );
+  } );
+}
+BENCHMARK_CAPTURE( BM_TransformPointsBatch, seq, Execution::SEQ )->Apply( batchSizes );
+BENCHMARK_CAPTURE( BM_TransformPointsBatch, unseq, Execution::UNSEQ )->Apply( batchSizes );
+BENCHMARK_CAPTURE( BM_TransformPointsBatch, par, Execution::PAR )->Apply( batchSizes )->UseRealTime();
+
+static void BM_TransformVectorsBatch( benchmark::State& state, Execution execution )
+{
+  Random            rng;
+  const Transform4  transform = rng.transform();
+  const auto        vectors   = rng.many( batchSize( state ), &Random::vec3 );
+  std::vector<Vec3> turned( vectors.size() );
+  runBatch( state, vectors.size(), [&] {
+    transformVectors( transform, vectors, turned, { .execution = execution } );
+    benchmark::DoNotOptimize( turned.data() );
+  } );
+}
+BENCHMARK_CAPTURE( BM_TransformVectorsBatch, seq, Execution::SEQ )->Apply( batchSizes );
+BENCHMARK_CAPTURE( BM_TransformVectorsBatch, unseq, Execution::UNSEQ )->Apply( batchSizes );
+BENCHMARK_CAPTURE( BM_TransformVectorsBatch, par, Execution::PAR )->Apply( batchSizes )->UseRealTime();
+
+static void BM_TransformNormalsBatch( benchmark::State& state, Execution execution )
+{
+  Random            rng;
+  const Transform4  transform = rng.transform();
+  const auto        normals   = rng.many( batchSize( state ), &Random::unitVec3 );
+  std::vector<Vec3> turned( normals.size() );
+  runBatch( state, normals.size(), [&] {
+    transformNormals( transform, normals, turned, { .execution = execution } );
+    benchmark::DoNotOptimize( turned.data() );
+  } );
+}
+BENCHMARK_CAPTURE( BM_TransformNormalsBatch, seq, Execution::SEQ )->Apply( batchSizes );
+BENCHMARK_CAPTURE( BM_TransformNormalsBatch, unseq, Execution::UNSEQ )->Apply( batchSizes );
+BENCHMARK_CAPTURE( BM_TransformNormalsBatch, par, Execution::PAR )->Apply( batchSizes )->UseRealTime();
+
+// Interleaved position and normal, transformed through strided views
+static void BM_TransformStridedVerticesBatch( benchmark::State& state )
+{
+  Random             rng;
+  const Transform4   transform = rng.transform();
+  std::vector<float> vertices( batchSize( state ) * 6 );
+  for ( auto& value : vertices )
+  {
+    value = rng.scalar();
+  }
+  constexpr size_t STRIDE    = 6 * sizeof( float );
+  const auto       positions = makeStridedSpan<Point3>( std::span<float>{ vertices }, 0, STRIDE );
+  const auto       normals   = makeStridedSpan<Vec3>( std::span<float>{ vertices }, 3 * sizeof( float ), STRIDE );
+  runBatch( state, batchSize( state ), [&] {
+    transformPoints( transform, positions, positions );
+    transformNormals( transform, normals, normals );
+    benchmark::DoNotOptimize( vertices.data() );
+  } );
+}
+BENCHMARK( BM_TransformStridedVerticesBatch )->Apply( batchSizes );
@@ -0,0 +1,199 @@
+#include "bench_utils.hpp"
+#include "mirage_math/vec.hpp"
+#include <string>
+
+using namespace Mirage::Math;
+using namespace Mirage::Math::Bench;
+
+template<size_t N>
+static void BM_VecAdd( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec<N> );
+  const auto b = rng.many( batchSize( state ), &Random::vec<N> );
+  mapElements( state, []( const Vec<float, N>& left, const Vec<float, N>& right ) { return left + right; }, a, b );
+}
+BENCHMARK_TEMPLATE( BM_VecAdd, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_VecAdd, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_VecSubtract( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec<N> );
+  const auto b = rng.many( batchSize( state ), &Random::vec<N> );
+  mapElements( state, []( const Vec<float, N>& left, const Vec<float, N>& right ) { return left - right; }, a, b );
+}
+BENCHMARK_TEMPLATE( BM_VecSubtract, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_VecSubtract, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_VecNegate( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec<N> );
+  mapElements( state, []( const Vec<float, N>& vec ) { return -vec; }, a );
+}
+BENCHMARK_TEMPLATE( BM_VecNegate, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_VecNegate, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_VecScale( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec<N> );
+  const auto s = rng.many( batchSize( state ), &Random::positive );
+  mapElements( state, []( const Vec<float, N>& vec, float scale ) { return vec * scale; }, a, s );
+}
+BENCHMARK_TEMPLATE( BM_VecScale, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_VecScale, 4 )->Apply( batchSizes );
+
+static void BM_Vec3ScaleLeft( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec3 );
+  const auto s = rng.many( batchSize( state ), &Random::positive );
+  mapElements( state, []( const Vec3& vec, float scale ) { return scale * vec; }, a, s );
+}
+BENCHMARK( BM_Vec3ScaleLeft )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_VecDivide( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec<N> );
+  const auto s = rng.many( batchSize( state ), &Random::positive );
+  mapElements( state, []( const Vec<float, N>& vec, float div ) { return vec / div; }, a, s );
+}
+BENCHMARK_TEMPLATE( BM_VecDivide, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_VecDivide, 4 )->Apply( batchSizes );
+
+// The compound scalar operators, one after the other on a copy
+static void BM_Vec3CompoundAssign( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec3 );
+  const auto s = rng.many( batchSize( state ), &Random::positive );
+  mapElements(
+    state,
+    []( Vec3 vec, float value ) {
+      vec += value;
+      vec *= value;
+      vec -= value;
+      vec /= value;
+      return vec;
+    },
+    a,
+    s );
+}
+BENCHMARK( BM_Vec3CompoundAssign )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_VecMagnitudeSquared( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec<N> );
+  mapElements( state, []( const Vec<float, N>& vec ) { return magnitudeSquared( vec ); }, a );
+}
+BENCHMARK_TEMPLATE( BM_VecMagnitudeSquared, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_VecMagnitudeSquared, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_VecMagnitude( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec<N> );
+  mapElements( state, []( const Vec<float, N>& vec ) { return magnitude( vec ); }, a );
+}
+BENCHMARK_TEMPLATE( BM_VecMagnitude, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_VecMagnitude, 4 )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_VecNormalized( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec<N> );
+  mapElements( state, []( const Vec<float, N>& vec ) { return normalized( vec ); }, a );
+}
+BENCHMARK_TEMPLATE( BM_VecNormalized, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_VecNormalized, 4 )->Apply( batchSizes );
+
+static void BM_Vec3NormalizeInPlace( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements(
+    state,
+    []( Vec3 vec ) {
+      vec.normalizeInPlace();
+      return vec;
+    },
+    a );
+}
+BENCHMARK( BM_Vec3NormalizeInPlace )->Apply( batchSizes );
+
+template<size_t N>
+static void BM_VecDot( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec<N> );
+  const auto b = rng.many( batchSize( state ), &Random::vec<N> );
+  mapElements(
+    state, []( const Vec<float, N>& left, const Vec<float, N>& right ) { return dot( left, right ); }, a, b );
+}
+BENCHMARK_TEMPLATE( BM_VecDot, 3 )->Apply( batchSizes );
+BENCHMARK_TEMPLATE( BM_VecDot, 4 )->Apply( batchSizes );
+
+static void BM_Vec3Cross( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec3 );
+  const auto b = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements( state, []( const Vec3& left, const Vec3& right ) { return cross( left, right ); }, a, b );
+}
+BENCHMARK( BM_Vec3Cross )->Apply( batchSizes );
+
+static void BM_Vec3Project( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec3 );
+  const auto b = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements( state, []( const Vec3& source, const Vec3& target ) { return project( source, target ); }, a, b );
+}
+BENCHMARK( BM_Vec3Project )->Apply( batchSizes );
+
+static void BM_Vec3Reject( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec3 );
+  const auto b = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements( state, []( const Vec3& source, const Vec3& target ) { return reject( source, target ); }, a, b );
+}
+BENCHMARK( BM_Vec3Reject )->Apply( batchSizes );
+
+static void BM_Vec3MinMax( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec3 );
+  const auto b = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements(
+    state, []( const Vec3& left, const Vec3& right ) { return min( left, right ) + max( left, right ); }, a, b );
+}
+BENCHMARK( BM_Vec3MinMax )->Apply( batchSizes );
+
+static void BM_Vec3IsUnitVector( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::unitVec3 );
+  mapElements( state, []( const Vec3& vec ) { return isUnitVector( vec ); }, a );
+}
+BENCHMARK( BM_Vec3IsUnitVector )->Apply( batchSizes );
+
+// Formatting allocates per element, so the larger sizes only add run time
+static void BM_Vec3ToString( benchmark::State& state )
+{
+  Random     rng;
+  const auto a = rng.many( batchSize( state ), &Random::vec3 );
+  mapElements( state, []( const Vec3& vec ) { return static_cast<std::string>( vec ); }, a );
+}
+BENCHMARK( BM_Vec3ToString )->RangeMultiplier( 16 )->Range( 16, 1 << 12 );
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "point.hpp"
+#include "strided_span.hpp"
+#include "transform.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <span>
+
+namespace Mirage::Math {
+
+class AABB
+{
+  Point3 m_min;
+  Point3 m_max;
+
+public:
+  AABB() = default;
+  AABB( const Point3& min, const Point3& max ) : m_min( min ), m_max( max ) {}
+
+  // An inverted box that any point or box expands into
+  static AABB empty()
+  {
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    return AABB{
+      Point3{  inf,  inf,  inf },
+      Point3{ -inf, -inf, -inf }
+    };
+  }
+
+  [[nodiscard]] inline const Point3& min() const { return m_min; }
+  [[nodiscard]] inline const Point3& max() const { return m_max; }
+
+  [[nodiscard]] inline Point3 center() const { return ( m_min + m_max ) * 0.5F; }
+  [[nodiscard]] inline Vec3   extents() const { return ( m_max - m_min ) * 0.5F; }
+
+  [[nodiscard]] inline bool isEmpty() const
+  {
+    return m_min.x() > m_max.x() || m_min.y() > m_max.y() || m_min.z() > m_max.z();
+  }
+
+  [[nodiscard]] inline float surfaceArea() const
+  {
+    const Vec3 size = m_max - m_min;
+    return 2.0F * ( size.x() * size.y() + size.y() * size.z() + size.z() * size.x() );
+  }
+
+  [[nodiscard]] inline AABB expanded( float margin ) const
+  {
+    const Vec3 offset{ margin, margin, margin };
+    return AABB{ m_min - offset, m_max + offset };
+  }
+
+  inline void expandInPlace( const Point3& point )
+  {
+    m_min = Mirage::Math::min( m_min, point );
+    m_max = Mirage::Math::max( m_max, point );
+  }
+
+  inline void expandInPlace( const AABB& other )
+  {
+    m_min = Mirage::Math::min( m_min, other.m_min );
+    m_max = Mirage::Math::max( m_max, other.m_max );
+  }
+};
+
+inline AABB merge( const AABB& a, const AABB& b ) { return AABB{ min( a.min(), b.min() ), max( a.max(), b.max() ) }; }
+
+inline bool overlaps( const AABB& a, const AABB& b )
+{
+  return a.min().x() <= b.max().x() && a.max().x() >= b.min().x() && a.min().y() <= b.max().y()
+         && a.max().y() >= b.min().y() && a.min().z() <= b.max().z() && a.max().z() >= b.min().z();
+}
+
+inline std::optional<AABB> getIntersection( const AABB& a, const AABB& b )
+{
+  AABB result{ max( a.min(), b.min() ), min( a.max(), b.max() ) };
+  return result.isEmpty() ? std::nullopt : std::optional{ result };
+}
+
+// Squared gap between two boxes, zero when they overlap
+inline float distanceSquared( const AABB& a, const AABB& b )
+{
+  float result = 0.0F;
+  for ( size_t axis = 0; axis != 3; ++axis )
+  {
+    const float gap = std::max( { a.min()[axis] - b.max()[axis], b.min()[axis] - a.max()[axis], 0.0F } );
+    result += gap * gap;
+  }
+  return result;
+}
+
+inline bool contains( const AABB& box, const Point3& point )
+{
+  return point.x() >= box.min().x() && point.x() <= box.max().x() && point.y() >= box.min().y()
+         && point.y() <= box.max().y() && point.z() >= box.min().z() && point.z() <= box.max().z();
+}
+
+inline bool contains( const AABB& box, const AABB& other ) { return contains( box, other.min() ) && contains( box, other.max() ); }
+
+inline AABB makeBoundingBox( std::span<const Point3> points )
+{
+  AABB box = AABB::empty();
+  for ( const auto& point : points )
+  {
+    box.expandInPlace( point );
+  }
+  return box;
+}
+
+inline AABB makeBoundingBox( StridedSpan<const Point3> points )
+{
+  AABB box = AABB::empty();
+  for ( const Point3 point : points )
+  {
+    box.expandInPlace( point );
+  }
+  return box;
+}
+
+// Arvo's method in center/extents form: the center goes through the full transform and the
+// extents go through the component-wise absolute value of the upper 3x3.
+inline AABB operator*( const Transform4& t, const AABB& box )
+{
+  if ( box.isEmpty() )
+  {
+    return box;
+  }
+
+  const Point3 center  = t * box.center();
+  const Vec3   extents = box.extents();
+  const Vec3   world_extents{
+    std::fabs( t( 0, 0 ) ) * extents.x() + std::fabs( t( 0, 1 ) ) * extents.y() + std::fabs( t( 0, 2 ) ) * extents.z(),
+    std::fabs( t( 1, 0 ) ) * extents.x() + std::fabs( t( 1, 1 ) ) * extents.y() + std::fabs( t( 1, 2 ) ) * extents.z(),
+    std::fabs( t( 2, 0 ) ) * extents.x() + std::fabs( t( 2, 1 ) ) * extents.y() + std::fabs( t( 2, 2 ) ) * extents.z(),
+  };
+  return AABB{ center - world_extents, center + world_extents };
+}
+
+// Recomputes world bounds for a batch of objects: out[i] = world[i] * local[i].
+// The loop body is branch-free so the compiler can keep it in vector registers, which means
+// empty local boxes are not special-cased here and must be filtered by the caller.
+inline void transformBounds( std::span<const AABB> local, std::span<const Transform4> world, std::span<AABB> out )
+{
+  assert( local.size() == world.size() && out.size() >= local.size() );
+
+  for ( size_t i = 0; i != local.size(); ++i )
+  {
+    const Transform4& t   = world[i];
+    const Point3&     min = local[i].min();
+    const Point3&     max = local[i].max();
+
+    const float cx = ( min.x() + max.x() ) * 0.5F;
+    const float cy = ( min.y() + max.y() ) * 0.5F;
+    const float cz = ( min.z() + max.z() ) * 0.5F;
+    const float ex = ( max.x() - min.x() ) * 0.5F;
+    const float ey = ( max.y() - min.y() ) * 0.5F;
+    const float ez = ( max.z() - min.z() ) * 0.5F;
+
+    const Vec3& c0 = t[0];
+    const Vec3& c1 = t[1];
+    const Vec3& c2 = t[2];
+    const Vec3& c3 = t[3];
+
+    const float wcx = c0.x() * cx + c1.x() * cy + c2.x() * cz + c3.x();
+    const float wcy = c0.y() * cx + c1.y() * cy + c2.y() * cz + c3.y();
+    const float wcz = c0.z() * cx + c1.z() * cy + c2.z() * cz + c3.z();
+    const float wex = std::fabs( c0.x() ) * ex + std::fabs( c1.x() ) * ey + std::fabs( c2.x() ) * ez;
+    const float wey = std::fabs( c0.y() ) * ex + std::fabs( c1.y() ) * ey + std::fabs( c2.y() ) * ez;
+    const float wez = std::fabs( c0.z() ) * ex + std::fabs( c1.z() ) * ey + std::fabs( c2.z() ) * ez;
+
+    out[i] = AABB{
+      Point3{ wcx - wex, wcy - wey, wcz - wez },
+      Point3{ wcx + wex, wcy + wey, wcz + wez }
+    };
+  }
+}
+
+} // namespace Mirage::Math
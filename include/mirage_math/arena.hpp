@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Bump allocator for short-lived scratch arrays. Allocation moves a cursor through a list of blocks
+// and never frees anything on its own; memory is handed back all at once with reset(), or down to
+// an earlier mark() with rewind() or an ArenaScope. Blocks are kept, so a frame loop that resets
+// its arena stops allocating from the system after the first frames. Only trivially destructible
+// types can be placed in an arena, since nothing runs their destructors.
+class Arena
+{
+  struct BlockDeleter
+  {
+    inline void operator()( std::byte* data ) const
+    {
+      ::operator delete[]( data, std::align_val_t{ BLOCK_ALIGNMENT } );
+    }
+  };
+
+  struct Block
+  {
+    std::unique_ptr<std::byte[], BlockDeleter> data;
+    size_t                                     size;
+  };
+
+  std::vector<Block> m_blocks;
+  size_t             m_blockSize;
+  size_t             m_block{};
+  size_t             m_offset{};
+
+  // Offset of the first suitably aligned address at or after offset in a block
+  [[nodiscard]] inline size_t alignedOffset( size_t block, size_t offset, size_t alignment ) const
+  {
+    const auto base = reinterpret_cast<uintptr_t>( m_blocks[block].data.get() );
+    return ( ( base + offset + alignment - 1 ) & ~( alignment - 1 ) ) - base;
+  }
+
+  [[nodiscard]] inline bool fits( size_t block, size_t offset, size_t bytes, size_t alignment ) const
+  {
+    const size_t start = alignedOffset( block, offset, alignment );
+    return start <= m_blocks[block].size && bytes <= m_blocks[block].size - start;
+  }
+
+public:
+  // Blocks start on cache lines, so allocations of up to this alignment need no padding at the start
+  static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+  // Marker for rewind(): the cursor position at the time of mark()
+  struct Marker
+  {
+    size_t block;
+    size_t offset;
+  };
+
+  explicit Arena( size_t block_size = size_t{ 1 } << 16 ) : m_blockSize( block_size ) {}
+
+  Arena( const Arena& )            = delete;
+  Arena& operator=( const Arena& ) = delete;
+  Arena( Arena&& )                 = default;
+  Arena& operator=( Arena&& )      = default;
+
+  [[nodiscard]] void* allocate( size_t bytes, size_t alignment = alignof( std::max_align_t ) )
+  {
+    assert( std::has_single_bit( alignment ) );
+
+    if ( m_blocks.empty() || !fits( m_block, m_offset, bytes, alignment ) )
+    {
+      // Move on to the next block kept from before a rewind, inserting a new one if it is too small
+      const size_t next = m_blocks.empty() ? 0 : m_block + 1;
+      if ( next == m_blocks.size() || !fits( next, 0, bytes, alignment ) )
+      {
+        const size_t size = std::max( m_blockSize, bytes + alignment );
+        auto*        data = static_cast<std::byte*>( ::operator new[]( size, std::align_val_t{ BLOCK_ALIGNMENT } ) );
+        m_blocks.insert( m_blocks.begin() + static_cast<ptrdiff_t>( next ),
+          Block{ std::unique_ptr<std::byte[], BlockDeleter>( data ), size } );
+      }
+      m_block  = next;
+      m_offset = 0;
+    }
+
+    const size_t start = alignedOffset( m_block, m_offset, alignment );
+    m_offset           = start + bytes;
+    return m_blocks[m_block].data.get() + start;
+  }
+
+  // count default-constructed elements
+  template<typename T>
+  [[nodiscard]] std::span<T> allocate( size_t count )
+  {
+    static_assert( std::is_trivially_destructible_v<T>, "arena memory is released without running destructors" );
+    auto* data = static_cast<T*>( allocate( count * sizeof( T ), alignof( T ) ) );
+    std::uninitialized_default_construct_n( data, count );
+    return std::span<T>{ data, count };
+  }
+
+  [[nodiscard]] inline Marker mark() const { return Marker{ m_block, m_offset }; }
+
+  // Releases everything allocated since marker was taken
+  inline void rewind( const Marker& marker )
+  {
+    assert( marker.block < m_block || ( marker.block == m_block && marker.offset <= m_offset ) );
+    m_block  = marker.block;
+    m_offset = marker.offset;
+  }
+
+  // Releases everything, keeping the blocks for reuse
+  inline void reset() { rewind( Marker{ 0, 0 } ); }
+
+  // Frees the blocks as well
+  inline void release()
+  {
+    m_blocks.clear();
+    reset();
+  }
+
+  [[nodiscard]] inline size_t capacity() const
+  {
+    size_t total = 0;
+    for ( const auto& block : m_blocks )
+    {
+      total += block.size;
+    }
+    return total;
+  }
+};
+
+// Rewinds an arena to where it was when the scope was entered
+class ArenaScope
+{
+  Arena&        m_arena;
+  Arena::Marker m_marker;
+
+public:
+  explicit ArenaScope( Arena& arena ) : m_arena( arena ), m_marker( arena.mark() ) {}
+  ~ArenaScope() { m_arena.rewind( m_marker ); }
+
+  ArenaScope( const ArenaScope& )            = delete;
+  ArenaScope& operator=( const ArenaScope& ) = delete;
+};
+
+// Standard allocator drawing from an arena, for containers of scratch data. Deallocation is a
+// no-op: the memory comes back when the arena is rewound or reset, which must not happen while a
+// container still uses it.
+template<typename T>
+class ArenaAllocator
+{
+  Arena* m_arena;
+
+  template<typename U>
+  friend class ArenaAllocator;
+
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator( Arena& arena ) : m_arena( &arena ) {}
+
+  template<typename U>
+  ArenaAllocator( const ArenaAllocator<U>& other ) : m_arena( other.m_arena )
+  {}
+
+  [[nodiscard]] inline T* allocate( size_t count )
+  {
+    return static_cast<T*>( m_arena->allocate( count * sizeof( T ), alignof( T ) ) );
+  }
+
+  inline void deallocate( T* /*data*/, size_t /*count*/ ) {}
+
+  [[nodiscard]] inline Arena& arena() const { return *m_arena; }
+
+  template<typename U>
+  [[nodiscard]] friend inline bool operator==( const ArenaAllocator& a, const ArenaAllocator<U>& b )
+  {
+    return a.m_arena == &b.arena();
+  }
+};
+
+// Fixed-size slots for objects of one type, such as tree nodes, recycled through a free list.
+// Slots are carved out of blocks of blockSize objects that stay allocated until the pool goes away,
+// so addresses are stable. Objects must be destroyed through the pool before it is destroyed.
+template<typename T>
+class Pool
+{
+  union Slot
+  {
+    Slot* next;
+    alignas( T ) std::byte storage[sizeof( T )];
+  };
+
+  std::vector<std::unique_ptr<Slot[]>> m_blocks;
+  Slot*                                m_free{};
+  size_t                               m_blockSize;
+  size_t                               m_size{};
+
+public:
+  explicit Pool( size_t block_size = 256 ) : m_blockSize( block_size ) { assert( block_size != 0 ); }
+
+  Pool( const Pool& )            = delete;
+  Pool& operator=( const Pool& ) = delete;
+
+  ~Pool() { assert( m_size == 0 || std::is_trivially_destructible_v<T> ); }
+
+  template<typename... Args>
+  [[nodiscard]] T* create( Args&&... args )
+  {
+    if ( m_free == nullptr )
+    {
+      auto& block = m_blocks.emplace_back( std::make_unique_for_overwrite<Slot[]>( m_blockSize ) );
+      for ( size_t i = m_blockSize; i != 0; --i )
+      {
+        block[i - 1].next = m_free;
+        m_free            = &block[i - 1];
+      }
+    }
+
+    Slot* slot = m_free;
+    m_free     = slot->next;
+    ++m_size;
+    return std::construct_at( reinterpret_cast<T*>( slot->storage ), std::forward<Args>( args )... );
+  }
+
+  void destroy( T* object )
+  {
+    assert( object != nullptr && m_size != 0 );
+    std::destroy_at( object );
+    auto* slot = reinterpret_cast<Slot*>( object );
+    slot->next = m_free;
+    m_free     = slot;
+    --m_size;
+  }
+
+  // Live objects
+  [[nodiscard]] inline size_t size() const { return m_size; }
+  [[nodiscard]] inline size_t capacity() const { return m_blocks.size() * m_blockSize; }
+};
+
+} // namespace Mirage::Math
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Mirage::Math {
+
+// Structure-of-arrays view over three float streams, used by the batched queries so that
+// every lane of a loop reads contiguous memory.
+template<typename T>
+struct SoA3
+{
+  std::span<T> x;
+  std::span<T> y;
+  std::span<T> z;
+
+  [[nodiscard]] inline size_t size() const
+  {
+    assert( x.size() == y.size() && y.size() == z.size() );
+    return x.size();
+  }
+};
+
+using SoAVec3        = SoA3<const float>;
+using MutableSoAVec3 = SoA3<float>;
+
+// Branch-free stand-in for `valid ? divisor : 1.0F` where invalid divisors are (near) zero. GCC does
+// not if-convert a float select under the default -ftrapping-math, and one such select in a batched
+// loop body keeps the whole loop scalar.
+inline float safeDivisor( float divisor, bool valid )
+{
+  return divisor + static_cast<float>( 1U - static_cast<uint32_t>( valid ) );
+}
+
+// Batched predicates report their results as a bitmask, one bit per element, 64 elements per word
+constexpr size_t MASK_WORD_BITS = 64;
+
+constexpr size_t maskWordCount( size_t count ) { return ( count + MASK_WORD_BITS - 1 ) / MASK_WORD_BITS; }
+
+inline bool isMaskSet( std::span<const uint64_t> mask, size_t i )
+{
+  assert( i / MASK_WORD_BITS < mask.size() );
+  return ( ( mask[i / MASK_WORD_BITS] >> ( i % MASK_WORD_BITS ) ) & 1U ) != 0;
+}
+
+inline size_t countMask( std::span<const uint64_t> mask )
+{
+  size_t count = 0;
+  for ( auto word : mask )
+  {
+    count += static_cast<size_t>( std::popcount( word ) );
+  }
+  return count;
+}
+
+// Evaluates predicate( i ) for every element and packs the results into mask.
+// Returns the number of set bits.
+template<typename Predicate>
+inline size_t fillMask( size_t count, std::span<uint64_t> mask, Predicate&& predicate )
+{
+  assert( mask.size() >= maskWordCount( count ) );
+
+  size_t hits = 0;
+  for ( size_t word = 0; word != maskWordCount( count ); ++word )
+  {
+    const size_t begin      = word * MASK_WORD_BITS;
+    const size_t lane_count = std::min( count - begin, MASK_WORD_BITS );
+
+    // Evaluate into 32-bit lanes first so the predicate loop vectorizes at float width, then pack
+    std::array<uint32_t, MASK_WORD_BITS> lanes{};
+    for ( size_t lane = 0; lane != lane_count; ++lane )
+    {
+      lanes[lane] = predicate( begin + lane ) ? 1U : 0U;
+    }
+
+    uint64_t bits = 0;
+    for ( size_t bit = 0; bit != MASK_WORD_BITS; ++bit )
+    {
+      bits |= static_cast<uint64_t>( lanes[bit] ) << bit;
+    }
+    mask[word] = bits;
+    hits += static_cast<size_t>( std::popcount( bits ) );
+  }
+  return hits;
+}
+
+} // namespace Mirage::Math
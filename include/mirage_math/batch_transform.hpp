@@ -0,0 +1,329 @@
+#pragma once
+
+#include "job_system.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+#include "strided_span.hpp"
+#include "transform.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <span>
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace Mirage::Math {
+
+// Bulk versions of the single-element transform operators. Outputs may be the inputs themselves for
+// in-place transforms, but must not otherwise overlap them.
+
+enum class Execution
+{
+  // One element at a time with the single-element operator
+  SEQ,
+  // SIMD, four elements at a time where SSE2 is available
+  UNSEQ,
+  // UNSEQ on the workers of a job system
+  PAR
+};
+
+struct BatchTransformOptions
+{
+  Execution execution = Execution::UNSEQ;
+  // Elements below which PAR runs on the calling thread, where jobs cost more than they save
+  size_t parallelThreshold = size_t{ 1 } << 16;
+  // Elements per job for PAR
+  size_t grainSize = size_t{ 1 } << 13;
+  // nullptr for defaultJobSystem()
+  JobSystem* jobSystem{};
+};
+
+// 3x4 matrix applied by the packed kernels, row-major: out_r = rows[4r] x + rows[4r + 1] y + rows[4r + 2] z,
+// plus rows[4r + 3] for points
+using TransformRows = std::array<float, 12>;
+
+// The rows of transform, or the transposed upper 3x3 of it as applied by `Vec3 * Transform4`
+inline TransformRows makeTransformRows( const Transform4& transform, bool transpose )
+{
+  TransformRows rows{};
+  for ( size_t row = 0; row != 3; ++row )
+  {
+    for ( size_t col = 0; col != 3; ++col )
+    {
+      rows[row * 4 + col] = transpose ? transform( col, row ) : transform( row, col );
+    }
+    rows[row * 4 + 3] = transpose ? 0.0F : transform( row, 3 );
+  }
+  return rows;
+}
+
+// count packed x, y, z triples. The SSE2 path transposes four of them into x, y and z registers and
+// back, and sums in the same order as the single-element operators, so the results match them.
+template<bool TRANSLATE>
+inline void transformPackedVec3( const TransformRows& rows, const float* in, float* out, size_t count )
+{
+  size_t i = 0;
+#ifdef __SSE2__
+  __m128 m[12];
+  for ( size_t k = 0; k != rows.size(); ++k )
+  {
+    m[k] = _mm_set1_ps( rows[k] );
+  }
+  const auto row = [&m]( size_t r, __m128 x, __m128 y, __m128 z ) {
+    const __m128 sum = _mm_add_ps(
+      _mm_add_ps( _mm_mul_ps( m[r * 4], x ), _mm_mul_ps( m[r * 4 + 1], y ) ), _mm_mul_ps( m[r * 4 + 2], z ) );
+    return TRANSLATE ? _mm_add_ps( sum, m[r * 4 + 3] ) : sum;
+  };
+
+  for ( ; i + 4 <= count; i += 4, in += 12, out += 12 )
+  {
+    // x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+    const __m128 a = _mm_loadu_ps( in );
+    const __m128 b = _mm_loadu_ps( in + 4 );
+    const __m128 c = _mm_loadu_ps( in + 8 );
+
+    const __m128 x = _mm_shuffle_ps( a, _mm_shuffle_ps( b, c, _MM_SHUFFLE( 0, 1, 0, 2 ) ), _MM_SHUFFLE( 2, 0, 3, 0 ) );
+    const __m128 y = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 0, 1 ) ),
+      _mm_shuffle_ps( b, c, _MM_SHUFFLE( 0, 2, 0, 3 ) ),
+      _MM_SHUFFLE( 2, 0, 2, 0 ) );
+    const __m128 z = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 1, 0, 2 ) ), c, _MM_SHUFFLE( 3, 0, 2, 0 ) );
+
+    const __m128 rx = row( 0, x, y, z );
+    const __m128 ry = row( 1, x, y, z );
+    const __m128 rz = row( 2, x, y, z );
+
+    const __m128 xy01 = _mm_unpacklo_ps( rx, ry );
+    const __m128 xy23 = _mm_unpackhi_ps( rx, ry );
+    _mm_storeu_ps(
+      out, _mm_shuffle_ps( xy01, _mm_shuffle_ps( rz, rx, _MM_SHUFFLE( 1, 1, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 1, 0 ) ) );
+    _mm_storeu_ps( out + 4,
+      _mm_shuffle_ps( _mm_shuffle_ps( xy01, rz, _MM_SHUFFLE( 1, 1, 3, 3 ) ), xy23, _MM_SHUFFLE( 1, 0, 2, 0 ) ) );
+    _mm_storeu_ps( out + 8,
+      _mm_shuffle_ps( _mm_shuffle_ps( rz, xy23, _MM_SHUFFLE( 2, 2, 2, 2 ) ),
+        _mm_shuffle_ps( xy23, rz, _MM_SHUFFLE( 3, 3, 3, 3 ) ),
+        _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+  }
+#endif
+  for ( ; i != count; ++i, in += 3, out += 3 )
+  {
+    const float x = in[0];
+    const float y = in[1];
+    const float z = in[2];
+    for ( size_t r = 0; r != 3; ++r )
+    {
+      const float sum = rows[r * 4] * x + rows[r * 4 + 1] * y + rows[r * 4 + 2] * z;
+      out[r]          = TRANSLATE ? sum + rows[r * 4 + 3] : sum;
+    }
+  }
+}
+
+// count packed planes, as `Plane * Transform4`
+inline void transformPackedPlanes( const Transform4& transform, const float* in, float* out, size_t count )
+{
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128 row0 = _mm_setr_ps( transform( 0, 0 ), transform( 0, 1 ), transform( 0, 2 ), transform( 0, 3 ) );
+  const __m128 row1 = _mm_setr_ps( transform( 1, 0 ), transform( 1, 1 ), transform( 1, 2 ), transform( 1, 3 ) );
+  const __m128 row2 = _mm_setr_ps( transform( 2, 0 ), transform( 2, 1 ), transform( 2, 2 ), transform( 2, 3 ) );
+  // Keeps w and turns x, y and z into -0, which leaves any sum it is added to unchanged
+  const __m128 w_mask = _mm_castsi128_ps( _mm_setr_epi32( 0, 0, 0, -1 ) );
+  const __m128 zeros  = _mm_setr_ps( -0.0F, -0.0F, -0.0F, 0.0F );
+
+  for ( ; i != count; ++i, in += 4, out += 4 )
+  {
+    const __m128 plane = _mm_loadu_ps( in );
+    const __m128 sum   = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_shuffle_ps( plane, plane, 0x00 ), row0 ),
+                                     _mm_mul_ps( _mm_shuffle_ps( plane, plane, 0x55 ), row1 ) ),
+      _mm_mul_ps( _mm_shuffle_ps( plane, plane, 0xAA ), row2 ) );
+    _mm_storeu_ps( out, _mm_add_ps( sum, _mm_or_ps( _mm_and_ps( plane, w_mask ), zeros ) ) );
+  }
+#endif
+  for ( ; i != count; ++i, in += 4, out += 4 )
+  {
+    const float x = in[0];
+    const float y = in[1];
+    const float z = in[2];
+    const float w = in[3];
+    for ( size_t col = 0; col != 3; ++col )
+    {
+      out[col] = x * transform( 0, col ) + y * transform( 1, col ) + z * transform( 2, col );
+    }
+    out[3] = x * transform( 0, 3 ) + y * transform( 1, 3 ) + z * transform( 2, 3 ) + w;
+  }
+}
+
+// Calls function( first, last ) over chunks of [0, count): one chunk unless options ask for PAR above
+// the threshold, then jobs of about grainSize elements. Chunks start on multiples of four so the SIMD
+// loops stay full.
+template<typename Function>
+inline void forEachTransformChunk( size_t count, const BatchTransformOptions& options, Function&& function )
+{
+  if ( options.execution != Execution::PAR || count < options.parallelThreshold )
+  {
+    function( size_t{ 0 }, count );
+    return;
+  }
+
+  JobSystem& jobs = options.jobSystem != nullptr ? *options.jobSystem : defaultJobSystem();
+  jobs.parallelFor( 0, ( count + 3 ) / 4, options.grainSize / 4, [&function, count]( size_t first, size_t last ) {
+    function( first * 4, std::min( last * 4, count ) );
+  } );
+}
+
+// Runs element( value ) per element for SEQ, and packed( in, out, count ) over the floats of each
+// chunk otherwise
+template<typename T, typename Element, typename Packed>
+inline void transformBatch(
+  std::span<const T> in, std::span<T> out, const BatchTransformOptions& options, Element&& element, Packed&& packed )
+{
+  assert( out.size() >= in.size() );
+  if ( options.execution == Execution::SEQ )
+  {
+    std::ranges::transform( in, out.begin(), element );
+    return;
+  }
+
+  constexpr size_t FLOATS = sizeof( T ) / sizeof( float );
+  const auto*      src    = reinterpret_cast<const float*>( in.data() );
+  auto*            dst    = reinterpret_cast<float*>( out.data() );
+  forEachTransformChunk( in.size(), options, [&]( size_t first, size_t last ) {
+    packed( src + first * FLOATS, dst + first * FLOATS, last - first );
+  } );
+}
+
+// Strided elements are copied through a buffer on the stack for the packed kernel, unless both views
+// are contiguous
+template<typename T, typename Element, typename Packed>
+inline void transformBatch( StridedSpan<const T> in,
+  StridedSpan<T>                                 out,
+  const BatchTransformOptions&                   options,
+  Element&&                                      element,
+  Packed&&                                       packed )
+{
+  assert( out.size() >= in.size() );
+  if ( options.execution == Execution::SEQ )
+  {
+    for ( size_t i = 0; i != in.size(); ++i )
+    {
+      out[i] = element( in[i] );
+    }
+    return;
+  }
+
+  constexpr size_t FLOATS = sizeof( T ) / sizeof( float );
+  if ( in.isContiguous() && out.isContiguous() )
+  {
+    forEachTransformChunk( in.size(), options, [&]( size_t first, size_t last ) {
+      packed( in.data() + first * FLOATS, out.data() + first * FLOATS, last - first );
+    } );
+    return;
+  }
+
+  forEachTransformChunk( in.size(), options, [&]( size_t first, size_t last ) {
+    std::array<T, 256> buffer;
+    auto*              floats = reinterpret_cast<float*>( buffer.data() );
+    for ( size_t start = first; start < last; start += buffer.size() )
+    {
+      const size_t count = std::min( buffer.size(), last - start );
+      std::copy_n( in.begin() + static_cast<ptrdiff_t>( start ), count, buffer.begin() );
+      packed( floats, floats, count );
+      std::copy_n( buffer.begin(), count, out.begin() + static_cast<ptrdiff_t>( start ) );
+    }
+  } );
+}
+
+// Packed kernel for the Vec3 batches, with the rows of transform captured by value
+template<bool TRANSLATE>
+inline auto makePackedVec3Kernel( const Transform4& transform, bool transpose )
+{
+  return [rows = makeTransformRows( transform, transpose )]( const float* in, float* out, size_t count ) {
+    transformPackedVec3<TRANSLATE>( rows, in, out, count );
+  };
+}
+
+// out[i] = transform * points[i]
+inline void transformPoints( const Transform4& transform,
+  std::span<const Point3>                      points,
+  std::span<Point3>                            out,
+  const BatchTransformOptions&                 options = {} )
+{
+  const auto element = [&transform]( const Point3& point ) { return transform * point; };
+  transformBatch( points, out, options, element, makePackedVec3Kernel<true>( transform, false ) );
+}
+
+inline void transformPoints( const Transform4& transform,
+  StridedSpan<const Point3>                    points,
+  StridedSpan<Point3>                          out,
+  const BatchTransformOptions&                 options = {} )
+{
+  const auto element = [&transform]( const Point3& point ) { return transform * point; };
+  transformBatch( points, out, options, element, makePackedVec3Kernel<true>( transform, false ) );
+}
+
+// out[i] = transform * vectors[i], ignoring the translation
+inline void transformVectors( const Transform4& transform,
+  std::span<const Vec3>                         vectors,
+  std::span<Vec3>                               out,
+  const BatchTransformOptions&                  options = {} )
+{
+  const auto element = [&transform]( const Vec3& vec ) { return transform * vec; };
+  transformBatch( vectors, out, options, element, makePackedVec3Kernel<false>( transform, false ) );
+}
+
+inline void transformVectors( const Transform4& transform,
+  StridedSpan<const Vec3>                       vectors,
+  StridedSpan<Vec3>                             out,
+  const BatchTransformOptions&                  options = {} )
+{
+  const auto element = [&transform]( const Vec3& vec ) { return transform * vec; };
+  transformBatch( vectors, out, options, element, makePackedVec3Kernel<false>( transform, false ) );
+}
+
+// out[i] = normals[i] * transform. As with the operator, transform is the inverse of the transform
+// applied to the points; the results are not normalized.
+inline void transformNormals( const Transform4& transform,
+  std::span<const Vec3>                         normals,
+  std::span<Vec3>                               out,
+  const BatchTransformOptions&                  options = {} )
+{
+  const auto element = [&transform]( const Vec3& normal ) { return normal * transform; };
+  transformBatch( normals, out, options, element, makePackedVec3Kernel<false>( transform, true ) );
+}
+
+inline void transformNormals( const Transform4& transform,
+  StridedSpan<const Vec3>                       normals,
+  StridedSpan<Vec3>                             out,
+  const BatchTransformOptions&                  options = {} )
+{
+  const auto element = [&transform]( const Vec3& normal ) { return normal * transform; };
+  transformBatch( normals, out, options, element, makePackedVec3Kernel<false>( transform, true ) );
+}
+
+// out[i] = planes[i] * transform, where transform is again the inverse of the point transform
+inline void transformPlanes( const Transform4& transform,
+  std::span<const Plane>                       planes,
+  std::span<Plane>                             out,
+  const BatchTransformOptions&                 options = {} )
+{
+  const auto element = [&transform]( const Plane& plane ) { return plane * transform; };
+  const auto packed  = [&transform]( const float* in, float* result, size_t count ) {
+    transformPackedPlanes( transform, in, result, count );
+  };
+  transformBatch( planes, out, options, element, packed );
+}
+
+inline void transformPlanes( const Transform4& transform,
+  StridedSpan<const Plane>                     planes,
+  StridedSpan<Plane>                           out,
+  const BatchTransformOptions&                 options = {} )
+{
+  const auto element = [&transform]( const Plane& plane ) { return plane * transform; };
+  const auto packed  = [&transform]( const float* in, float* result, size_t count ) {
+    transformPackedPlanes( transform, in, result, count );
+  };
+  transformBatch( planes, out, options, element, packed );
+}
+
+} // namespace Mirage::Math
@@ -0,0 +1,314 @@
+#pragma once
+
+#include "plane.hpp"
+#include "point.hpp"
+#include "transform.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Binary container for arrays of library types. A file is a BinaryFileHeader, a table of
+// BinarySectionHeader records and the sections, each starting on a BINARY_SECTION_ALIGNMENT
+// boundary and holding the elements exactly as they are laid out in memory. Files are written in
+// the writer's byte order and tagged with it; readers on the other byte order reject them rather
+// than converting, since the point of the format is to use the mapped data in place.
+
+constexpr std::array<char, 8> BINARY_FILE_MAGIC{ 'M', 'I', 'R', 'A', 'G', 'E', 'M', 'B' };
+constexpr uint32_t            BINARY_FILE_VERSION      = 1;
+constexpr uint32_t            BINARY_FILE_ENDIAN_TAG   = 0x01020304U;
+constexpr size_t              BINARY_SECTION_ALIGNMENT = 64;
+constexpr size_t              BINARY_SECTION_NAME_SIZE = 32;
+
+enum class BinarySectionType : uint32_t
+{
+  POINT3     = 1,
+  TRANSFORM4 = 2,
+  PLANE      = 3
+};
+
+template<typename T>
+concept BinarySectionElement = std::is_same_v<T, Point3> || std::is_same_v<T, Transform4> || std::is_same_v<T, Plane>;
+
+template<BinarySectionElement T>
+constexpr BinarySectionType binarySectionType()
+{
+  if constexpr ( std::is_same_v<T, Point3> )
+  {
+    return BinarySectionType::POINT3;
+  } else if constexpr ( std::is_same_v<T, Transform4> )
+  {
+    return BinarySectionType::TRANSFORM4;
+  } else
+  {
+    return BinarySectionType::PLANE;
+  }
+}
+
+struct BinaryFileHeader
+{
+  std::array<char, 8> magic;
+  uint32_t            version;
+  uint32_t            endianTag;
+  uint64_t            fileSize;
+  uint32_t            sectionCount;
+  uint32_t            reserved;
+};
+
+struct BinarySectionHeader
+{
+  // Zero-padded, so at most BINARY_SECTION_NAME_SIZE - 1 characters
+  std::array<char, BINARY_SECTION_NAME_SIZE> name;
+  BinarySectionType                          type;
+  uint32_t                                   elementSize;
+  uint64_t                                   offset;
+  uint64_t                                   count;
+  uint64_t                                   reserved;
+
+  [[nodiscard]] inline std::string_view getName() const { return std::string_view{ name.data() }; }
+};
+
+static_assert( sizeof( BinaryFileHeader ) == 32 && sizeof( BinarySectionHeader ) == 64 );
+static_assert( std::is_trivially_copyable_v<BinaryFileHeader> && std::is_trivially_copyable_v<BinarySectionHeader> );
+
+inline size_t binaryElementSize( BinarySectionType type )
+{
+  switch ( type )
+  {
+  case BinarySectionType::POINT3:
+    return sizeof( Point3 );
+  case BinarySectionType::TRANSFORM4:
+    return sizeof( Transform4 );
+  case BinarySectionType::PLANE:
+    return sizeof( Plane );
+  }
+  return 0;
+}
+
+// Checks the header and every section against the size of bytes, which must start on a
+// BINARY_SECTION_ALIGNMENT boundary. Returns the section table, or std::nullopt if the data is not
+// a valid file for this build.
+inline std::optional<std::vector<BinarySectionHeader>> parseBinaryFile( std::span<const std::byte> bytes )
+{
+  BinaryFileHeader header{};
+  if ( bytes.size() < sizeof( header ) )
+  {
+    return std::nullopt;
+  }
+  std::memcpy( &header, bytes.data(), sizeof( header ) );
+  if ( header.magic != BINARY_FILE_MAGIC || header.version != BINARY_FILE_VERSION
+       || header.endianTag != BINARY_FILE_ENDIAN_TAG || header.fileSize != bytes.size() )
+  {
+    return std::nullopt;
+  }
+
+  const size_t table_end = sizeof( header ) + size_t{ header.sectionCount } * sizeof( BinarySectionHeader );
+  if ( header.sectionCount > ( bytes.size() - sizeof( header ) ) / sizeof( BinarySectionHeader ) )
+  {
+    return std::nullopt;
+  }
+
+  std::vector<BinarySectionHeader> sections( header.sectionCount );
+  std::memcpy( sections.data(), bytes.data() + sizeof( header ), sections.size() * sizeof( BinarySectionHeader ) );
+  for ( const auto& section : sections )
+  {
+    const size_t element_size = binaryElementSize( section.type );
+    if ( element_size == 0 || section.elementSize != element_size || section.name.back() != '\0'
+         || section.offset % BINARY_SECTION_ALIGNMENT != 0 || section.offset < table_end
+         || section.offset > bytes.size() || section.count > ( bytes.size() - section.offset ) / element_size )
+    {
+      return std::nullopt;
+    }
+  }
+  return sections;
+}
+
+// Collects sections and writes them out in one go. Sections refer to the caller's data, which must
+// stay alive until write() returns.
+class BinaryFileWriter
+{
+  struct Section
+  {
+    BinarySectionHeader        header;
+    std::span<const std::byte> bytes;
+  };
+
+  std::vector<Section> m_sections;
+
+public:
+  // Returns false if the name is too long or already taken
+  template<BinarySectionElement T>
+  bool add( std::string_view name, std::span<const T> elements )
+  {
+    if ( name.size() >= BINARY_SECTION_NAME_SIZE
+         || std::ranges::any_of( m_sections, [name]( const Section& s ) { return s.header.getName() == name; } ) )
+    {
+      return false;
+    }
+
+    BinarySectionHeader header{};
+    std::copy( name.begin(), name.end(), header.name.begin() );
+    header.type        = binarySectionType<T>();
+    header.elementSize = sizeof( T );
+    header.count       = elements.size();
+    m_sections.push_back( Section{ header, std::as_bytes( elements ) } );
+    return true;
+  }
+
+  [[nodiscard]] inline size_t sectionCount() const { return m_sections.size(); }
+
+  bool write( const std::filesystem::path& path )
+  {
+    const auto align = []( uint64_t offset ) {
+      return ( offset + BINARY_SECTION_ALIGNMENT - 1 ) / BINARY_SECTION_ALIGNMENT * BINARY_SECTION_ALIGNMENT;
+    };
+
+    const uint64_t table_end = sizeof( BinaryFileHeader ) + m_sections.size() * sizeof( BinarySectionHeader );
+    uint64_t       offset    = table_end;
+    for ( auto& section : m_sections )
+    {
+      section.header.offset = align( offset );
+      offset                = section.header.offset + section.bytes.size();
+    }
+
+    BinaryFileHeader header{};
+    header.magic        = BINARY_FILE_MAGIC;
+    header.version      = BINARY_FILE_VERSION;
+    header.endianTag    = BINARY_FILE_ENDIAN_TAG;
+    header.fileSize     = offset;
+    header.sectionCount = static_cast<uint32_t>( m_sections.size() );
+
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    for ( const auto& section : m_sections )
+    {
+      file.write( reinterpret_cast<const char*>( &section.header ), sizeof( section.header ) );
+    }
+
+    constexpr std::array<char, BINARY_SECTION_ALIGNMENT> padding{};
+    offset = table_end;
+    for ( const auto& section : m_sections )
+    {
+      file.write( padding.data(), static_cast<std::streamsize>( section.header.offset - offset ) );
+      file.write( reinterpret_cast<const char*>( section.bytes.data() ),
+        static_cast<std::streamsize>( section.bytes.size() ) );
+      offset = section.header.offset + section.bytes.size();
+    }
+    return static_cast<bool>( file.flush() );
+  }
+};
+
+// Read-only memory mapping of a file written by BinaryFileWriter. Opening validates the whole
+// layout; after that, sections are handed out as spans into the mapping without copying, and stay
+// valid for the lifetime of the object.
+class MappedBinaryFile
+{
+  const std::byte*                 m_data{};
+  size_t                           m_size{};
+  std::vector<BinarySectionHeader> m_sections;
+
+  MappedBinaryFile( const std::byte* data, size_t size, std::vector<BinarySectionHeader> sections )
+    : m_data( data ), m_size( size ), m_sections( std::move( sections ) )
+  {}
+
+  void unmap()
+  {
+    if ( m_data != nullptr )
+    {
+      munmap( const_cast<std::byte*>( m_data ), m_size );
+    }
+    m_data = nullptr;
+    m_size = 0;
+  }
+
+public:
+  MappedBinaryFile( const MappedBinaryFile& )            = delete;
+  MappedBinaryFile& operator=( const MappedBinaryFile& ) = delete;
+
+  MappedBinaryFile( MappedBinaryFile&& other ) noexcept
+    : m_data( std::exchange( other.m_data, nullptr ) ),
+      m_size( std::exchange( other.m_size, 0 ) ),
+      m_sections( std::move( other.m_sections ) )
+  {}
+
+  MappedBinaryFile& operator=( MappedBinaryFile&& other ) noexcept
+  {
+    if ( this != &other )
+    {
+      unmap();
+      m_data     = std::exchange( other.m_data, nullptr );
+      m_size     = std::exchange( other.m_size, 0 );
+      m_sections = std::move( other.m_sections );
+    }
+    return *this;
+  }
+
+  ~MappedBinaryFile() { unmap(); }
+
+  // std::nullopt if the file cannot be mapped or is not a valid file for this build
+  static std::optional<MappedBinaryFile> open( const std::filesystem::path& path )
+  {
+    const int descriptor = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( descriptor < 0 )
+    {
+      return std::nullopt;
+    }
+
+    struct stat status{};
+    void*       address = MAP_FAILED;
+    if ( fstat( descriptor, &status ) == 0 && status.st_size > 0 )
+    {
+      address = mmap( nullptr, static_cast<size_t>( status.st_size ), PROT_READ, MAP_PRIVATE, descriptor, 0 );
+    }
+    close( descriptor );
+    if ( address == MAP_FAILED )
+    {
+      return std::nullopt;
+    }
+
+    // Mappings are page aligned, which satisfies the section alignment
+    const auto* data     = static_cast<const std::byte*>( address );
+    const auto  size     = static_cast<size_t>( status.st_size );
+    auto        sections = parseBinaryFile( std::span{ data, size } );
+    if ( !sections )
+    {
+      munmap( address, size );
+      return std::nullopt;
+    }
+    return MappedBinaryFile{ data, size, std::move( *sections ) };
+  }
+
+  [[nodiscard]] inline std::span<const BinarySectionHeader> sections() const { return m_sections; }
+  [[nodiscard]] inline std::span<const std::byte>          bytes() const { return { m_data, m_size }; }
+
+  // The elements of the section with this name, or std::nullopt if there is none of type T
+  template<BinarySectionElement T>
+  [[nodiscard]] std::optional<std::span<const T>> get( std::string_view name ) const
+  {
+    for ( const auto& section : m_sections )
+    {
+      if ( section.getName() == name && section.type == binarySectionType<T>() )
+      {
+        return std::span{ reinterpret_cast<const T*>( m_data + section.offset ), section.count };
+      }
+    }
+    return std::nullopt;
+  }
+};
+
+} // namespace Mirage::Math
@@ -0,0 +1,388 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "job_system.hpp"
+#include "point.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Two nodes share a 64 byte cache line. Interior nodes store the index of their first child (the
+// second child follows it), leaves store the offset of their first primitive in the index array.
+struct BVHNode
+{
+  std::array<float, 3> boundsMin{};
+  uint32_t             leftFirst{};
+  std::array<float, 3> boundsMax{};
+  uint32_t             count{};
+
+  [[nodiscard]] inline bool isLeaf() const { return count != 0; }
+
+  [[nodiscard]] inline AABB bounds() const
+  {
+    return AABB{
+      Point3{ boundsMin[0], boundsMin[1], boundsMin[2] },
+      Point3{ boundsMax[0], boundsMax[1], boundsMax[2] }
+    };
+  }
+
+  inline void setBounds( const AABB& box )
+  {
+    boundsMin = { box.min().x(), box.min().y(), box.min().z() };
+    boundsMax = { box.max().x(), box.max().y(), box.max().z() };
+  }
+};
+
+static_assert( sizeof( BVHNode ) == 32 );
+
+struct BVHBuildOptions
+{
+  // At least 1
+  uint32_t maxLeafSize = 4;
+  // Subtrees with at least this many primitives are built as separate tasks
+  size_t parallelThreshold = size_t{ 1 } << 15;
+  // nullptr for defaultJobSystem()
+  JobSystem* jobSystem{};
+};
+
+class BVH
+{
+  std::vector<BVHNode>  m_nodes;
+  std::vector<uint32_t> m_primitiveIndices;
+
+  static constexpr uint32_t BIN_COUNT = 16;
+  static constexpr float    INF       = std::numeric_limits<float>::infinity();
+
+  // Plain float bounds keep the binning loop free of Vec temporaries
+  struct Bin
+  {
+    std::array<float, 3> boundsMin{ INF, INF, INF };
+    std::array<float, 3> boundsMax{ -INF, -INF, -INF };
+    uint32_t             count{};
+
+    inline void expand( const std::array<float, 3>& min, const std::array<float, 3>& max )
+    {
+      for ( size_t axis = 0; axis != 3; ++axis )
+      {
+        boundsMin[axis] = std::min( boundsMin[axis], min[axis] );
+        boundsMax[axis] = std::max( boundsMax[axis], max[axis] );
+      }
+    }
+
+    inline void expand( const Bin& other )
+    {
+      expand( other.boundsMin, other.boundsMax );
+      count += other.count;
+    }
+
+    [[nodiscard]] inline float cost() const
+    {
+      const float dx = boundsMax[0] - boundsMin[0];
+      const float dy = boundsMax[1] - boundsMin[1];
+      const float dz = boundsMax[2] - boundsMin[2];
+      return count == 0 ? 0.0F : 2.0F * ( dx * dy + dy * dz + dz * dx ) * static_cast<float>( count );
+    }
+  };
+
+  // Primitives are partitioned by value rather than through an index array, so every pass over a
+  // node reads one contiguous range.
+  struct BuildPrimitive
+  {
+    std::array<float, 3> boundsMin;
+    uint32_t             index;
+    std::array<float, 3> boundsMax;
+    uint32_t             padding;
+
+    [[nodiscard]] inline float centroid( size_t axis ) const { return ( boundsMin[axis] + boundsMax[axis] ) * 0.5F; }
+  };
+
+  struct BuildState
+  {
+    std::vector<BuildPrimitive> primitives;
+    std::span<BVHNode>          nodes;
+    std::atomic<uint32_t>       nodeCount;
+    const BVHBuildOptions&      options;
+    JobSystem&                  jobs;
+  };
+
+  struct Split
+  {
+    int   axis{ -1 };
+    float position{};
+    float cost{ INF };
+  };
+
+  static Split findSplit( std::span<const BuildPrimitive> primitives, const Bin& centroid_bounds )
+  {
+    // Small nodes do not need the full bin resolution and are by far the most numerous
+    const auto bin_count = std::min( BIN_COUNT, static_cast<uint32_t>( primitives.size() ) );
+
+    std::array<std::array<Bin, BIN_COUNT>, 3> bins{};
+    std::array<float, 3>                      scale{};
+    for ( size_t axis = 0; axis != 3; ++axis )
+    {
+      const float extent = centroid_bounds.boundsMax[axis] - centroid_bounds.boundsMin[axis];
+      scale[axis]        = extent > FLOAT_MIN ? static_cast<float>( bin_count ) / extent : 0.0F;
+    }
+
+    for ( const auto& primitive : primitives )
+    {
+      for ( size_t axis = 0; axis != 3; ++axis )
+      {
+        const auto bin = std::min(
+          static_cast<uint32_t>( ( primitive.centroid( axis ) - centroid_bounds.boundsMin[axis] ) * scale[axis] ),
+          bin_count - 1 );
+        bins[axis][bin].expand( primitive.boundsMin, primitive.boundsMax );
+        bins[axis][bin].count++;
+      }
+    }
+
+    Split best;
+    for ( size_t axis = 0; axis != 3; ++axis )
+    {
+      if ( scale[axis] == 0.0F )
+      {
+        continue;
+      }
+
+      // Sweep from the right to record the cost of every right-hand partition, then from the left
+      std::array<float, BIN_COUNT - 1> right_cost{};
+      Bin                              right;
+      for ( uint32_t bin = bin_count - 1; bin != 0; --bin )
+      {
+        right.expand( bins[axis][bin] );
+        right_cost[bin - 1] = right.cost();
+      }
+
+      Bin left;
+      for ( uint32_t bin = 0; bin != bin_count - 1; ++bin )
+      {
+        left.expand( bins[axis][bin] );
+        if ( left.count == 0 || left.count == primitives.size() )
+        {
+          continue;
+        }
+
+        const float cost = left.cost() + right_cost[bin];
+        if ( cost < best.cost )
+        {
+          best.axis     = static_cast<int>( axis );
+          best.position = centroid_bounds.boundsMin[axis] + static_cast<float>( bin + 1 ) / scale[axis];
+          best.cost     = cost;
+        }
+      }
+    }
+    return best;
+  }
+
+  static void buildNode( BuildState& state, uint32_t node_index, uint32_t first, uint32_t count, uint32_t depth )
+  {
+    const std::span<BuildPrimitive> primitives{ state.primitives.data() + first, count };
+
+    Bin node_bounds;
+    Bin centroid_bounds;
+    for ( const auto& primitive : primitives )
+    {
+      node_bounds.expand( primitive.boundsMin, primitive.boundsMax );
+      for ( size_t axis = 0; axis != 3; ++axis )
+      {
+        centroid_bounds.boundsMin[axis] = std::min( centroid_bounds.boundsMin[axis], primitive.centroid( axis ) );
+        centroid_bounds.boundsMax[axis] = std::max( centroid_bounds.boundsMax[axis], primitive.centroid( axis ) );
+      }
+    }
+
+    BVHNode& node  = state.nodes[node_index];
+    node.boundsMin = node_bounds.boundsMin;
+    node.boundsMax = node_bounds.boundsMax;
+    // A single primitive cannot be split, whatever maxLeafSize says
+    if ( count <= 1 || count <= state.options.maxLeafSize )
+    {
+      node.leftFirst = first;
+      node.count     = count;
+      return;
+    }
+
+    const Split split = findSplit( primitives, centroid_bounds );
+
+    uint32_t left_count = count / 2;
+    if ( split.axis >= 0 )
+    {
+      const auto axis = static_cast<size_t>( split.axis );
+      auto       mid  = std::partition( primitives.begin(), primitives.end(), [&split, axis]( const auto& primitive ) {
+        return primitive.centroid( axis ) < split.position;
+      } );
+      left_count      = static_cast<uint32_t>( mid - primitives.begin() );
+    }
+
+    // Coincident centroids or rounding at a bin boundary: fall back to an object median. So does a
+    // split too lopsided for median splits below it to end within MAX_DEPTH; median splits take
+    // bit_width( count - 1 ) more levels.
+    const uint32_t larger       = std::max( left_count, count - left_count );
+    const auto     median_depth = static_cast<uint32_t>( std::bit_width( larger - 1 ) );
+    if ( left_count == 0 || left_count == count || depth + 1 + median_depth > MAX_DEPTH )
+    {
+      left_count = count / 2;
+    }
+
+    const uint32_t left_child = state.nodeCount.fetch_add( 2 );
+    node.leftFirst            = left_child;
+    node.count                = 0;
+
+    if ( count >= state.options.parallelThreshold )
+    {
+      TaskGroup group( state.jobs );
+      group.run( [&state, left_child, first, left_count, depth]() {
+        buildNode( state, left_child, first, left_count, depth + 1 );
+      } );
+      buildNode( state, left_child + 1, first + left_count, count - left_count, depth + 1 );
+      group.wait();
+    } else
+    {
+      buildNode( state, left_child, first, left_count, depth + 1 );
+      buildNode( state, left_child + 1, first + left_count, count - left_count, depth + 1 );
+    }
+  }
+
+public:
+  // Deepest level of any node, the root being level 0. Traversals keep their stacks in fixed-size
+  // arrays of MAX_DEPTH + 1 entries.
+  static constexpr uint32_t MAX_DEPTH = 64;
+
+  BVH() = default;
+
+  // Adopts a hierarchy built elsewhere, e.g. by LinearBVHBuilder. Nodes must follow the layout build()
+  // produces: the root first, siblings adjacent and children stored after their parent, and no node
+  // below MAX_DEPTH.
+  BVH( std::vector<BVHNode> nodes, std::vector<uint32_t> primitive_indices )
+    : m_nodes( std::move( nodes ) ), m_primitiveIndices( std::move( primitive_indices ) )
+  {}
+
+  // Binned SAH build over the bounds of arbitrary primitives. Primitive ids in the leaves are
+  // indices into primitive_bounds.
+  static BVH build( std::span<const AABB> primitive_bounds, const BVHBuildOptions& options = {} )
+  {
+    assert( options.maxLeafSize >= 1 );
+
+    BVH bvh;
+    if ( primitive_bounds.empty() )
+    {
+      return bvh;
+    }
+
+    const auto count = static_cast<uint32_t>( primitive_bounds.size() );
+    bvh.m_nodes.resize( size_t{ count } * 2 - 1 );
+
+    BuildState state{ std::vector<BuildPrimitive>( count ),
+      bvh.m_nodes,
+      1U,
+      options,
+      options.jobSystem != nullptr ? *options.jobSystem : defaultJobSystem() };
+    for ( uint32_t i = 0; i != count; ++i )
+    {
+      const AABB& box     = primitive_bounds[i];
+      state.primitives[i] = BuildPrimitive{
+        { box.min().x(), box.min().y(), box.min().z() },
+        i, { box.max().x(), box.max().y(), box.max().z() },
+        0
+      };
+    }
+
+    buildNode( state, 0, 0, count, 0 );
+    bvh.m_nodes.resize( state.nodeCount.load() );
+
+    bvh.m_primitiveIndices.resize( count );
+    for ( uint32_t i = 0; i != count; ++i )
+    {
+      bvh.m_primitiveIndices[i] = state.primitives[i].index;
+    }
+    return bvh;
+  }
+
+  [[nodiscard]] inline std::span<const BVHNode>  nodes() const { return m_nodes; }
+  [[nodiscard]] inline std::span<const uint32_t> primitiveIndices() const { return m_primitiveIndices; }
+  [[nodiscard]] inline bool                      isEmpty() const { return m_nodes.empty(); }
+
+  // Updates node bounds after the primitives moved, keeping the topology. Children are always
+  // allocated after their parent, so a reverse sweep visits every child before its parent.
+  void refit( std::span<const AABB> primitive_bounds )
+  {
+    assert( primitive_bounds.size() == m_primitiveIndices.size() );
+    for ( size_t i = m_nodes.size(); i-- != 0; )
+    {
+      BVHNode& node = m_nodes[i];
+      if ( node.isLeaf() )
+      {
+        AABB bounds = AABB::empty();
+        for ( uint32_t j = node.leftFirst; j != node.leftFirst + node.count; ++j )
+        {
+          bounds.expandInPlace( primitive_bounds[m_primitiveIndices[j]] );
+        }
+        node.setBounds( bounds );
+      } else
+      {
+        node.setBounds( merge( m_nodes[node.leftFirst].bounds(), m_nodes[node.leftFirst + 1].bounds() ) );
+      }
+    }
+  }
+
+  // Calls callback( primitive ) for every primitive in a leaf whose bounds overlap box. Leaves are
+  // conservative, so callers that need exact results test the primitive itself.
+  template<typename Callback>
+  void queryOverlaps( const AABB& box, Callback&& callback ) const
+  {
+    if ( m_nodes.empty() )
+    {
+      return;
+    }
+
+    std::array<uint32_t, MAX_DEPTH + 1> stack{};
+    size_t                               stack_size = 1;
+    while ( stack_size != 0 )
+    {
+      const BVHNode& node = m_nodes[stack[--stack_size]];
+      if ( !overlaps( node.bounds(), box ) )
+      {
+        continue;
+      }
+
+      if ( node.isLeaf() )
+      {
+        for ( uint32_t i = node.leftFirst; i != node.leftFirst + node.count; ++i )
+        {
+          callback( m_primitiveIndices[i] );
+        }
+      } else
+      {
+        stack[stack_size++] = node.leftFirst;
+        stack[stack_size++] = node.leftFirst + 1;
+      }
+    }
+  }
+};
+
+// Bounds of every triangle in an indexed mesh, the usual input to BVH::build
+inline std::vector<AABB> makeTriangleBounds( std::span<const Point3> positions, std::span<const uint32_t> indices )
+{
+  assert( indices.size() % 3 == 0 );
+
+  std::vector<AABB> bounds( indices.size() / 3 );
+  for ( size_t i = 0; i != bounds.size(); ++i )
+  {
+    const Point3& a = positions[indices[i * 3]];
+    const Point3& b = positions[indices[i * 3 + 1]];
+    const Point3& c = positions[indices[i * 3 + 2]];
+    bounds[i]       = AABB{ min( min( a, b ), c ), max( max( a, b ), c ) };
+  }
+  return bounds;
+}
+
+} // namespace Mirage::Math
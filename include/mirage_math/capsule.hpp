@@ -0,0 +1,123 @@
+#pragma once
+
+#include "batch.hpp"
+#include "point.hpp"
+#include "segment.hpp"
+#include "sphere.hpp"
+#include <cassert>
+#include <cmath>
+#include <span>
+
+namespace Mirage::Math {
+
+// Swept sphere: every point within radius of the core segment
+class Capsule
+{
+  Segment m_segment;
+  float   m_radius{};
+
+public:
+  Capsule() = default;
+  Capsule( const Segment& segment, float radius ) : m_segment( segment ), m_radius( radius ) {}
+  Capsule( const Point3& start, const Point3& end, float radius ) : m_segment( start, end ), m_radius( radius ) {}
+
+  [[nodiscard]] inline const Segment& segment() const { return m_segment; }
+  [[nodiscard]] inline float          radius() const { return m_radius; }
+};
+
+// Capsules for the batched queries, one stream per component
+struct SoACapsule
+{
+  SoASegment             segment;
+  std::span<const float> radius;
+
+  [[nodiscard]] inline size_t size() const
+  {
+    assert( segment.size() == radius.size() );
+    return radius.size();
+  }
+
+  [[nodiscard]] inline Capsule operator[]( size_t i ) const { return Capsule{ segment[i], radius[i] }; }
+};
+
+inline bool contains( const Capsule& capsule, const Point3& point )
+{
+  const Vec3 d = point - closestPoint( capsule.segment(), point );
+  return magnitudeSquared( d ) <= capsule.radius() * capsule.radius();
+}
+
+// Signed distances between the surfaces: negative values are the penetration depth
+inline float distance( const Capsule& a, const Capsule& b )
+{
+  return distance( a.segment(), b.segment() ) - a.radius() - b.radius();
+}
+
+inline float distance( const Capsule& capsule, const Sphere& sphere )
+{
+  return distance( sphere.center(), capsule.segment() ) - capsule.radius() - sphere.radius();
+}
+
+inline bool overlaps( const Capsule& a, const Capsule& b )
+{
+  const float radius_sum = a.radius() + b.radius();
+  return distanceSquared( a.segment(), b.segment() ) <= radius_sum * radius_sum;
+}
+
+inline bool overlaps( const Capsule& capsule, const Sphere& sphere )
+{
+  const float radius_sum = capsule.radius() + sphere.radius();
+  const Vec3  d          = sphere.center() - closestPoint( capsule.segment(), sphere.center() );
+  return magnitudeSquared( d ) <= radius_sum * radius_sum;
+}
+
+// Batched signed distances, one per candidate (or per pair for the pairwise overload)
+inline void getDistances( const Capsule& query, const SoACapsule& candidates, std::span<float> distances )
+{
+  assert( distances.size() >= candidates.size() );
+  for ( size_t i = 0; i != candidates.size(); ++i )
+  {
+    distances[i] = distance( query, candidates[i] );
+  }
+}
+
+inline void getDistances( const SoACapsule& a, const SoACapsule& b, std::span<float> distances )
+{
+  assert( a.size() == b.size() && distances.size() >= a.size() );
+  for ( size_t i = 0; i != a.size(); ++i )
+  {
+    distances[i] = distance( a[i], b[i] );
+  }
+}
+
+inline void getDistances( const Capsule& query, const SoASphere& candidates, std::span<float> distances )
+{
+  assert( distances.size() >= candidates.size() );
+  for ( size_t i = 0; i != candidates.size(); ++i )
+  {
+    const Sphere sphere{
+      Point3{ candidates.center.x[i], candidates.center.y[i], candidates.center.z[i] },
+      candidates.radius[i]
+    };
+    distances[i] = distance( query, sphere );
+  }
+}
+
+// Tests one query against every candidate and writes one bit per candidate into mask.
+// Returns the number of overlapping candidates.
+inline size_t testOverlaps( const Capsule& query, const SoACapsule& candidates, std::span<uint64_t> mask )
+{
+  return fillMask( candidates.size(), mask, [&]( size_t i ) { return overlaps( query, candidates[i] ); } );
+}
+
+inline size_t testOverlaps( const Capsule& query, const SoASphere& candidates, std::span<uint64_t> mask )
+{
+  return fillMask( candidates.size(), mask, [&]( size_t i ) {
+    const Sphere sphere{
+      Point3{ candidates.center.x[i], candidates.center.y[i], candidates.center.z[i] },
+      candidates.radius[i]
+    };
+    return overlaps( query, sphere );
+  } );
+}
+
+} // namespace Mirage::Math
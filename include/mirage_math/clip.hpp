@@ -0,0 +1,202 @@
+#pragma once
+
+#include "arena.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <span>
+
+namespace Mirage::Math {
+
+// Polygon clipping (Sutherland-Hodgman). Polygons are convex and given as their vertices in order;
+// clipping keeps the part on the positive side of each plane, dot( plane, point ) >= 0, so frustum
+// and portal planes face inwards as for classify() in octree.hpp. Nothing is allocated: results go to
+// caller-provided buffers, which must not alias the input, or to an Arena.
+
+// Clipping a convex polygon by a plane adds at most one vertex, so this bounds the result of
+// clipping a polygon of vertex_count vertices against plane_count planes
+constexpr size_t clippedVertexCapacity( size_t vertex_count, size_t plane_count )
+{
+  return vertex_count + plane_count;
+}
+
+// One Sutherland-Hodgman pass; returns the number of vertices written to out
+inline size_t clipPolygon( std::span<const Point3> polygon, const Plane& plane, std::span<Point3> out )
+{
+  assert( out.size() >= clippedVertexCapacity( polygon.size(), 1 ) );
+  if ( polygon.empty() )
+  {
+    return 0;
+  }
+
+  size_t count             = 0;
+  Point3 previous          = polygon.back();
+  float  previous_distance = dot( plane, previous );
+  for ( const auto& current : polygon )
+  {
+    const float distance = dot( plane, current );
+    if ( ( previous_distance >= 0.0F ) != ( distance >= 0.0F ) )
+    {
+      const float t = previous_distance / ( previous_distance - distance );
+      out[count++]  = previous + ( current - previous ) * t;
+    }
+    if ( distance >= 0.0F )
+    {
+      out[count++] = current;
+    }
+    previous          = current;
+    previous_distance = distance;
+  }
+  return count;
+}
+
+// Clips against every plane in turn, alternating between out and scratch, both of which must hold
+// clippedVertexCapacity( polygon.size(), planes.size() ) vertices. Planes that keep every vertex
+// cost one dot product per vertex and no copy; a plane rejecting every vertex ends the clip.
+// Returns the clipped polygon, a prefix of out, which is empty if nothing is left.
+inline std::span<Point3> clipPolygon(
+  std::span<const Point3> polygon, std::span<const Plane> planes, std::span<Point3> out, std::span<Point3> scratch )
+{
+  [[maybe_unused]] const size_t capacity = clippedVertexCapacity( polygon.size(), planes.size() );
+  assert( out.size() >= capacity && scratch.size() >= capacity );
+
+  std::span<const Point3> current = polygon;
+  for ( const auto& plane : planes )
+  {
+    size_t inside = 0;
+    for ( const auto& vertex : current )
+    {
+      inside += dot( plane, vertex ) >= 0.0F ? 1 : 0;
+    }
+    if ( inside == 0 )
+    {
+      return out.first( 0 );
+    }
+    if ( inside == current.size() )
+    {
+      continue;
+    }
+
+    const std::span<Point3> target = current.data() == out.data() ? scratch : out;
+    current                        = target.first( clipPolygon( current, plane, target ) );
+  }
+
+  if ( current.data() != out.data() )
+  {
+    std::copy( current.begin(), current.end(), out.begin() );
+  }
+  return out.first( current.size() );
+}
+
+// Clips the triangles of an indexed mesh, three indices per triangle, against planes. The clipped
+// polygons are packed into vertices, polygon i spanning [offsets[i], offsets[i + 1]); triangles
+// clipped away entirely get empty ranges. vertices must hold
+// triangle count * clippedVertexCapacity( 3, planes.size() ) vertices, offsets triangle count + 1
+// entries and scratch clippedVertexCapacity( 3, planes.size() ) vertices. Returns the number of
+// vertices written.
+inline size_t clipTriangles( std::span<const Point3> positions,
+  std::span<const uint32_t>                          indices,
+  std::span<const Plane>                             planes,
+  std::span<Point3>                                  vertices,
+  std::span<uint32_t>                                offsets,
+  std::span<Point3>                                  scratch )
+{
+  assert( indices.size() % 3 == 0 );
+  const size_t triangle_count = indices.size() / 3;
+  const size_t capacity       = clippedVertexCapacity( 3, planes.size() );
+  assert( vertices.size() >= triangle_count * capacity && offsets.size() >= triangle_count + 1 );
+
+  size_t count = 0;
+  for ( size_t triangle = 0; triangle != triangle_count; ++triangle )
+  {
+    offsets[triangle] = static_cast<uint32_t>( count );
+
+    const std::array<Point3, 3> corners{ positions[indices[triangle * 3]],
+      positions[indices[triangle * 3 + 1]],
+      positions[indices[triangle * 3 + 2]] };
+    count += clipPolygon( corners, planes, vertices.subspan( count, capacity ), scratch ).size();
+  }
+  offsets[triangle_count] = static_cast<uint32_t>( count );
+  return count;
+}
+
+// clipPolygon with out and scratch taken from arena. Scratch is handed back before returning; the
+// result stays valid until the arena is rewound past this call.
+inline std::span<Point3> clipPolygon( std::span<const Point3> polygon, std::span<const Plane> planes, Arena& arena )
+{
+  [[maybe_unused]] const size_t capacity = clippedVertexCapacity( polygon.size(), planes.size() );
+  const auto   out      = arena.allocate<Point3>( capacity );
+  const auto   marker   = arena.mark();
+  const auto   result   = clipPolygon( polygon, planes, out, arena.allocate<Point3>( capacity ) );
+  arena.rewind( marker );
+  return result;
+}
+
+struct ClippedTriangles
+{
+  std::span<Point3>   vertices;
+  std::span<uint32_t> offsets;
+};
+
+// clipTriangles with every buffer taken from arena. vertices is trimmed to the vertices written,
+// though the arena still holds room for the worst case until it is rewound.
+inline ClippedTriangles clipTriangles(
+  std::span<const Point3> positions, std::span<const uint32_t> indices, std::span<const Plane> planes, Arena& arena )
+{
+  const size_t triangle_count = indices.size() / 3;
+  const size_t capacity       = clippedVertexCapacity( 3, planes.size() );
+
+  ClippedTriangles result{ arena.allocate<Point3>( triangle_count * capacity ),
+    arena.allocate<uint32_t>( triangle_count + 1 ) };
+  const auto       marker = arena.mark();
+  const size_t     count =
+    clipTriangles( positions, indices, planes, result.vertices, result.offsets, arena.allocate<Point3>( capacity ) );
+  arena.rewind( marker );
+  result.vertices = result.vertices.first( count );
+  return result;
+}
+
+// Planes of the volume seen from eye through a convex portal polygon, one per portal edge, facing
+// inwards. Further portals are clipped against these before the volume is narrowed to them.
+// planes must hold portal.size() planes; returns the number written, which is 0 for degenerate
+// portals.
+inline size_t makePortalPlanes( const Point3& eye, std::span<const Point3> portal, std::span<Plane> planes )
+{
+  assert( planes.size() >= portal.size() );
+  if ( portal.size() < 3 )
+  {
+    return 0;
+  }
+
+  Point3 centroid = portal.front();
+  for ( size_t i = 1; i != portal.size(); ++i )
+  {
+    centroid = centroid + ( portal[i] - centroid ) / static_cast<float>( i + 1 );
+  }
+
+  for ( size_t i = 0; i != portal.size(); ++i )
+  {
+    const Point3& a      = portal[i];
+    const Point3& b      = portal[( i + 1 ) % portal.size()];
+    Vec3          normal = cross( a - eye, b - eye );
+    if ( magnitudeSquared( normal ) <= FLOAT_MIN )
+    {
+      return 0;
+    }
+    normal       = normalized( normal );
+    float offset = -dot( normal, eye );
+    if ( dot( normal, centroid ) + offset < 0.0F )
+    {
+      normal = -normal;
+      offset = -offset;
+    }
+    planes[i] = Plane{ normal.x(), normal.y(), normal.z(), offset };
+  }
+  return portal.size();
+}
+
+} // namespace Mirage::Math
@@ -0,0 +1,385 @@
+#pragma once
+
+#include "constants.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Mirage::Math {
+
+struct ConvexHull
+{
+  // One plane per triangle, facing outwards: dot( plane, point ) <= 0 for every point of the hull
+  std::vector<Plane> planes;
+  // Three input indices per triangle, counter-clockwise seen from outside
+  std::vector<uint32_t> indices;
+  // Input indices of the hull vertices, ascending
+  std::vector<uint32_t> vertices;
+};
+
+// Quickhull (Barber, Dobkin and Huhdanpaa). Faces are triangles that each own three consecutive
+// half-edges, so faces and edges share one pool with a free list, and the points outside each face
+// are linked through one array over the input. A builder keeps all of this between builds, so
+// hulling many assets in turn allocates only for the results. Points within a tolerance derived
+// from EPSILON and the magnitude of the input are treated as lying on a face; coplanar triangles
+// are not merged.
+class ConvexHullBuilder
+{
+  static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+
+  struct Face
+  {
+    Plane    plane;
+    uint32_t outside{ INVALID }; // First point of the outside list
+    uint32_t farthest{ INVALID };
+    float    farthestDistance{};
+    uint32_t visited{}; // Stamp of the last horizon search that found the face visible
+    bool     alive{};
+  };
+
+  // Face f owns the half-edges 3f, 3f + 1 and 3f + 2, in counter-clockwise order
+  struct HalfEdge
+  {
+    uint32_t origin{};
+    uint32_t twin{ INVALID };
+  };
+
+  struct SearchFrame
+  {
+    uint32_t edge;
+    uint32_t remaining;
+  };
+
+  struct HorizonEdge
+  {
+    uint32_t origin;
+    uint32_t head;
+    uint32_t twin;
+  };
+
+  std::span<const Point3>  m_points;
+  float                    m_tolerance{};
+  uint32_t                 m_stamp{};
+  std::vector<Face>        m_faces;
+  std::vector<HalfEdge>    m_edges;
+  std::vector<uint32_t>    m_freeFaces;
+  std::vector<uint32_t>    m_nextOutside;
+  std::vector<uint32_t>    m_pending;
+  std::vector<uint32_t>    m_visible;
+  std::vector<SearchFrame> m_search;
+  std::vector<HorizonEdge> m_horizon;
+  std::vector<uint32_t>    m_newFaces;
+  std::vector<uint32_t>    m_orphans;
+
+  [[nodiscard]] static inline uint32_t nextEdge( uint32_t edge ) { return edge % 3 == 2 ? edge - 2 : edge + 1; }
+
+  [[nodiscard]] inline uint32_t head( uint32_t edge ) const { return m_edges[nextEdge( edge )].origin; }
+
+  void link( uint32_t a, uint32_t b )
+  {
+    m_edges[a].twin = b;
+    m_edges[b].twin = a;
+  }
+
+  uint32_t addFace( uint32_t a, uint32_t b, uint32_t c )
+  {
+    uint32_t face = 0;
+    if ( !m_freeFaces.empty() )
+    {
+      face = m_freeFaces.back();
+      m_freeFaces.pop_back();
+    } else
+    {
+      face = static_cast<uint32_t>( m_faces.size() );
+      m_faces.emplace_back();
+      m_edges.resize( m_edges.size() + 3 );
+    }
+
+    // Degenerate faces keep a zero normal, so no point is ever in front of them
+    const Point3& pa       = m_points[a];
+    const Point3& pb       = m_points[b];
+    const Point3& pc       = m_points[c];
+    Vec3          normal   = cross( pb - pa, pc - pa );
+    const float   length   = magnitude( normal );
+    normal                 = length > FLOAT_MIN ? normal / length : normal;
+    const Point3  centroid = ( pa + pb + pc ) / 3.0F;
+
+    m_faces[face]         = Face{};
+    m_faces[face].plane   = Plane{ normal.x(), normal.y(), normal.z(), -dot( normal, centroid ) };
+    m_faces[face].alive   = true;
+    m_edges[face * 3]     = HalfEdge{ a };
+    m_edges[face * 3 + 1] = HalfEdge{ b };
+    m_edges[face * 3 + 2] = HalfEdge{ c };
+    return face;
+  }
+
+  // Links point into the outside list of the first face it lies in front of, or drops it
+  void assign( uint32_t point, std::span<const uint32_t> faces )
+  {
+    for ( const uint32_t face : faces )
+    {
+      Face&       target   = m_faces[face];
+      const float distance = dot( target.plane, m_points[point] );
+      if ( distance > m_tolerance )
+      {
+        m_nextOutside[point] = target.outside;
+        target.outside       = point;
+        if ( distance > target.farthestDistance )
+        {
+          target.farthest         = point;
+          target.farthestDistance = distance;
+        }
+        return;
+      }
+    }
+  }
+
+  // Tetrahedron of four extreme points; fails for inputs that are flat within the tolerance
+  bool buildInitialSimplex()
+  {
+    std::array<uint32_t, 3> min_index{};
+    std::array<uint32_t, 3> max_index{};
+    Vec3                    max_abs{ 0.0F, 0.0F, 0.0F };
+    for ( uint32_t i = 0; i != m_points.size(); ++i )
+    {
+      for ( size_t axis = 0; axis != 3; ++axis )
+      {
+        const float value = m_points[i][axis];
+        min_index[axis]   = value < m_points[min_index[axis]][axis] ? i : min_index[axis];
+        max_index[axis]   = value > m_points[max_index[axis]][axis] ? i : max_index[axis];
+        max_abs[axis]     = std::max( max_abs[axis], std::fabs( value ) );
+      }
+    }
+    m_tolerance = 3.0F * EPSILON * ( max_abs.x() + max_abs.y() + max_abs.z() );
+
+    // The two extremes furthest apart along one axis
+    size_t axis = 0;
+    for ( size_t candidate = 1; candidate != 3; ++candidate )
+    {
+      const float spread = m_points[max_index[candidate]][candidate] - m_points[min_index[candidate]][candidate];
+      axis = spread > m_points[max_index[axis]][axis] - m_points[min_index[axis]][axis] ? candidate : axis;
+    }
+    const uint32_t v0 = min_index[axis];
+    const uint32_t v1 = max_index[axis];
+    if ( m_points[v1][axis] - m_points[v0][axis] <= m_tolerance )
+    {
+      return false;
+    }
+
+    // The point furthest from their line, then the point furthest from the plane of all three
+    const Vec3 direction = normalized( m_points[v1] - m_points[v0] );
+    uint32_t   v2        = v0;
+    float      best      = 0.0F;
+    for ( uint32_t i = 0; i != m_points.size(); ++i )
+    {
+      const float distance = magnitudeSquared( cross( m_points[i] - m_points[v0], direction ) );
+      v2                   = distance > best ? i : v2;
+      best                 = std::max( best, distance );
+    }
+    if ( std::sqrt( best ) <= m_tolerance )
+    {
+      return false;
+    }
+
+    const Vec3 normal      = normalized( cross( m_points[v1] - m_points[v0], m_points[v2] - m_points[v0] ) );
+    uint32_t   v3          = v0;
+    float      signed_best = 0.0F;
+    for ( uint32_t i = 0; i != m_points.size(); ++i )
+    {
+      const float distance = dot( normal, m_points[i] - m_points[v0] );
+      v3                   = std::fabs( distance ) > std::fabs( signed_best ) ? i : v3;
+      signed_best          = std::fabs( distance ) > std::fabs( signed_best ) ? distance : signed_best;
+    }
+    if ( std::fabs( signed_best ) <= m_tolerance )
+    {
+      return false;
+    }
+
+    // Orient the base so that it faces away from the apex; the sides reuse its edges reversed
+    const uint32_t a = v0;
+    const uint32_t b = signed_best > 0.0F ? v2 : v1;
+    const uint32_t c = signed_best > 0.0F ? v1 : v2;
+
+    const std::array<uint32_t, 4> faces{
+      addFace( a, b, c ), addFace( b, a, v3 ), addFace( c, b, v3 ), addFace( a, c, v3 )
+    };
+    for ( const uint32_t first : faces )
+    {
+      for ( const uint32_t second : faces )
+      {
+        for ( uint32_t i = first * 3; i != first * 3 + 3; ++i )
+        {
+          for ( uint32_t j = second * 3; j != second * 3 + 3; ++j )
+          {
+            if ( m_edges[i].origin == head( j ) && head( i ) == m_edges[j].origin )
+            {
+              m_edges[i].twin = j;
+            }
+          }
+        }
+      }
+    }
+
+    for ( uint32_t i = 0; i != m_points.size(); ++i )
+    {
+      if ( i != v0 && i != v1 && i != v2 && i != v3 )
+      {
+        assign( i, faces );
+      }
+    }
+    m_pending.assign( faces.begin(), faces.end() );
+    return true;
+  }
+
+  // Depth-first walk over the faces visible from eye, starting at face. Each edge of a visible face
+  // that leads to a hidden one is a horizon edge, and visiting every face's edges in order from the
+  // one it was entered by yields the horizon as a counter-clockwise loop.
+  void findHorizon( uint32_t face, const Point3& eye )
+  {
+    ++m_stamp;
+    m_visible.clear();
+    m_horizon.clear();
+    m_faces[face].visited = m_stamp;
+    m_visible.push_back( face );
+    m_search.assign( 1, SearchFrame{ face * 3, 3 } );
+    while ( !m_search.empty() )
+    {
+      SearchFrame& frame = m_search.back();
+      if ( frame.remaining == 0 )
+      {
+        m_search.pop_back();
+        continue;
+      }
+      const uint32_t edge = frame.edge;
+      frame.edge          = nextEdge( edge );
+      --frame.remaining;
+
+      const uint32_t twin     = m_edges[edge].twin;
+      const uint32_t neighbor = twin / 3;
+      if ( m_faces[neighbor].visited == m_stamp )
+      {
+        continue;
+      }
+      if ( dot( m_faces[neighbor].plane, eye ) > m_tolerance )
+      {
+        m_faces[neighbor].visited = m_stamp;
+        m_visible.push_back( neighbor );
+        m_search.push_back( SearchFrame{ nextEdge( twin ), 2 } );
+      } else
+      {
+        m_horizon.push_back( HorizonEdge{ m_edges[edge].origin, head( edge ), twin } );
+      }
+    }
+  }
+
+  void expand( uint32_t face )
+  {
+    const uint32_t eye = m_faces[face].farthest;
+    findHorizon( face, m_points[eye] );
+
+    // The visible faces are replaced, so their outside points need new owners
+    m_orphans.clear();
+    for ( const uint32_t visible : m_visible )
+    {
+      for ( uint32_t point = m_faces[visible].outside; point != INVALID; point = m_nextOutside[point] )
+      {
+        if ( point != eye )
+        {
+          m_orphans.push_back( point );
+        }
+      }
+      m_faces[visible].alive = false;
+      m_freeFaces.push_back( visible );
+    }
+
+    // A fan of faces from the eye to the horizon, linked to the hidden faces and to each other
+    m_newFaces.clear();
+    for ( const auto& edge : m_horizon )
+    {
+      const uint32_t created = addFace( edge.origin, edge.head, eye );
+      link( created * 3, edge.twin );
+      m_newFaces.push_back( created );
+    }
+    for ( size_t i = 0; i != m_newFaces.size(); ++i )
+    {
+      link( m_newFaces[i] * 3 + 1, m_newFaces[( i + 1 ) % m_newFaces.size()] * 3 + 2 );
+    }
+
+    for ( const uint32_t point : m_orphans )
+    {
+      assign( point, m_newFaces );
+    }
+    for ( const uint32_t created : m_newFaces )
+    {
+      if ( m_faces[created].outside != INVALID )
+      {
+        m_pending.push_back( created );
+      }
+    }
+  }
+
+public:
+  // Fails if there are fewer than four points or they are coplanar within the tolerance
+  std::optional<ConvexHull> build( std::span<const Point3> points )
+  {
+    m_points = points;
+    m_faces.clear();
+    m_edges.clear();
+    m_freeFaces.clear();
+    m_pending.clear();
+    m_nextOutside.assign( points.size(), INVALID );
+    if ( points.size() < 4 || !buildInitialSimplex() )
+    {
+      return std::nullopt;
+    }
+
+    while ( !m_pending.empty() )
+    {
+      const uint32_t face = m_pending.back();
+      m_pending.pop_back();
+      if ( m_faces[face].alive && m_faces[face].outside != INVALID )
+      {
+        expand( face );
+      }
+    }
+
+    ConvexHull           hull;
+    std::vector<uint8_t> on_hull( points.size() );
+    for ( uint32_t face = 0; face != m_faces.size(); ++face )
+    {
+      if ( !m_faces[face].alive )
+      {
+        continue;
+      }
+      hull.planes.push_back( m_faces[face].plane );
+      for ( uint32_t edge = face * 3; edge != face * 3 + 3; ++edge )
+      {
+        hull.indices.push_back( m_edges[edge].origin );
+        on_hull[m_edges[edge].origin] = 1;
+      }
+    }
+    for ( uint32_t i = 0; i != points.size(); ++i )
+    {
+      if ( on_hull[i] != 0 )
+      {
+        hull.vertices.push_back( i );
+      }
+    }
+    return hull;
+  }
+};
+
+inline std::optional<ConvexHull> makeConvexHull( std::span<const Point3> points )
+{
+  return ConvexHullBuilder{}.build( points );
+}
+
+} // namespace Mirage::Math
@@ -0,0 +1,730 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "batch.hpp"
+#include "capsule.hpp"
+#include "constants.hpp"
+#include "obb.hpp"
+#include "point.hpp"
+#include "quaternion.hpp"
+#include "sphere.hpp"
+#include "transform.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+
+namespace Mirage::Math {
+
+// Convex shapes for GJK and EPA are described by a support function: support( shape, direction )
+// returns a point of the shape that is furthest along direction. Rounded shapes are split into a
+// core and a radius, the shape being every point within supportRadius( shape ) of its core; GJK
+// and EPA then run on the cores, which converge in a few iterations where a curved surface would
+// take many, and the radii are accounted for afterwards.
+inline Point3 support( const Sphere& sphere, const Vec3& /*direction*/ ) { return sphere.center(); }
+inline float  supportRadius( const Sphere& sphere ) { return sphere.radius(); }
+
+inline Point3 support( const Capsule& capsule, const Vec3& direction )
+{
+  const Segment& segment = capsule.segment();
+  return dot( direction, segment.vector() ) >= 0.0F ? segment.end() : segment.start();
+}
+inline float supportRadius( const Capsule& capsule ) { return capsule.radius(); }
+
+inline Point3 support( const AABB& box, const Vec3& direction )
+{
+  return Point3{ direction.x() >= 0.0F ? box.max().x() : box.min().x(),
+    direction.y() >= 0.0F ? box.max().y() : box.min().y(),
+    direction.z() >= 0.0F ? box.max().z() : box.min().z() };
+}
+inline float supportRadius( const AABB& /*box*/ ) { return 0.0F; }
+
+inline Point3 support( const OBB& box, const Vec3& direction )
+{
+  Point3 point = box.center();
+  for ( size_t axis = 0; axis != 3; ++axis )
+  {
+    const float extent = box.halfExtents()[axis];
+    point              = point + box.axis( axis ) * ( dot( direction, box.axis( axis ) ) >= 0.0F ? extent : -extent );
+  }
+  return point;
+}
+inline float supportRadius( const OBB& /*box*/ ) { return 0.0F; }
+
+// Convex hull of a point set, e.g. the vertices of a ConvexHull. Support queries scan every point,
+// so pass hull vertices rather than the raw input.
+struct ConvexPoints
+{
+  std::span<const Point3> points;
+};
+
+inline Point3 support( const ConvexPoints& hull, const Vec3& direction )
+{
+  assert( !hull.points.empty() );
+  size_t best          = 0;
+  float  best_distance = dot( direction, hull.points.front() );
+  for ( size_t i = 1; i != hull.points.size(); ++i )
+  {
+    const float distance = dot( direction, hull.points[i] );
+    best                 = distance > best_distance ? i : best;
+    best_distance        = std::max( best_distance, distance );
+  }
+  return hull.points[best];
+}
+inline float supportRadius( const ConvexPoints& /*hull*/ ) { return 0.0F; }
+
+template<typename T>
+concept ConvexShape = requires( const T& shape, const Vec3& direction ) {
+  { support( shape, direction ) } -> std::convertible_to<Point3>;
+  { supportRadius( shape ) } -> std::convertible_to<float>;
+};
+
+// Shape given in local coordinates and placed by a rigid transform, so that for instance one hull
+// serves every instance of an asset
+template<ConvexShape Shape>
+class Transformed
+{
+  Shape      m_shape;
+  Transform4 m_transform;
+
+public:
+  Transformed( const Shape& shape, const Transform4& transform ) : m_shape( shape ), m_transform( transform ) {}
+  Transformed( const Shape& shape, const Quaternion& rotation, const Point3& translation ) : m_shape( shape )
+  {
+    const Mat3 r = rotation.getRotationMatrix();
+    m_transform  = Transform4{ r( 0, 0 ),
+      r( 0, 1 ),
+      r( 0, 2 ),
+      translation.x(),
+      r( 1, 0 ),
+      r( 1, 1 ),
+      r( 1, 2 ),
+      translation.y(),
+      r( 2, 0 ),
+      r( 2, 1 ),
+      r( 2, 2 ),
+      translation.z() };
+  }
+
+  [[nodiscard]] inline const Shape&      shape() const { return m_shape; }
+  [[nodiscard]] inline const Transform4& transform() const { return m_transform; }
+};
+
+// The direction goes into local space through the transposed rotation
+template<ConvexShape Shape>
+inline Point3 support( const Transformed<Shape>& shape, const Vec3& direction )
+{
+  return shape.transform() * support( shape.shape(), direction * shape.transform() );
+}
+
+template<ConvexShape Shape>
+inline float supportRadius( const Transformed<Shape>& shape )
+{
+  return supportRadius( shape.shape() );
+}
+
+// Vertex of the Minkowski difference of two cores, a - b, with the direction it was found along
+struct SupportVertex
+{
+  Point3 a;
+  Point3 b;
+  Vec3   w;
+  Vec3   direction;
+};
+
+template<ConvexShape ShapeA, ConvexShape ShapeB>
+inline SupportVertex makeSupportVertex( const ShapeA& a, const ShapeB& b, const Vec3& direction )
+{
+  const Point3 point_a = support( a, direction );
+  const Point3 point_b = support( b, -direction );
+  return SupportVertex{ point_a, point_b, point_a - point_b, direction };
+}
+
+// GJK simplex of up to four vertices. Keeping one per shape pair between frames warm-starts the
+// next query: the cached directions are evaluated again against the moved shapes, which for
+// persistent contacts rebuilds a simplex next to the answer, so GJK ends after one or two steps.
+class GJKSimplex
+{
+  std::array<SupportVertex, 4> m_vertices{};
+  std::array<float, 4>         m_weights{};
+  uint32_t                     m_count{};
+
+  struct Solution
+  {
+    std::array<uint32_t, 4> vertices{};
+    std::array<float, 4>    weights{};
+    uint32_t                count{};
+    Vec3                    closest;
+  };
+
+  [[nodiscard]] Solution solveSegment( uint32_t i, uint32_t j ) const
+  {
+    const Vec3& a      = m_vertices[i].w;
+    const Vec3  ab     = m_vertices[j].w - a;
+    const float length = magnitudeSquared( ab );
+    const float t      = length > FLOAT_MIN ? -dot( a, ab ) / length : 0.0F;
+    if ( t <= 0.0F )
+    {
+      return Solution{ { i }, { 1.0F }, 1, a };
+    }
+    if ( t >= 1.0F )
+    {
+      return Solution{ { j }, { 1.0F }, 1, m_vertices[j].w };
+    }
+    return Solution{ { i, j }, { 1.0F - t, t }, 2, a + ab * t };
+  }
+
+  // Voronoi regions of the triangle with the origin as query point (Ericson 5.1.5)
+  [[nodiscard]] Solution solveTriangle( uint32_t i, uint32_t j, uint32_t k ) const
+  {
+    const Vec3& a  = m_vertices[i].w;
+    const Vec3& b  = m_vertices[j].w;
+    const Vec3& c  = m_vertices[k].w;
+    const Vec3  ab = b - a;
+    const Vec3  ac = c - a;
+
+    const float d1 = -dot( ab, a );
+    const float d2 = -dot( ac, a );
+    if ( d1 <= 0.0F && d2 <= 0.0F )
+    {
+      return Solution{ { i }, { 1.0F }, 1, a };
+    }
+    const float d3 = -dot( ab, b );
+    const float d4 = -dot( ac, b );
+    if ( d3 >= 0.0F && d4 <= d3 )
+    {
+      return Solution{ { j }, { 1.0F }, 1, b };
+    }
+    const float vc = d1 * d4 - d3 * d2;
+    if ( vc <= 0.0F && d1 >= 0.0F && d3 <= 0.0F )
+    {
+      return solveSegment( i, j );
+    }
+    const float d5 = -dot( ab, c );
+    const float d6 = -dot( ac, c );
+    if ( d6 >= 0.0F && d5 <= d6 )
+    {
+      return Solution{ { k }, { 1.0F }, 1, c };
+    }
+    const float vb = d5 * d2 - d1 * d6;
+    if ( vb <= 0.0F && d2 >= 0.0F && d6 <= 0.0F )
+    {
+      return solveSegment( i, k );
+    }
+    const float va = d3 * d6 - d5 * d4;
+    if ( va <= 0.0F && d4 >= d3 && d5 >= d6 )
+    {
+      return solveSegment( j, k );
+    }
+
+    // Degenerate triangles fall back to the best of their edges
+    const float sum = va + vb + vc;
+    if ( sum <= FLOAT_MIN )
+    {
+      const std::array<Solution, 3> edges{ solveSegment( i, j ), solveSegment( i, k ), solveSegment( j, k ) };
+      return *std::min_element( edges.begin(), edges.end(), []( const Solution& x, const Solution& y ) {
+        return magnitudeSquared( x.closest ) < magnitudeSquared( y.closest );
+      } );
+    }
+    const float v = vb / sum;
+    const float w = vc / sum;
+    return Solution{ { i, j, k }, { 1.0F - v - w, v, w }, 3, a + ab * v + ac * w };
+  }
+
+  // The closest point lies on a face the origin is in front of; none means the origin is enclosed
+  [[nodiscard]] std::optional<Solution> solveTetrahedron() const
+  {
+    constexpr std::array<std::array<uint32_t, 4>, 4> faces{
+      { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } }
+    };
+
+    // A flat tetrahedron cannot enclose the origin, so all of its faces are candidates. Flatness is
+    // relative to the edge lengths: the difference of two segments, say, is a parallelogram.
+    const Vec3 e1   = m_vertices[1].w - m_vertices[0].w;
+    const Vec3 e2   = m_vertices[2].w - m_vertices[0].w;
+    const Vec3 e3   = m_vertices[3].w - m_vertices[0].w;
+    const bool flat = std::fabs( dot( cross( e1, e2 ), e3 ) )
+                      <= 16.0F * EPSILON * magnitude( e1 ) * magnitude( e2 ) * magnitude( e3 );
+
+    std::optional<Solution> best;
+    for ( const auto& face : faces )
+    {
+      const Vec3& a      = m_vertices[face[0]].w;
+      const Vec3  normal = cross( m_vertices[face[1]].w - a, m_vertices[face[2]].w - a );
+      const float origin = -dot( normal, a );
+      const float apex   = dot( normal, m_vertices[face[3]].w - a );
+      if ( flat || origin * apex < 0.0F )
+      {
+        const Solution solution = solveTriangle( face[0], face[1], face[2] );
+        if ( !best || magnitudeSquared( solution.closest ) < magnitudeSquared( best->closest ) )
+        {
+          best = solution;
+        }
+      }
+    }
+    return best;
+  }
+
+public:
+  [[nodiscard]] inline uint32_t             size() const { return m_count; }
+  [[nodiscard]] inline const SupportVertex& operator[]( uint32_t i ) const { return m_vertices[i]; }
+
+  inline void clear() { m_count = 0; }
+
+  inline void add( const SupportVertex& vertex )
+  {
+    assert( m_count < 4 );
+    m_vertices[m_count++] = vertex;
+  }
+
+  [[nodiscard]] bool contains( const Vec3& w ) const
+  {
+    for ( uint32_t i = 0; i != m_count; ++i )
+    {
+      if ( magnitudeSquared( m_vertices[i].w - w ) <= FLOAT_MIN )
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Re-evaluates the vertices along their directions against moved shapes
+  template<ConvexShape ShapeA, ConvexShape ShapeB>
+  void refresh( const ShapeA& a, const ShapeB& b )
+  {
+    for ( uint32_t i = 0; i != m_count; ++i )
+    {
+      m_vertices[i] = makeSupportVertex( a, b, m_vertices[i].direction );
+    }
+  }
+
+  // Reduces the simplex to the vertices supporting its point closest to the origin and writes that
+  // point to closest. Returns false if the simplex is a tetrahedron enclosing the origin.
+  bool solve( Vec3& closest )
+  {
+    std::optional<Solution> solution;
+    switch ( m_count )
+    {
+    case 1:
+      solution = Solution{ { 0 }, { 1.0F }, 1, m_vertices[0].w };
+      break;
+    case 2:
+      solution = solveSegment( 0, 1 );
+      break;
+    case 3:
+      solution = solveTriangle( 0, 1, 2 );
+      break;
+    default:
+      solution = solveTetrahedron();
+      break;
+    }
+    if ( !solution )
+    {
+      return false;
+    }
+
+    const std::array<SupportVertex, 4> vertices = m_vertices;
+    for ( uint32_t i = 0; i != solution->count; ++i )
+    {
+      m_vertices[i] = vertices[solution->vertices[i]];
+      m_weights[i]  = solution->weights[i];
+    }
+    m_count = solution->count;
+    closest = solution->closest;
+    return true;
+  }
+
+  // Points on the two cores whose difference is the closest point of the last solve
+  void getClosestPoints( Point3& a, Point3& b ) const
+  {
+    a = Point3{ 0.0F, 0.0F, 0.0F };
+    b = Point3{ 0.0F, 0.0F, 0.0F };
+    for ( uint32_t i = 0; i != m_count; ++i )
+    {
+      a = a + Vec3{ m_vertices[i].a } * m_weights[i];
+      b = b + Vec3{ m_vertices[i].b } * m_weights[i];
+    }
+  }
+};
+
+constexpr uint32_t GJK_MAX_ITERATIONS = 64;
+constexpr uint32_t EPA_MAX_ITERATIONS = 64;
+constexpr uint32_t EPA_MAX_VERTICES   = 64;
+constexpr uint32_t EPA_MAX_FACES      = 128;
+// GJK stops once a step improves the squared distance by less than this fraction
+constexpr float GJK_RELATIVE_TOLERANCE = 1e-6F;
+// EPA stops once the support along the closest face is at most this far beyond it, relative to
+// the distance of the face where that exceeds one
+constexpr float EPA_RELATIVE_TOLERANCE = 1e-4F;
+
+// GJK on the cores of a and b, starting from simplex. Returns false if the cores intersect, with
+// the simplex then enclosing or touching the origin; otherwise closest is the point of the
+// difference of the cores nearest to the origin, and the simplex supports it.
+template<ConvexShape ShapeA, ConvexShape ShapeB>
+bool separateCores( const ShapeA& a, const ShapeB& b, GJKSimplex& simplex, Vec3& closest )
+{
+  simplex.refresh( a, b );
+  if ( simplex.size() == 0 )
+  {
+    simplex.add( makeSupportVertex( a, b, Vec3{ 1.0F, 0.0F, 0.0F } ) );
+  }
+  if ( !simplex.solve( closest ) )
+  {
+    return false;
+  }
+
+  for ( uint32_t iteration = 0; iteration != GJK_MAX_ITERATIONS; ++iteration )
+  {
+    const float distance_squared = magnitudeSquared( closest );
+    float       scale_squared    = 0.0F;
+    for ( uint32_t i = 0; i != simplex.size(); ++i )
+    {
+      scale_squared = std::max( scale_squared, magnitudeSquared( simplex[i].w ) );
+    }
+    if ( distance_squared <= EPSILON * EPSILON * scale_squared || distance_squared <= FLOAT_MIN )
+    {
+      return false;
+    }
+
+    // Stop once no support point gets meaningfully closer to the origin than the current one
+    const SupportVertex vertex = makeSupportVertex( a, b, -closest );
+    if ( distance_squared - dot( closest, vertex.w ) <= GJK_RELATIVE_TOLERANCE * distance_squared
+         || simplex.contains( vertex.w ) )
+    {
+      return true;
+    }
+
+    simplex.add( vertex );
+    if ( !simplex.solve( closest ) )
+    {
+      return false;
+    }
+    if ( magnitudeSquared( closest ) >= distance_squared )
+    {
+      return true;
+    }
+  }
+  return true;
+}
+
+struct ClosestPoints
+{
+  Point3 a;
+  Point3 b;
+  float  distance{};
+};
+
+// Closest points of the surfaces of two separated shapes. Returns false, leaving result
+// unspecified, if the shapes overlap.
+template<ConvexShape ShapeA, ConvexShape ShapeB>
+bool closestPoints( const ShapeA& a, const ShapeB& b, ClosestPoints& result, GJKSimplex& simplex )
+{
+  Vec3 closest;
+  if ( !separateCores( a, b, simplex, closest ) )
+  {
+    return false;
+  }
+
+  const float core_distance = magnitude( closest );
+  const float radius_a      = supportRadius( a );
+  const float radius_b      = supportRadius( b );
+  if ( core_distance <= radius_a + radius_b )
+  {
+    return false;
+  }
+
+  Point3 point_a;
+  Point3 point_b;
+  simplex.getClosestPoints( point_a, point_b );
+  const Vec3 normal = -closest / core_distance;
+  result            = ClosestPoints{ point_a + normal * radius_a,
+    point_b - normal * radius_b,
+    core_distance - radius_a - radius_b };
+  return true;
+}
+
+template<ConvexShape ShapeA, ConvexShape ShapeB>
+inline std::optional<ClosestPoints> getClosestPoints( const ShapeA& a, const ShapeB& b, GJKSimplex& simplex )
+{
+  ClosestPoints result;
+  return closestPoints( a, b, result, simplex ) ? std::optional{ result } : std::nullopt;
+}
+
+template<ConvexShape ShapeA, ConvexShape ShapeB>
+inline std::optional<ClosestPoints> getClosestPoints( const ShapeA& a, const ShapeB& b )
+{
+  GJKSimplex simplex;
+  return getClosestPoints( a, b, simplex );
+}
+
+template<ConvexShape ShapeA, ConvexShape ShapeB>
+inline bool overlaps( const ShapeA& a, const ShapeB& b, GJKSimplex& simplex )
+{
+  Vec3 closest;
+  return !separateCores( a, b, simplex, closest ) || magnitude( closest ) <= supportRadius( a ) + supportRadius( b );
+}
+
+// How far b has to move along normal, which points from a to b, to separate the shapes, and the
+// deepest point of each shape along it
+struct Penetration
+{
+  Vec3   normal;
+  float  depth{};
+  Point3 a;
+  Point3 b;
+};
+
+// Expanding polytope algorithm (van den Bergen) on intersecting cores, starting from the final GJK
+// simplex. Polytope storage is fixed-size, so a query never allocates; running out of it ends the
+// expansion with the best face so far.
+template<ConvexShape ShapeA, ConvexShape ShapeB>
+Penetration expandPolytope( const ShapeA& a, const ShapeB& b, const GJKSimplex& simplex )
+{
+  struct Face
+  {
+    std::array<uint32_t, 3> vertices;
+    Vec3                    normal;
+    float                   distance;
+  };
+
+  struct Edge
+  {
+    uint32_t from;
+    uint32_t to;
+  };
+
+  std::array<SupportVertex, EPA_MAX_VERTICES> vertices;
+  std::array<Face, EPA_MAX_FACES>             faces;
+  std::array<Edge, EPA_MAX_FACES>             horizon;
+  uint32_t                                    vertex_count = simplex.size();
+  uint32_t                                    face_count   = 0;
+  for ( uint32_t i = 0; i != vertex_count; ++i )
+  {
+    vertices[i] = simplex[i];
+  }
+
+  // Grow a lower-dimensional simplex into a tetrahedron, trying directions away from what it spans
+  const auto try_add = [&]( const Vec3& direction, auto&& is_new ) {
+    const SupportVertex vertex = makeSupportVertex( a, b, direction );
+    if ( is_new( vertex.w ) )
+    {
+      vertices[vertex_count++] = vertex;
+      return true;
+    }
+    return false;
+  };
+  const float tolerance = EPSILON * std::max( magnitude( vertices[0].w ), 1.0F );
+  if ( vertex_count == 1 )
+  {
+    for ( const Vec3& axis : { Vec3{ 1.0F, 0.0F, 0.0F }, Vec3{ 0.0F, 1.0F, 0.0F }, Vec3{ 0.0F, 0.0F, 1.0F } } )
+    {
+      const auto is_new = [&]( const Vec3& w ) { return magnitude( w - vertices[0].w ) > tolerance; };
+      if ( try_add( axis, is_new ) || try_add( -axis, is_new ) )
+      {
+        break;
+      }
+    }
+  }
+  if ( vertex_count == 2 )
+  {
+    const Vec3 line   = vertices[1].w - vertices[0].w;
+    const Vec3 x_axis = Vec3{ 1.0F, 0.0F, 0.0F };
+    const Vec3 y_axis = Vec3{ 0.0F, 1.0F, 0.0F };
+    const Vec3 u      = cross( line, std::fabs( line.x() ) < std::fabs( line.y() ) ? x_axis : y_axis );
+    const Vec3 v      = cross( line, u );
+    const auto is_new = [&]( const Vec3& w ) {
+      return magnitude( cross( w - vertices[0].w, line ) ) > tolerance * magnitude( line );
+    };
+    for ( const Vec3& direction : { u, -u, v, -v } )
+    {
+      if ( try_add( direction, is_new ) )
+      {
+        break;
+      }
+    }
+  }
+  if ( vertex_count == 3 )
+  {
+    const Vec3 normal = cross( vertices[1].w - vertices[0].w, vertices[2].w - vertices[0].w );
+    const auto is_new = [&]( const Vec3& w ) {
+      return std::fabs( dot( w - vertices[0].w, normal ) ) > tolerance * magnitude( normal );
+    };
+    if ( !try_add( normal, is_new ) )
+    {
+      try_add( -normal, is_new );
+    }
+  }
+
+  // Slivers get an infinite distance, so that they are never picked as the closest face
+  const auto add_face = [&]( uint32_t i, uint32_t j, uint32_t k ) {
+    const Vec3  normal   = cross( vertices[j].w - vertices[i].w, vertices[k].w - vertices[i].w );
+    const float length   = magnitude( normal );
+    const bool  valid    = length > FLOAT_MIN;
+    const Vec3  unit     = normal / safeDivisor( length, valid );
+    const float distance = valid ? dot( unit, vertices[i].w ) : std::numeric_limits<float>::infinity();
+    faces[face_count++]  = Face{ { i, j, k }, unit, distance };
+  };
+
+  if ( vertex_count == 4 )
+  {
+    constexpr std::array<std::array<uint32_t, 4>, 4> tetrahedron{
+      { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } }
+    };
+    for ( const auto& face : tetrahedron )
+    {
+      // Faces point away from the opposite vertex
+      const Vec3 normal = cross( vertices[face[1]].w - vertices[face[0]].w, vertices[face[2]].w - vertices[face[0]].w );
+      if ( dot( normal, vertices[face[3]].w - vertices[face[0]].w ) > 0.0F )
+      {
+        add_face( face[0], face[2], face[1] );
+      } else
+      {
+        add_face( face[0], face[1], face[2] );
+      }
+    }
+  }
+
+  // Shapes that are flat where they touch leave no volume to expand: report a zero-depth contact
+  const auto touching = [&]() {
+    const Vec3  direction = vertices[0].direction;
+    const float length    = magnitude( direction );
+    const Vec3  normal    = length > FLOAT_MIN ? direction / length : Vec3{ 1.0F, 0.0F, 0.0F };
+    return Penetration{ normal, 0.0F, vertices[0].a, vertices[0].b };
+  };
+  if ( face_count == 0 )
+  {
+    return touching();
+  }
+
+  // The closest face is copied out, as removing faces reorders the array
+  Face face = faces[0];
+  for ( uint32_t iteration = 0; iteration != EPA_MAX_ITERATIONS; ++iteration )
+  {
+    uint32_t closest = 0;
+    for ( uint32_t i = 1; i != face_count; ++i )
+    {
+      closest = faces[i].distance < faces[closest].distance ? i : closest;
+    }
+    face = faces[closest];
+
+    const SupportVertex vertex = makeSupportVertex( a, b, face.normal );
+    const float         gain   = dot( face.normal, vertex.w ) - face.distance;
+    if ( gain <= EPA_RELATIVE_TOLERANCE * std::max( face.distance, 1.0F ) || vertex_count == EPA_MAX_VERTICES )
+    {
+      break;
+    }
+
+    // Remove the faces the new vertex sees, keeping the edges between kept and removed faces
+    uint32_t horizon_count = 0;
+    for ( uint32_t i = 0; i != face_count; )
+    {
+      if ( dot( faces[i].normal, vertex.w - vertices[faces[i].vertices[0]].w ) <= 0.0F )
+      {
+        ++i;
+        continue;
+      }
+      for ( uint32_t e = 0; e != 3; ++e )
+      {
+        const Edge edge{ faces[i].vertices[e], faces[i].vertices[( e + 1 ) % 3] };
+        const auto twin = std::find_if( horizon.begin(), horizon.begin() + horizon_count, [&edge]( const Edge& other ) {
+          return other.from == edge.to && other.to == edge.from;
+        } );
+        if ( twin != horizon.begin() + horizon_count )
+        {
+          *twin = horizon[--horizon_count];
+        } else if ( horizon_count != horizon.size() )
+        {
+          horizon[horizon_count++] = edge;
+        }
+      }
+      faces[i] = faces[--face_count];
+    }
+
+    if ( horizon_count == 0 || face_count + horizon_count > EPA_MAX_FACES )
+    {
+      break;
+    }
+    vertices[vertex_count] = vertex;
+    for ( uint32_t i = 0; i != horizon_count; ++i )
+    {
+      add_face( horizon[i].from, horizon[i].to, vertex_count );
+    }
+    ++vertex_count;
+  }
+
+  if ( std::isinf( face.distance ) )
+  {
+    return touching();
+  }
+
+  // The origin projected onto the closest face, in barycentric coordinates of its vertices
+  const Vec3& w0  = vertices[face.vertices[0]].w;
+  const Vec3  e1  = vertices[face.vertices[1]].w - w0;
+  const Vec3  e2  = vertices[face.vertices[2]].w - w0;
+  const Vec3  p   = face.normal * face.distance - w0;
+  const float d11 = dot( e1, e1 );
+  const float d12 = dot( e1, e2 );
+  const float d22 = dot( e2, e2 );
+  const float det = d11 * d22 - d12 * d12;
+  const float v   = det > FLOAT_MIN ? ( d22 * dot( p, e1 ) - d12 * dot( p, e2 ) ) / det : 0.0F;
+  const float w   = det > FLOAT_MIN ? ( d11 * dot( p, e2 ) - d12 * dot( p, e1 ) ) / det : 0.0F;
+
+  const std::array<float, 3> weights{ 1.0F - v - w, v, w };
+
+  Point3 point_a{ 0.0F, 0.0F, 0.0F };
+  Point3 point_b{ 0.0F, 0.0F, 0.0F };
+  for ( uint32_t i = 0; i != 3; ++i )
+  {
+    point_a = point_a + Vec3{ vertices[face.vertices[i]].a } * weights[i];
+    point_b = point_b + Vec3{ vertices[face.vertices[i]].b } * weights[i];
+  }
+  return Penetration{ face.normal, face.distance, point_a, point_b };
+}
+
+// Penetration of two overlapping shapes, or std::nullopt if they are separated. Shallow contacts
+// of rounded shapes, where only the radii overlap, are resolved by GJK alone.
+template<ConvexShape ShapeA, ConvexShape ShapeB>
+std::optional<Penetration> getPenetration( const ShapeA& a, const ShapeB& b, GJKSimplex& simplex )
+{
+  const float radius_a = supportRadius( a );
+  const float radius_b = supportRadius( b );
+
+  Vec3 closest;
+  if ( separateCores( a, b, simplex, closest ) )
+  {
+    const float core_distance = magnitude( closest );
+    if ( core_distance > radius_a + radius_b )
+    {
+      return std::nullopt;
+    }
+
+    Point3 point_a;
+    Point3 point_b;
+    simplex.getClosestPoints( point_a, point_b );
+    const Vec3 normal = -closest / core_distance;
+    return Penetration{
+      normal, radius_a + radius_b - core_distance, point_a + normal * radius_a, point_b - normal * radius_b
+    };
+  }
+
+  Penetration penetration = expandPolytope( a, b, simplex );
+  penetration.depth += radius_a + radius_b;
+  penetration.a = penetration.a + penetration.normal * radius_a;
+  penetration.b = penetration.b - penetration.normal * radius_b;
+  return penetration;
+}
+
+template<ConvexShape ShapeA, ConvexShape ShapeB>
+inline std::optional<Penetration> getPenetration( const ShapeA& a, const ShapeB& b )
+{
+  GJKSimplex simplex;
+  return getPenetration( a, b, simplex );
+}
+
+} // namespace Mirage::Math
@@ -0,0 +1,453 @@
+#pragma once
+
+#include "arena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Work-stealing thread pool shared by the parallel algorithms. Every worker owns a deque of jobs: it
+// pushes and pops at the back, so it keeps working on the most recently split, cache-warm ranges,
+// while idle workers steal from the front, where the largest pieces are. Workers with nothing to
+// do or steal sleep until new jobs arrive.
+//
+// Threads that wait for jobs, in parallelFor() or TaskGroup::wait(), run other jobs meanwhile if they
+// are workers, so jobs may start nested parallel work. Other threads hand their jobs to the workers
+// and block. Exceptions thrown by jobs are passed to the waiting thread.
+class JobSystem
+{
+public:
+  struct WorkerStats
+  {
+    uint64_t                 jobs{};
+    // Jobs taken from the deques of other workers
+    uint64_t                 steals{};
+    std::chrono::nanoseconds busy{};
+    // Fraction of the time since the system started, or the last resetStats(), spent running jobs
+    double utilization{};
+  };
+
+private:
+  // Completion state of one parallelFor or TaskGroup. pending only drops under the mutex, so a waiter
+  // that sees it at zero under the mutex knows that no job touches the context any more and may
+  // destroy it.
+  struct JobContext
+  {
+    // Runs the items [first, last)
+    void ( *run )( JobContext& context, size_t first, size_t last ){};
+    void*  data{};
+    // Jobs above this many items are split in half, 0 for jobs that are never split
+    size_t grain{};
+
+    std::atomic<size_t>     pending{};
+    std::atomic<bool>       failed{ false };
+    std::mutex              mutex;
+    std::condition_variable completed;
+    std::exception_ptr      error;
+
+    void fail( std::exception_ptr exception )
+    {
+      const std::lock_guard lock( mutex );
+      if ( !error )
+      {
+        error = std::move( exception );
+      }
+      failed = true;
+    }
+
+    void finish( size_t count )
+    {
+      const std::lock_guard lock( mutex );
+      if ( pending.fetch_sub( count ) == count )
+      {
+        completed.notify_all();
+      }
+    }
+  };
+
+  struct Job
+  {
+    JobContext* context;
+    size_t      first;
+    size_t      last;
+  };
+
+  struct alignas( 64 ) Worker
+  {
+    std::mutex      mutex;
+    std::deque<Job> jobs;
+    Arena           arena;
+
+    std::atomic<uint64_t> jobCount{};
+    std::atomic<uint64_t> stealCount{};
+    std::atomic<int64_t>  busyNanoseconds{};
+  };
+
+  struct CurrentWorker
+  {
+    const JobSystem* system;
+    size_t           index;
+  };
+
+  static inline thread_local CurrentWorker t_current{ nullptr, 0 };
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::vector<std::thread>             m_threads;
+
+  // Jobs in all deques, and workers asleep or about to sleep
+  std::atomic<size_t>     m_queued{};
+  std::atomic<size_t>     m_sleeping{};
+  std::mutex              m_sleepMutex;
+  std::condition_variable m_wake;
+  bool                    m_stopping{ false };
+
+  std::atomic<size_t>                   m_nextSubmit{};
+  std::chrono::steady_clock::time_point m_statsStart{ std::chrono::steady_clock::now() };
+
+  void push( size_t worker, const Job& job )
+  {
+    {
+      const std::lock_guard lock( m_workers[worker]->mutex );
+      m_workers[worker]->jobs.push_back( job );
+    }
+    // A worker going to sleep counts itself before checking m_queued, so either it sees this job or
+    // this sees it and wakes it up
+    m_queued.fetch_add( 1 );
+    if ( m_sleeping.load() != 0 )
+    {
+      const std::lock_guard lock( m_sleepMutex );
+      m_wake.notify_one();
+    }
+  }
+
+  // The newest job of the worker's own deque, or the oldest one of another's
+  std::optional<Job> take( size_t worker )
+  {
+    {
+      Worker&               own = *m_workers[worker];
+      const std::lock_guard lock( own.mutex );
+      if ( !own.jobs.empty() )
+      {
+        const Job job = own.jobs.back();
+        own.jobs.pop_back();
+        m_queued.fetch_sub( 1 );
+        return job;
+      }
+    }
+    for ( size_t offset = 1; offset < m_workers.size(); ++offset )
+    {
+      Worker&               victim = *m_workers[( worker + offset ) % m_workers.size()];
+      const std::lock_guard lock( victim.mutex );
+      if ( !victim.jobs.empty() )
+      {
+        const Job job = victim.jobs.front();
+        victim.jobs.pop_front();
+        m_queued.fetch_sub( 1 );
+        m_workers[worker]->stealCount.fetch_add( 1, std::memory_order_relaxed );
+        return job;
+      }
+    }
+    return std::nullopt;
+  }
+
+  void execute( size_t worker, Job job )
+  {
+    JobContext& context = *job.context;
+
+    // Split off upper halves for other workers to steal until one grain is left
+    while ( context.grain != 0 && job.last - job.first > context.grain )
+    {
+      const size_t middle = job.first + ( job.last - job.first ) / 2;
+      push( worker, Job{ &context, middle, job.last } );
+      job.last = middle;
+    }
+
+    // Once a job has failed the remaining ones are skipped
+    if ( !context.failed.load( std::memory_order_relaxed ) )
+    {
+      try
+      {
+        context.run( context, job.first, job.last );
+      } catch ( ... )
+      {
+        context.fail( std::current_exception() );
+      }
+    }
+    m_workers[worker]->jobCount.fetch_add( 1, std::memory_order_relaxed );
+    context.finish( job.last - job.first );
+  }
+
+  void workerLoop( size_t worker )
+  {
+    t_current = CurrentWorker{ this, worker };
+    while ( true )
+    {
+      if ( const auto job = take( worker ) )
+      {
+        const auto start = std::chrono::steady_clock::now();
+        execute( worker, *job );
+        const std::chrono::nanoseconds busy = std::chrono::steady_clock::now() - start;
+        m_workers[worker]->busyNanoseconds.fetch_add( busy.count(), std::memory_order_relaxed );
+        continue;
+      }
+
+      std::unique_lock lock( m_sleepMutex );
+      m_sleeping.fetch_add( 1 );
+      m_wake.wait( lock, [this]() { return m_stopping || m_queued.load() != 0; } );
+      m_sleeping.fetch_sub( 1 );
+      if ( m_stopping && m_queued.load() == 0 )
+      {
+        return;
+      }
+    }
+  }
+
+  // Workers start splittable jobs right away, since splitting hands the rest out, and queue others on
+  // their own deque; other threads spread their jobs over the workers
+  void submit( const Job& job )
+  {
+    const auto worker = currentWorker();
+    if ( worker && job.context->grain != 0 )
+    {
+      execute( *worker, job );
+    } else
+    {
+      push( worker ? *worker : m_nextSubmit.fetch_add( 1, std::memory_order_relaxed ) % m_workers.size(), job );
+    }
+  }
+
+  // Returns once every job of the context has finished, rethrowing the first exception among them
+  void wait( JobContext& context )
+  {
+    if ( const auto worker = currentWorker() )
+    {
+      while ( context.pending.load() != 0 )
+      {
+        if ( const auto job = take( *worker ) )
+        {
+          execute( *worker, *job );
+        } else
+        {
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    std::unique_lock lock( context.mutex );
+    context.completed.wait( lock, [&context]() { return context.pending.load() == 0; } );
+    context.failed = false;
+    if ( auto error = std::exchange( context.error, nullptr ) )
+    {
+      std::rethrow_exception( error );
+    }
+  }
+
+  // Joins the workers once the queued jobs have run
+  void stop()
+  {
+    {
+      const std::lock_guard lock( m_sleepMutex );
+      m_stopping = true;
+    }
+    m_wake.notify_all();
+    for ( auto& thread : m_threads )
+    {
+      thread.join();
+    }
+    m_threads.clear();
+  }
+
+  friend class TaskGroup;
+
+public:
+  // worker_count 0 for one worker per hardware thread
+  explicit JobSystem( size_t worker_count = 0 )
+  {
+    if ( worker_count == 0 )
+    {
+      worker_count = std::max( std::thread::hardware_concurrency(), 1U );
+    }
+    for ( size_t worker = 0; worker != worker_count; ++worker )
+    {
+      m_workers.push_back( std::make_unique<Worker>() );
+    }
+
+    try
+    {
+      for ( size_t worker = 0; worker != worker_count; ++worker )
+      {
+        m_threads.emplace_back( [this, worker]() { workerLoop( worker ); } );
+      }
+    } catch ( ... )
+    {
+      stop();
+      throw;
+    }
+  }
+
+  JobSystem( const JobSystem& )            = delete;
+  JobSystem& operator=( const JobSystem& ) = delete;
+
+  ~JobSystem() { stop(); }
+
+  [[nodiscard]] inline size_t workerCount() const { return m_workers.size(); }
+
+  // Index of the worker the calling thread is, std::nullopt for threads outside this system
+  [[nodiscard]] inline std::optional<size_t> currentWorker() const
+  {
+    return t_current.system == this ? std::optional{ t_current.index } : std::nullopt;
+  }
+
+  // Scratch arena of the worker running the calling job. Jobs that run nested jobs while they wait
+  // share it with them, so allocations belong in an ArenaScope that ends before the job does.
+  [[nodiscard]] inline Arena& arena() const
+  {
+    assert( currentWorker().has_value() );
+    return m_workers[t_current.index]->arena;
+  }
+
+  // Calls function( begin, end ) over pieces of [first, last) of at most grain indices, in parallel
+  template<typename Function>
+  void parallelFor( size_t first, size_t last, size_t grain, Function&& function )
+  {
+    grain = std::max( grain, size_t{ 1 } );
+    if ( last <= first + grain )
+    {
+      if ( first < last )
+      {
+        function( first, last );
+      }
+      return;
+    }
+
+    JobContext context;
+    context.run = []( JobContext& self, size_t begin, size_t end ) {
+      ( *static_cast<std::remove_reference_t<Function>*>( self.data ) )( begin, end );
+    };
+    context.data    = &function;
+    context.grain   = grain;
+    context.pending = last - first;
+    submit( Job{ &context, first, last } );
+    wait( context );
+  }
+
+  [[nodiscard]] std::vector<WorkerStats> stats() const
+  {
+    const auto elapsed = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - m_statsStart );
+
+    std::vector<WorkerStats> result;
+    for ( const auto& worker : m_workers )
+    {
+      WorkerStats stats;
+      stats.jobs        = worker->jobCount.load( std::memory_order_relaxed );
+      stats.steals      = worker->stealCount.load( std::memory_order_relaxed );
+      stats.busy        = std::chrono::nanoseconds( worker->busyNanoseconds.load( std::memory_order_relaxed ) );
+      stats.utilization = elapsed.count() > 0.0 ? static_cast<double>( stats.busy.count() ) / elapsed.count() : 0.0;
+      result.push_back( stats );
+    }
+    return result;
+  }
+
+  void resetStats()
+  {
+    for ( auto& worker : m_workers )
+    {
+      worker->jobCount        = 0;
+      worker->stealCount      = 0;
+      worker->busyNanoseconds = 0;
+    }
+    m_statsStart = std::chrono::steady_clock::now();
+  }
+};
+
+// Shared by the library's parallel algorithms unless their options name another system
+inline JobSystem& defaultJobSystem()
+{
+  static JobSystem system;
+  return system;
+}
+
+// Tasks run on a job system and joined with wait(). Tasks may add further tasks to their group. The
+// slots of tasks that have started are reused, so a group that keeps running tasks, such as the
+// resumptions of a Pipeline, needs memory only for the tasks queued at the same time.
+class TaskGroup
+{
+  JobSystem&                        m_system;
+  JobSystem::JobContext             m_context;
+  std::mutex                        m_mutex;
+  std::deque<std::function<void()>> m_tasks;
+  std::vector<size_t>               m_freeTasks;
+
+public:
+  explicit TaskGroup( JobSystem& system = defaultJobSystem() ) : m_system( system )
+  {
+    m_context.run = []( JobSystem::JobContext& self, size_t task, size_t /*end*/ ) {
+      auto&                 group = *static_cast<TaskGroup*>( self.data );
+      std::function<void()> function;
+      {
+        const std::lock_guard lock( group.m_mutex );
+        function = std::move( group.m_tasks[task] );
+        group.m_freeTasks.push_back( task );
+      }
+      function();
+    };
+    m_context.data = this;
+  }
+
+  TaskGroup( const TaskGroup& )            = delete;
+  TaskGroup& operator=( const TaskGroup& ) = delete;
+
+  // Waits for the tasks, dropping their exceptions
+  ~TaskGroup()
+  {
+    try
+    {
+      wait();
+    } catch ( ... )
+    {
+    }
+  }
+
+  [[nodiscard]] inline JobSystem& jobSystem() const { return m_system; }
+
+  template<typename Function>
+  void run( Function&& function )
+  {
+    size_t task;
+    {
+      const std::lock_guard lock( m_mutex );
+      if ( m_freeTasks.empty() )
+      {
+        task = m_tasks.size();
+        m_tasks.emplace_back( std::forward<Function>( function ) );
+      } else
+      {
+        task = m_freeTasks.back();
+        m_freeTasks.pop_back();
+        m_tasks[task] = std::forward<Function>( function );
+      }
+    }
+    m_context.pending.fetch_add( 1 );
+    m_system.submit( JobSystem::Job{ &m_context, task, task + 1 } );
+  }
+
+  // Runs or waits for every task added so far, rethrowing the first exception among them. The group
+  // can be reused afterwards.
+  void wait() { m_system.wait( m_context ); }
+};
+
+} // namespace Mirage::Math
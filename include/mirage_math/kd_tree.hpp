@@ -0,0 +1,332 @@
+#pragma once
+
+#include "job_system.hpp"
+#include "morton.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Mirage::Math {
+
+struct Neighbor
+{
+  uint32_t index{};
+  float    distanceSquared{ std::numeric_limits<float>::infinity() };
+};
+
+struct KDTreeOptions
+{
+  // Ranges of at most this many points are scanned linearly instead of being split further
+  uint32_t leafSize = 8;
+  // Builds and batched queries over at least this many elements are split into jobs
+  size_t parallelThreshold = size_t{ 1 } << 15;
+  // Queries per job of batched queries; consecutive queries are close in Morton order and share work
+  size_t grainSize = size_t{ 1 } << 12;
+  // nullptr for defaultJobSystem(); must outlive the tree
+  JobSystem* jobSystem{};
+};
+
+// Implicit k-d tree: the points are reordered so that the node of a range [first, last) is the
+// median element at its middle, with the left subtree stored before it and the right one after.
+// Children are found from the range alone, so the tree needs no pointers or node records beyond
+// one split axis per point. Neighbor indices refer to the input of the constructor.
+class KDTree
+{
+  KDTreeOptions         m_options;
+  std::vector<Point3>   m_points;
+  std::vector<uint32_t> m_indices;
+  std::vector<uint8_t>  m_axes;
+
+  struct BuildPoint
+  {
+    Point3   point;
+    uint32_t index;
+  };
+
+  void buildRange( std::span<BuildPoint> points, size_t first )
+  {
+    if ( points.size() <= m_options.leafSize )
+    {
+      return;
+    }
+
+    // Split along the axis of largest spread
+    Point3 min = points.front().point;
+    Point3 max = points.front().point;
+    for ( const auto& point : points )
+    {
+      min = Mirage::Math::min( min, point.point );
+      max = Mirage::Math::max( max, point.point );
+    }
+    const Vec3   spread = max - min;
+    const size_t axis =
+      spread.x() >= spread.y() ? ( spread.x() >= spread.z() ? 0 : 2 ) : ( spread.y() >= spread.z() ? 1 : 2 );
+
+    const size_t middle = points.size() / 2;
+    std::nth_element( points.begin(),
+      points.begin() + static_cast<ptrdiff_t>( middle ),
+      points.end(),
+      [axis]( const auto& a, const auto& b ) { return a.point[axis] < b.point[axis]; } );
+    m_axes[first + middle] = static_cast<uint8_t>( axis );
+
+    const auto left  = points.first( middle );
+    const auto right = points.subspan( middle + 1 );
+    if ( points.size() >= m_options.parallelThreshold )
+    {
+      TaskGroup group( jobSystem() );
+      group.run( [this, left, first]() { buildRange( left, first ); } );
+      buildRange( right, first + middle + 1 );
+      group.wait();
+    } else
+    {
+      buildRange( left, first );
+      buildRange( right, first + middle + 1 );
+    }
+  }
+
+  // Bounded max-heap of the best candidates so far; the root is the current worst
+  struct NeighborHeap
+  {
+    std::span<Neighbor> neighbors;
+    size_t              count{};
+    float               maxDistanceSquared{};
+
+    [[nodiscard]] inline float bound() const
+    {
+      return count == neighbors.size() ? neighbors.front().distanceSquared : maxDistanceSquared;
+    }
+
+    inline void push( uint32_t index, float distance_squared )
+    {
+      const auto closer = []( const Neighbor& a, const Neighbor& b ) { return a.distanceSquared < b.distanceSquared; };
+      if ( count == neighbors.size() )
+      {
+        std::pop_heap( neighbors.begin(), neighbors.end(), closer );
+        neighbors.back() = Neighbor{ index, distance_squared };
+        std::push_heap( neighbors.begin(), neighbors.end(), closer );
+      } else
+      {
+        neighbors[count++] = Neighbor{ index, distance_squared };
+        std::push_heap( neighbors.begin(), neighbors.begin() + static_cast<ptrdiff_t>( count ), closer );
+      }
+    }
+  };
+
+  // Visits every point that can lie within bound() of query; bound() may shrink during the search
+  template<typename Visitor, typename Bound>
+  void searchRange( size_t first, size_t last, const Point3& query, Visitor&& visitor, Bound&& bound ) const
+  {
+    if ( last - first <= m_options.leafSize )
+    {
+      for ( size_t i = first; i != last; ++i )
+      {
+        visitor( i, magnitudeSquared( m_points[i] - query ) );
+      }
+      return;
+    }
+
+    const size_t middle     = first + ( last - first ) / 2;
+    const size_t axis       = m_axes[middle];
+    const float  difference = query[axis] - m_points[middle][axis];
+    visitor( middle, magnitudeSquared( m_points[middle] - query ) );
+
+    // Descend towards the query first, so the far side is usually pruned by the tightened bound
+    if ( difference < 0.0F )
+    {
+      searchRange( first, middle, query, visitor, bound );
+      if ( difference * difference <= bound() )
+      {
+        searchRange( middle + 1, last, query, visitor, bound );
+      }
+    } else
+    {
+      searchRange( middle + 1, last, query, visitor, bound );
+      if ( difference * difference <= bound() )
+      {
+        searchRange( first, middle, query, visitor, bound );
+      }
+    }
+  }
+
+  void searchNearest( const Point3& query, NeighborHeap& heap ) const
+  {
+    searchRange(
+      0,
+      m_points.size(),
+      query,
+      [&heap]( size_t i, float distance_squared ) {
+        if ( distance_squared < heap.bound() )
+        {
+          heap.push( static_cast<uint32_t>( i ), distance_squared );
+        }
+      },
+      [&heap]() { return heap.bound(); } );
+  }
+
+  // Converts positions in the reordered arrays back to input indices, nearest first
+  size_t finish( NeighborHeap& heap ) const
+  {
+    const auto neighbors = heap.neighbors.first( heap.count );
+    std::sort_heap( neighbors.begin(), neighbors.end(), []( const Neighbor& a, const Neighbor& b ) {
+      return a.distanceSquared < b.distanceSquared;
+    } );
+    for ( auto& neighbor : neighbors )
+    {
+      neighbor.index = m_indices[neighbor.index];
+    }
+    return heap.count;
+  }
+
+  [[nodiscard]] inline JobSystem& jobSystem() const
+  {
+    return m_options.jobSystem != nullptr ? *m_options.jobSystem : defaultJobSystem();
+  }
+
+  template<typename Function>
+  void forEachChunk( size_t count, Function&& function ) const
+  {
+    if ( count < m_options.parallelThreshold )
+    {
+      function( size_t{ 0 }, count );
+      return;
+    }
+    jobSystem().parallelFor( 0, count, m_options.grainSize, function );
+  }
+
+public:
+  KDTree() = default;
+  explicit KDTree( std::span<const Point3> points, const KDTreeOptions& options = {} ) : m_options( options )
+  {
+    assert( m_options.leafSize >= 1 );
+
+    std::vector<BuildPoint> build_points( points.size() );
+    for ( size_t i = 0; i != points.size(); ++i )
+    {
+      build_points[i] = BuildPoint{ points[i], static_cast<uint32_t>( i ) };
+    }
+
+    m_axes.resize( points.size() );
+    buildRange( build_points, 0 );
+
+    m_points.resize( points.size() );
+    m_indices.resize( points.size() );
+    for ( size_t i = 0; i != points.size(); ++i )
+    {
+      m_points[i]  = build_points[i].point;
+      m_indices[i] = build_points[i].index;
+    }
+  }
+
+  [[nodiscard]] inline size_t size() const { return m_points.size(); }
+  [[nodiscard]] inline bool   isEmpty() const { return m_points.empty(); }
+
+  [[nodiscard]] std::optional<Neighbor> findNearest( const Point3& query ) const
+  {
+    Neighbor nearest;
+    return findNearest( query, std::span{ &nearest, 1 } ) != 0 ? std::optional{ nearest } : std::nullopt;
+  }
+
+  // Exact k nearest neighbors with k = neighbors.size(), nearest first, optionally limited to
+  // max_distance. Returns how many were found.
+  size_t findNearest( const Point3& query,
+    std::span<Neighbor>             neighbors,
+    float max_distance = std::numeric_limits<float>::infinity() ) const
+  {
+    if ( neighbors.empty() || m_points.empty() )
+    {
+      return 0;
+    }
+
+    NeighborHeap heap{ neighbors, 0, max_distance * max_distance };
+    searchNearest( query, heap );
+    return finish( heap );
+  }
+
+  // Calls callback( index, distance_squared ) for every point within radius of query
+  template<typename Callback>
+  void queryRadius( const Point3& query, float radius, Callback&& callback ) const
+  {
+    if ( m_points.empty() )
+    {
+      return;
+    }
+
+    const float radius_squared = radius * radius;
+    searchRange(
+      0,
+      m_points.size(),
+      query,
+      [&]( size_t i, float distance_squared ) {
+        if ( distance_squared <= radius_squared )
+        {
+          callback( m_indices[i], distance_squared );
+        }
+      },
+      [radius_squared]() { return radius_squared; } );
+  }
+
+  // Batched k-NN: neighbors holds k results per query, query i writing to [i * k, i * k + k).
+  // Queries are processed in Morton order, and the neighbors of the previous query bound the search
+  // of the next one: nearby queries share most neighbors, so the search starts with a tight radius
+  // instead of an infinite one and prunes most of the tree from the first node on. Queries are split
+  // across threads when there are enough of them. Returns the total number of neighbors found; rows
+  // with fewer than k results are padded with entries of infinite distance.
+  size_t findNearest( std::span<const Point3> queries, size_t k, std::span<Neighbor> neighbors ) const
+  {
+    assert( neighbors.size() >= queries.size() * k );
+    if ( k == 0 || queries.empty() )
+    {
+      return 0;
+    }
+
+    const std::vector<uint32_t> order = makeMortonOrder( queries, { .jobSystem = &jobSystem() } );
+    std::atomic<size_t>         found{ 0 };
+    forEachChunk( queries.size(), [&]( size_t first, size_t last ) {
+      // Reordered positions of the previous query's neighbors
+      std::vector<uint32_t> previous;
+      size_t                chunk_found = 0;
+      for ( size_t position = first; position != last; ++position )
+      {
+        const uint32_t      query_index = order[position];
+        const Point3&       query       = queries[query_index];
+        std::span<Neighbor> row         = neighbors.subspan( query_index * k, k );
+
+        // The farthest previous neighbor bounds the search: at least k points lie within that distance
+        float bound = std::numeric_limits<float>::infinity();
+        if ( previous.size() == k )
+        {
+          bound = 0.0F;
+          for ( const uint32_t candidate : previous )
+          {
+            bound = std::max( bound, magnitudeSquared( m_points[candidate] - query ) );
+          }
+          bound = std::nextafter( bound, std::numeric_limits<float>::infinity() );
+        }
+
+        NeighborHeap heap{ row, 0, bound };
+        searchNearest( query, heap );
+
+        previous.clear();
+        for ( size_t i = 0; i != heap.count; ++i )
+        {
+          previous.push_back( row[i].index );
+        }
+        std::fill( row.begin() + static_cast<ptrdiff_t>( heap.count ), row.end(), Neighbor{} );
+        chunk_found += finish( heap );
+      }
+      found += chunk_found;
+    } );
+    return found.load();
+  }
+};
+
+} // namespace Mirage::Math
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "bvh.hpp"
+#include "morton.hpp"
+#include "radix_sort.hpp"
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Linear BVH (Lauterbach et al., Karras): primitives are sorted by the Morton code of their centroid
+// and every node splits its range where the highest differing code bit changes. There is no cost
+// evaluation, so the build is a radix sort plus a binary search per node; the resulting trees trace
+// slower than binned SAH ones but can be rebuilt every frame for dynamic scenes. Trees are at most 30
+// levels of code bits deep plus the median splits of equal codes, well within BVH::MAX_DEPTH.
+class LinearBVHBuilder
+{
+  struct BuildState
+  {
+    std::vector<uint32_t>  codes;
+    std::vector<uint32_t>  order;
+    std::vector<AABB>      sortedBounds;
+    std::span<BVHNode>     nodes;
+    std::atomic<uint32_t>  nodeCount;
+    const BVHBuildOptions& options;
+    JobSystem&             jobs;
+  };
+
+  // Last index of the left half of [first, last]: the highest position whose code still shares
+  // more leading bits with codes[first] than codes[last] does
+  static uint32_t findSplit( std::span<const uint32_t> codes, uint32_t first, uint32_t last )
+  {
+    const uint32_t first_code = codes[first];
+    const uint32_t last_code  = codes[last];
+    if ( first_code == last_code )
+    {
+      return first + ( last - first ) / 2;
+    }
+
+    const int prefix = std::countl_zero( first_code ^ last_code );
+    uint32_t  split  = first;
+    uint32_t  step   = last - first;
+    do
+    {
+      step                     = ( step + 1 ) / 2;
+      const uint32_t candidate = split + step;
+      if ( candidate < last && std::countl_zero( first_code ^ codes[candidate] ) > prefix )
+      {
+        split = candidate;
+      }
+    } while ( step > 1 );
+    return split;
+  }
+
+  static AABB buildNode( BuildState& state, uint32_t node_index, uint32_t first, uint32_t count )
+  {
+    BVHNode& node = state.nodes[node_index];
+    if ( count <= 1 || count <= state.options.maxLeafSize )
+    {
+      AABB bounds = AABB::empty();
+      for ( uint32_t i = first; i != first + count; ++i )
+      {
+        bounds.expandInPlace( state.sortedBounds[i] );
+      }
+      node.setBounds( bounds );
+      node.leftFirst = first;
+      node.count     = count;
+      return bounds;
+    }
+
+    const uint32_t left_count = findSplit( state.codes, first, first + count - 1 ) - first + 1;
+    const uint32_t left_child = state.nodeCount.fetch_add( 2 );
+    node.leftFirst            = left_child;
+    node.count                = 0;
+
+    AABB bounds;
+    if ( count >= state.options.parallelThreshold )
+    {
+      AABB      left;
+      TaskGroup group( state.jobs );
+      group.run( [&state, &left, left_child, first, left_count]() {
+        left = buildNode( state, left_child, first, left_count );
+      } );
+      const AABB right = buildNode( state, left_child + 1, first + left_count, count - left_count );
+      group.wait();
+      bounds = merge( left, right );
+    } else
+    {
+      const AABB left = buildNode( state, left_child, first, left_count );
+      bounds          = merge( left, buildNode( state, left_child + 1, first + left_count, count - left_count ) );
+    }
+    node.setBounds( bounds );
+    return bounds;
+  }
+
+public:
+  // Primitive ids in the leaves are indices into primitive_bounds, as with BVH::build
+  static BVH build( std::span<const AABB> primitive_bounds, const BVHBuildOptions& options = {} )
+  {
+    assert( options.maxLeafSize >= 1 );
+
+    if ( primitive_bounds.empty() )
+    {
+      return BVH{};
+    }
+
+    const auto count = static_cast<uint32_t>( primitive_bounds.size() );
+
+    AABB centroid_bounds = AABB::empty();
+    for ( const auto& box : primitive_bounds )
+    {
+      centroid_bounds.expandInPlace( box.center() );
+    }
+
+    std::vector<BVHNode> nodes( size_t{ count } * 2 - 1 );
+    BuildState           state{ std::vector<uint32_t>( count ),
+      std::vector<uint32_t>( count ),
+      {},
+      nodes,
+      1U,
+      options,
+      options.jobSystem != nullptr ? *options.jobSystem : defaultJobSystem() };
+
+    const MortonQuantizer quantizer{ centroid_bounds, MORTON30_AXIS_CELLS };
+    for ( uint32_t i = 0; i != count; ++i )
+    {
+      const Point3 centroid = primitive_bounds[i].center();
+      state.codes[i]        = encodeMorton30( quantizer( centroid ) );
+    }
+    std::iota( state.order.begin(), state.order.end(), 0U );
+    radixSort( state.codes, state.order, { .jobSystem = &state.jobs } );
+
+    state.sortedBounds.resize( count );
+    for ( uint32_t i = 0; i != count; ++i )
+    {
+      state.sortedBounds[i] = primitive_bounds[state.order[i]];
+    }
+
+    buildNode( state, 0, 0, count );
+    nodes.resize( state.nodeCount.load() );
+    return BVH{ std::move( nodes ), std::move( state.order ) };
+  }
+};
+
+} // namespace Mirage::Math
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "batch.hpp"
 #include "point.hpp"
 #include "vec.hpp"
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <span>
 
 namespace Mirage::Math {
 
@@ -16,6 +21,36 @@ public:
 
   [[nodiscard]] inline const Vec3&   vector() const { return m_line; }
   [[nodiscard]] inline const Point3& point() const { return m_point; }
+
+  [[nodiscard]] inline Point3 at( float t ) const { return m_point + t * m_line; }
+};
+
+// Parameters of the closest pair of points, point_a + t1 * vector_a and point_b + t2 * vector_b
+struct ClosestParameters
+{
+  float t1{};
+  float t2{};
+};
+
+// Lines for the batched queries, one stream per component
+struct SoALine
+{
+  SoAVec3 point;
+  SoAVec3 vector;
+
+  [[nodiscard]] inline size_t size() const
+  {
+    assert( point.size() == vector.size() );
+    return point.size();
+  }
+
+  [[nodiscard]] inline Line operator[]( size_t i ) const
+  {
+    return Line{
+      Point3{ point.x[i], point.y[i], point.z[i] },
+      Vec3{ vector.x[i], vector.y[i], vector.z[i] }
+    };
+  }
 };
 
 inline float distance( const Point3& point, const Line& line )
@@ -24,7 +59,9 @@ inline float distance( const Point3& point, const Line& line )
   return std::sqrt( dot( cross_vec, cross_vec ) / dot( line.vector(), line.vector() ) );
 }
 
-inline float distance( const Line& line_a, const Line& line_b )
+// Parallel lines have no unique closest pair. The kernel then still fills parameters, with t2 = 0
+// and t1 locating the point of line_a closest to line_b.point(), and returns false.
+inline bool closestParameters( const Line& line_a, const Line& line_b, ClosestParameters& parameters )
 {
   Vec3 ab = line_b.point() - line_a.point();
 
@@ -32,22 +69,52 @@ inline float distance( const Line& line_a, const Line& line_b )
   float v22 = dot( line_b.vector(), line_b.vector() );
   float v12 = dot( line_a.vector(), line_b.vector() );
 
-  float det = ( v12 * v12 - v11 * v22 );
-  if ( std::fabs( det ) > std::numeric_limits<float>::min() )
-  {
-    det = 1.0F / det;
+  float      det   = ( v12 * v12 - v11 * v22 );
+  const bool valid = std::fabs( det ) > std::numeric_limits<float>::min();
+  const auto skew  = static_cast<float>( valid );
+  det              = 1.0F / safeDivisor( det, valid );
 
-    float dot_v1ab = dot( line_a.vector(), ab );
-    float dot_v2ab = dot( line_b.vector(), ab );
+  float dot_v1ab = dot( line_a.vector(), ab );
+  float dot_v2ab = dot( line_b.vector(), ab );
 
-    float t1 = ( v12 * dot_v2ab - v22 * dot_v1ab ) * det;
-    float t2 = ( v11 * dot_v2ab - v12 * dot_v1ab ) * det;
+  float t1      = ( v12 * dot_v2ab - v22 * dot_v1ab ) * det;
+  float t2      = ( v11 * dot_v2ab - v12 * dot_v1ab ) * det;
+  float t1_flat = dot_v1ab / safeDivisor( v11, v11 > std::numeric_limits<float>::min() );
 
-    return magnitude( ( line_b.point() + t2 * line_b.vector() ) - ( line_a.point() + t1 * line_a.vector() ) );
-  }
+  parameters = ClosestParameters{ skew * t1 + ( 1.0F - skew ) * t1_flat, skew * t2 };
+  return valid;
+}
+
+inline std::optional<ClosestParameters> getClosestParameters( const Line& line_a, const Line& line_b )
+{
+  ClosestParameters parameters;
+  return closestParameters( line_a, line_b, parameters ) ? std::optional{ parameters } : std::nullopt;
+}
+
+inline float distance( const Line& line_a, const Line& line_b )
+{
+  // For parallel lines this is the distance between line_a and point_b
+  ClosestParameters parameters;
+  closestParameters( line_a, line_b, parameters );
+  return magnitude( line_b.at( parameters.t2 ) - line_a.at( parameters.t1 ) );
+}
 
-  // Lines are parallel, so just calculate the distance between line_a and point_b
-  return distance( line_b.point(), line_a );
+// Pairwise closest parameters of two line streams. The bit of a parallel pair is cleared in skew and
+// its parameters follow the scalar fallback. Returns the number of skew pairs.
+inline size_t getClosestParameters( const SoALine& lines_a,
+  const SoALine&                                   lines_b,
+  std::span<float>                                 t1,
+  std::span<float>                                 t2,
+  std::span<uint64_t>                              skew )
+{
+  assert( lines_a.size() == lines_b.size() && t1.size() >= lines_a.size() && t2.size() >= lines_a.size() );
+  return fillMask( lines_a.size(), skew, [&]( size_t i ) {
+    ClosestParameters parameters;
+    const bool        valid = closestParameters( lines_a[i], lines_b[i], parameters );
+    t1[i]                   = parameters.t1;
+    t2[i]                   = parameters.t2;
+    return valid;
+  } );
 }
 
 } // namespace Mirage::Math
@@ -55,6 +55,73 @@ inline Mat3 inverse( const Mat3& mat )
   return Mat3{ b_cross_c, c_cross_a, a_cross_b } / scalar_cross;
 }
 
+struct SymmetricEigen
+{
+  Vec3 values;
+  Mat3 vectors; // Column i is the eigenvector of values[i]
+};
+
+// Cyclic Jacobi rotations; converges in a handful of sweeps for 3x3 symmetric input
+inline SymmetricEigen eigenDecomposition( const Mat3& symmetric )
+{
+  constexpr int   max_sweeps = 32;
+  constexpr float tolerance  = 1e-12F;
+
+  Mat3 a = symmetric;
+  Mat3 v = Mat3::identity();
+
+  for ( int sweep = 0; sweep != max_sweeps; ++sweep )
+  {
+    const float off_diagonal = a( 0, 1 ) * a( 0, 1 ) + a( 0, 2 ) * a( 0, 2 ) + a( 1, 2 ) * a( 1, 2 );
+    const float diagonal     = a( 0, 0 ) * a( 0, 0 ) + a( 1, 1 ) * a( 1, 1 ) + a( 2, 2 ) * a( 2, 2 );
+    if ( off_diagonal <= tolerance * diagonal || off_diagonal == 0.0F )
+    {
+      break;
+    }
+
+    for ( size_t p = 0; p != 2; ++p )
+    {
+      for ( size_t q = p + 1; q != 3; ++q )
+      {
+        const float apq = a( p, q );
+        if ( std::fabs( apq ) <= FLOAT_MIN )
+        {
+          continue;
+        }
+
+        const float theta = ( a( q, q ) - a( p, p ) ) / ( 2.0F * apq );
+        const float t     = std::copysign( 1.0F, theta ) / ( std::fabs( theta ) + std::sqrt( theta * theta + 1.0F ) );
+        const float c     = 1.0F / std::sqrt( t * t + 1.0F );
+        const float s     = t * c;
+
+        for ( size_t k = 0; k != 3; ++k )
+        {
+          const float akp = a( k, p );
+          const float akq = a( k, q );
+          a( k, p )       = c * akp - s * akq;
+          a( k, q )       = s * akp + c * akq;
+        }
+        for ( size_t k = 0; k != 3; ++k )
+        {
+          const float apk = a( p, k );
+          const float aqk = a( q, k );
+          a( p, k )       = c * apk - s * aqk;
+          a( q, k )       = s * apk + c * aqk;
+        }
+        for ( size_t k = 0; k != 3; ++k )
+        {
+          const float vkp = v( k, p );
+          const float vkq = v( k, q );
+          v( k, p )       = c * vkp - s * vkq;
+          v( k, q )       = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+
+  return SymmetricEigen{ Vec3{ a( 0, 0 ), a( 1, 1 ), a( 2, 2 ) }, v };
+}
+
 inline Mat3 makeRotationX( float t )
 {
   auto c = std::cos( t );
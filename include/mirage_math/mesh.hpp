@@ -0,0 +1,253 @@
+#pragma once
+
+#include "constants.hpp"
+#include "job_system.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Vertex attributes of indexed triangle lists. Per-vertex results are gathered from the triangles
+// around each vertex rather than scattered from each triangle into its vertices, so threads write
+// disjoint outputs without atomics or per-thread copies, and every vertex sums its triangles in the
+// same order whatever the thread count.
+
+struct MeshOptions
+{
+  // Meshes with at least this many vertices or triangles are processed across threads
+  size_t parallelThreshold = size_t{ 1 } << 15;
+  // Vertices or triangles per job
+  size_t grainSize = size_t{ 1 } << 12;
+  // nullptr for defaultJobSystem()
+  JobSystem* jobSystem{};
+};
+
+// Corners of a triangle list grouped by vertex: the corners of vertex v are
+// corners[offsets[v]] .. corners[offsets[v + 1]], in ascending order. A corner is a position in the
+// index array, so its triangle is corner / 3. Depends on the indices only; build it once and reuse it
+// for every frame of a deforming mesh.
+struct VertexAdjacency
+{
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> corners;
+
+  [[nodiscard]] inline size_t vertexCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+  [[nodiscard]] inline std::span<const uint32_t> cornersOf( size_t vertex ) const
+  {
+    assert( vertex < vertexCount() );
+    return std::span{ corners }.subspan( offsets[vertex], offsets[vertex + 1] - offsets[vertex] );
+  }
+};
+
+inline VertexAdjacency makeVertexAdjacency( std::span<const uint32_t> indices, size_t vertex_count )
+{
+  assert( indices.size() % 3 == 0 );
+
+  VertexAdjacency adjacency;
+  adjacency.offsets.assign( vertex_count + 1, 0 );
+  for ( auto index : indices )
+  {
+    assert( index < vertex_count );
+    ++adjacency.offsets[index + 1];
+  }
+  for ( size_t vertex = 0; vertex != vertex_count; ++vertex )
+  {
+    adjacency.offsets[vertex + 1] += adjacency.offsets[vertex];
+  }
+
+  // Filling in index order leaves every vertex's corners sorted
+  std::vector<uint32_t> cursors( adjacency.offsets.begin(), adjacency.offsets.end() - 1 );
+  adjacency.corners.resize( indices.size() );
+  for ( size_t corner = 0; corner != indices.size(); ++corner )
+  {
+    adjacency.corners[cursors[indices[corner]]++] = static_cast<uint32_t>( corner );
+  }
+  return adjacency;
+}
+
+// Calls function( first, last ) over chunks of [0, count), as jobs above the threshold
+template<typename Function>
+inline void forEachMeshChunk( size_t count, const MeshOptions& options, Function&& function )
+{
+  if ( count < options.parallelThreshold )
+  {
+    function( size_t{ 0 }, count );
+    return;
+  }
+
+  JobSystem& jobs = options.jobSystem != nullptr ? *options.jobSystem : defaultJobSystem();
+  jobs.parallelFor( 0, count, options.grainSize, function );
+}
+
+// Area-weighted vertex normals: the sum of the unnormalized cross products of the triangles around
+// each vertex, normalized. Vertices without triangles of non-zero area get a zero normal.
+inline void computeVertexNormals( std::span<const Point3> positions,
+  std::span<const uint32_t>                               indices,
+  const VertexAdjacency&                                  adjacency,
+  std::span<Vec3>                                         normals,
+  const MeshOptions&                                      options = {} )
+{
+  assert( indices.size() % 3 == 0 );
+  assert( adjacency.vertexCount() == positions.size() && normals.size() >= positions.size() );
+
+  // Twice the triangle area along the triangle normal
+  std::vector<Vec3> face_normals( indices.size() / 3 );
+  forEachMeshChunk( face_normals.size(), options, [&]( size_t first, size_t last ) {
+    for ( size_t face = first; face != last; ++face )
+    {
+      const Point3& a    = positions[indices[face * 3]];
+      const Point3& b    = positions[indices[face * 3 + 1]];
+      const Point3& c    = positions[indices[face * 3 + 2]];
+      face_normals[face] = cross( b - a, c - a );
+    }
+  } );
+
+  forEachMeshChunk( positions.size(), options, [&]( size_t first, size_t last ) {
+    for ( size_t vertex = first; vertex != last; ++vertex )
+    {
+      Vec3 sum{ 0.0F, 0.0F, 0.0F };
+      for ( auto corner : adjacency.cornersOf( vertex ) )
+      {
+        sum = sum + face_normals[corner / 3];
+      }
+      const float length = magnitude( sum );
+      normals[vertex]    = length > FLOAT_MIN ? sum / length : Vec3{ 0.0F, 0.0F, 0.0F };
+    }
+  } );
+}
+
+inline void computeVertexNormals( std::span<const Point3> positions,
+  std::span<const uint32_t>                               indices,
+  std::span<Vec3>                                         normals,
+  const MeshOptions&                                      options = {} )
+{
+  computeVertexNormals( positions, indices, makeVertexAdjacency( indices, positions.size() ), normals, options );
+}
+
+// Tangent frames in the MikkTSpace convention: xyz is the unit tangent along increasing u,
+// orthogonal to the vertex normal, and w = +1 or -1 is the handedness, so that the bitangent is
+// w * cross( normal, tangent ). As in MikkTSpace, each triangle's texture-space tangent is projected
+// into the tangent plane of the vertex normal and weighted by the corner angle in that plane, and
+// triangles with mirrored texture coordinates are kept apart from the others. MikkTSpace splits a
+// vertex shared by both kinds; here the vertex takes the side with the larger total angle, which
+// matches whenever the mesh is already split at mirror seams, as exported meshes are. Triangles
+// with degenerate texture coordinates do not contribute; vertices left without a tangent get an
+// arbitrary one orthogonal to the normal. normals are expected to be unit length.
+inline void computeTangents( std::span<const Point3> positions,
+  std::span<const Vec3>                              normals,
+  std::span<const Vec2>                              uvs,
+  std::span<const uint32_t>                          indices,
+  const VertexAdjacency&                             adjacency,
+  std::span<Vec4>                                    tangents,
+  const MeshOptions&                                 options = {} )
+{
+  assert( indices.size() % 3 == 0 );
+  assert( normals.size() >= positions.size() && uvs.size() >= positions.size() );
+  assert( adjacency.vertexCount() == positions.size() && tangents.size() >= positions.size() );
+
+  // Unit dP/du of each triangle, with the sign of its texture-space area: +1, -1 for mirrored
+  // coordinates and 0 when degenerate
+  struct FaceTangent
+  {
+    Vec3  tangent;
+    float orientation;
+  };
+
+  std::vector<FaceTangent> face_tangents( indices.size() / 3 );
+  forEachMeshChunk( face_tangents.size(), options, [&]( size_t first, size_t last ) {
+    for ( size_t face = first; face != last; ++face )
+    {
+      const uint32_t i0 = indices[face * 3];
+      const uint32_t i1 = indices[face * 3 + 1];
+      const uint32_t i2 = indices[face * 3 + 2];
+
+      const Vec3  d1   = positions[i1] - positions[i0];
+      const Vec3  d2   = positions[i2] - positions[i0];
+      const Vec2  t1   = uvs[i1] - uvs[i0];
+      const Vec2  t2   = uvs[i2] - uvs[i0];
+      const float area = t1.x() * t2.y() - t1.y() * t2.x();
+
+      // dP/du scaled by the signed area, so the area only decides the direction
+      const Vec3  scaled = d1 * t2.y() - d2 * t1.y();
+      const float length = magnitude( scaled );
+      if ( area == 0.0F || length <= FLOAT_MIN )
+      {
+        face_tangents[face] = FaceTangent{ Vec3{ 0.0F, 0.0F, 0.0F }, 0.0F };
+        continue;
+      }
+      const float orientation = area > 0.0F ? 1.0F : -1.0F;
+      face_tangents[face]     = FaceTangent{ scaled * ( orientation / length ), orientation };
+    }
+  } );
+
+  const auto to_tangent_plane = []( const Vec3& vec, const Vec3& normal ) {
+    const Vec3  projected = vec - normal * dot( vec, normal );
+    const float length    = magnitude( projected );
+    return length > FLOAT_MIN ? projected / length : Vec3{ 0.0F, 0.0F, 0.0F };
+  };
+
+  forEachMeshChunk( positions.size(), options, [&]( size_t first, size_t last ) {
+    for ( size_t vertex = first; vertex != last; ++vertex )
+    {
+      const Vec3& normal = normals[vertex];
+
+      // Angle-weighted sums for regular and mirrored triangles
+      std::array<Vec3, 2>  sums{ Vec3{ 0.0F, 0.0F, 0.0F }, Vec3{ 0.0F, 0.0F, 0.0F } };
+      std::array<float, 2> weights{};
+      for ( auto corner : adjacency.cornersOf( vertex ) )
+      {
+        const FaceTangent& face = face_tangents[corner / 3];
+        if ( face.orientation == 0.0F )
+        {
+          continue;
+        }
+
+        const size_t base  = corner - corner % 3;
+        const Point3 next  = positions[indices[base + ( corner + 1 ) % 3]];
+        const Point3 prev  = positions[indices[base + ( corner + 2 ) % 3]];
+        const Vec3   e1    = to_tangent_plane( next - positions[vertex], normal );
+        const Vec3   e2    = to_tangent_plane( prev - positions[vertex], normal );
+        const float  angle = std::acos( std::clamp( dot( e1, e2 ), -1.0F, 1.0F ) );
+
+        const size_t side = face.orientation > 0.0F ? 0 : 1;
+        sums[side]        = sums[side] + to_tangent_plane( face.tangent, normal ) * angle;
+        weights[side] += angle;
+      }
+
+      const size_t side    = weights[0] >= weights[1] ? 0 : 1;
+      Vec3         tangent = to_tangent_plane( sums[side], normal );
+      if ( magnitudeSquared( tangent ) == 0.0F )
+      {
+        // Any direction in the tangent plane: cross the normal with its smallest axis
+        const Vec3 axis = std::abs( normal.x() ) <= std::abs( normal.y() )
+                            ? ( std::abs( normal.x() ) <= std::abs( normal.z() ) ? Vec3{ 1.0F, 0.0F, 0.0F }
+                                                                                  : Vec3{ 0.0F, 0.0F, 1.0F } )
+                            : ( std::abs( normal.y() ) <= std::abs( normal.z() ) ? Vec3{ 0.0F, 1.0F, 0.0F }
+                                                                                  : Vec3{ 0.0F, 0.0F, 1.0F } );
+        tangent         = to_tangent_plane( cross( normal, axis ), normal );
+      }
+      tangents[vertex] = Vec4{ tangent, side == 0 ? 1.0F : -1.0F };
+    }
+  } );
+}
+
+inline void computeTangents( std::span<const Point3> positions,
+  std::span<const Vec3>                              normals,
+  std::span<const Vec2>                              uvs,
+  std::span<const uint32_t>                          indices,
+  std::span<Vec4>                                    tangents,
+  const MeshOptions&                                 options = {} )
+{
+  computeTangents(
+    positions, normals, uvs, indices, makeVertexAdjacency( indices, positions.size() ), tangents, options );
+}
+
+} // namespace Mirage::Math
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "batch.hpp"
+#include "point.hpp"
+#include "radix_sort.hpp"
+#include "strided_span.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+namespace Mirage::Math {
+
+// Morton (Z-order) codes interleave the bits of three cell coordinates, x in the lowest bit.
+// The 30-bit codes hold 10 bits per axis and the 63-bit codes 21 bits per axis.
+constexpr uint32_t MORTON30_AXIS_CELLS = 1U << 10;
+constexpr uint32_t MORTON63_AXIS_CELLS = 1U << 21;
+
+// Spreads the low 10 bits of value so that two zero bits follow each one
+inline uint32_t expandMortonBits30( uint32_t value )
+{
+  value &= 0x000003FFU;
+  value = ( value | ( value << 16 ) ) & 0x030000FFU;
+  value = ( value | ( value << 8 ) ) & 0x0300F00FU;
+  value = ( value | ( value << 4 ) ) & 0x030C30C3U;
+  value = ( value | ( value << 2 ) ) & 0x09249249U;
+  return value;
+}
+
+inline uint32_t compactMortonBits30( uint32_t value )
+{
+  value &= 0x09249249U;
+  value = ( value ^ ( value >> 2 ) ) & 0x030C30C3U;
+  value = ( value ^ ( value >> 4 ) ) & 0x0300F00FU;
+  value = ( value ^ ( value >> 8 ) ) & 0x030000FFU;
+  value = ( value ^ ( value >> 16 ) ) & 0x000003FFU;
+  return value;
+}
+
+inline uint64_t expandMortonBits63( uint64_t value )
+{
+  value &= 0x00000000001FFFFFULL;
+  value = ( value | ( value << 32 ) ) & 0x001F00000000FFFFULL;
+  value = ( value | ( value << 16 ) ) & 0x001F0000FF0000FFULL;
+  value = ( value | ( value << 8 ) ) & 0x100F00F00F00F00FULL;
+  value = ( value | ( value << 4 ) ) & 0x10C30C30C30C30C3ULL;
+  value = ( value | ( value << 2 ) ) & 0x1249249249249249ULL;
+  return value;
+}
+
+inline uint64_t compactMortonBits63( uint64_t value )
+{
+  value &= 0x1249249249249249ULL;
+  value = ( value ^ ( value >> 2 ) ) & 0x10C30C30C30C30C3ULL;
+  value = ( value ^ ( value >> 4 ) ) & 0x100F00F00F00F00FULL;
+  value = ( value ^ ( value >> 8 ) ) & 0x001F0000FF0000FFULL;
+  value = ( value ^ ( value >> 16 ) ) & 0x001F00000000FFFFULL;
+  value = ( value ^ ( value >> 32 ) ) & 0x00000000001FFFFFULL;
+  return value;
+}
+
+// Cell coordinates must lie in [0, MORTON30_AXIS_CELLS) and [0, MORTON63_AXIS_CELLS) respectively.
+// With BMI2 the scalar codecs are a single pdep/pext per axis.
+inline uint32_t encodeMorton30( const IVec3& cell )
+{
+  assert( static_cast<uint32_t>( cell.x() ) < MORTON30_AXIS_CELLS );
+  assert( static_cast<uint32_t>( cell.y() ) < MORTON30_AXIS_CELLS );
+  assert( static_cast<uint32_t>( cell.z() ) < MORTON30_AXIS_CELLS );
+#ifdef __BMI2__
+  return _pdep_u32( static_cast<uint32_t>( cell.x() ), 0x09249249U )
+         | _pdep_u32( static_cast<uint32_t>( cell.y() ), 0x12492492U )
+         | _pdep_u32( static_cast<uint32_t>( cell.z() ), 0x24924924U );
+#else
+  return expandMortonBits30( static_cast<uint32_t>( cell.x() ) )
+         | ( expandMortonBits30( static_cast<uint32_t>( cell.y() ) ) << 1 )
+         | ( expandMortonBits30( static_cast<uint32_t>( cell.z() ) ) << 2 );
+#endif
+}
+
+inline IVec3 decodeMorton30( uint32_t code )
+{
+#ifdef __BMI2__
+  return IVec3{ static_cast<int>( _pext_u32( code, 0x09249249U ) ),
+    static_cast<int>( _pext_u32( code, 0x12492492U ) ),
+    static_cast<int>( _pext_u32( code, 0x24924924U ) ) };
+#else
+  return IVec3{ static_cast<int>( compactMortonBits30( code ) ),
+    static_cast<int>( compactMortonBits30( code >> 1 ) ),
+    static_cast<int>( compactMortonBits30( code >> 2 ) ) };
+#endif
+}
+
+inline uint64_t encodeMorton63( const IVec3& cell )
+{
+  assert( static_cast<uint32_t>( cell.x() ) < MORTON63_AXIS_CELLS );
+  assert( static_cast<uint32_t>( cell.y() ) < MORTON63_AXIS_CELLS );
+  assert( static_cast<uint32_t>( cell.z() ) < MORTON63_AXIS_CELLS );
+#ifdef __BMI2__
+  return _pdep_u64( static_cast<uint64_t>( cell.x() ), 0x1249249249249249ULL )
+         | _pdep_u64( static_cast<uint64_t>( cell.y() ), 0x2492492492492492ULL )
+         | _pdep_u64( static_cast<uint64_t>( cell.z() ), 0x4924924924924924ULL );
+#else
+  return expandMortonBits63( static_cast<uint64_t>( cell.x() ) )
+         | ( expandMortonBits63( static_cast<uint64_t>( cell.y() ) ) << 1 )
+         | ( expandMortonBits63( static_cast<uint64_t>( cell.z() ) ) << 2 );
+#endif
+}
+
+inline IVec3 decodeMorton63( uint64_t code )
+{
+#ifdef __BMI2__
+  return IVec3{ static_cast<int>( _pext_u64( code, 0x1249249249249249ULL ) ),
+    static_cast<int>( _pext_u64( code, 0x2492492492492492ULL ) ),
+    static_cast<int>( _pext_u64( code, 0x4924924924924924ULL ) ) };
+#else
+  return IVec3{ static_cast<int>( compactMortonBits63( code ) ),
+    static_cast<int>( compactMortonBits63( code >> 1 ) ),
+    static_cast<int>( compactMortonBits63( code >> 2 ) ) };
+#endif
+}
+
+// Maps points inside bounds onto a grid of axis_cells cells per axis; points outside are clamped
+class MortonQuantizer
+{
+  std::array<float, 3> m_min{};
+  std::array<float, 3> m_scale{};
+  float                m_maxCell{};
+
+public:
+  MortonQuantizer( const AABB& bounds, uint32_t axis_cells ) : m_maxCell( static_cast<float>( axis_cells - 1 ) )
+  {
+    for ( size_t axis = 0; axis != 3; ++axis )
+    {
+      const float extent = bounds.max()[axis] - bounds.min()[axis];
+      m_min[axis]        = bounds.min()[axis];
+      m_scale[axis]      = extent > FLOAT_MIN ? static_cast<float>( axis_cells ) / extent : 0.0F;
+    }
+  }
+
+  [[nodiscard]] inline uint32_t quantize( float value, size_t axis ) const
+  {
+    return static_cast<uint32_t>( std::clamp( ( value - m_min[axis] ) * m_scale[axis], 0.0F, m_maxCell ) );
+  }
+
+  [[nodiscard]] inline IVec3 operator()( float x, float y, float z ) const
+  {
+    return IVec3{ static_cast<int>( quantize( x, 0 ) ),
+      static_cast<int>( quantize( y, 1 ) ),
+      static_cast<int>( quantize( z, 2 ) ) };
+  }
+
+  [[nodiscard]] inline IVec3 operator()( const Point3& point ) const
+  {
+    return ( *this )( point.x(), point.y(), point.z() );
+  }
+};
+
+inline uint32_t encodeMorton30( const Point3& point, const AABB& bounds )
+{
+  return encodeMorton30( MortonQuantizer{ bounds, MORTON30_AXIS_CELLS }( point ) );
+}
+
+inline uint64_t encodeMorton63( const Point3& point, const AABB& bounds )
+{
+  return encodeMorton63( MortonQuantizer{ bounds, MORTON63_AXIS_CELLS }( point ) );
+}
+
+// Batched encoders. They use the shift-and-mask expansion even with BMI2: pdep has no vector form,
+// while the expansion is plain integer arithmetic the compiler can vectorize. Code is uint32_t for
+// 30-bit and uint64_t for 63-bit codes; point_at( i ) reads the i-th of count points.
+template<typename Code, typename PointAt>
+  requires( std::is_same_v<Code, uint32_t> || std::is_same_v<Code, uint64_t> )
+inline void encodeMortonBatch( size_t count, PointAt&& point_at, const AABB& bounds, std::span<Code> codes )
+{
+  constexpr bool WIDE   = std::is_same_v<Code, uint64_t>;
+  const auto     expand = []( Code value ) {
+    if constexpr ( WIDE )
+    {
+      return expandMortonBits63( value );
+    } else
+    {
+      return expandMortonBits30( value );
+    }
+  };
+
+  assert( codes.size() >= count );
+  const MortonQuantizer quantizer{ bounds, WIDE ? MORTON63_AXIS_CELLS : MORTON30_AXIS_CELLS };
+  for ( size_t i = 0; i != count; ++i )
+  {
+    const Point3 point = point_at( i );
+    codes[i]           = expand( quantizer.quantize( point.x(), 0 ) )
+                         | ( expand( quantizer.quantize( point.y(), 1 ) ) << 1 )
+                         | ( expand( quantizer.quantize( point.z(), 2 ) ) << 2 );
+  }
+}
+
+inline void encodeMorton30( std::span<const Point3> points, const AABB& bounds, std::span<uint32_t> codes )
+{
+  encodeMortonBatch( points.size(), [points]( size_t i ) { return points[i]; }, bounds, codes );
+}
+
+inline void encodeMorton30( StridedSpan<const Point3> points, const AABB& bounds, std::span<uint32_t> codes )
+{
+  encodeMortonBatch( points.size(), [points]( size_t i ) { return points[i]; }, bounds, codes );
+}
+
+inline void encodeMorton30( const SoAVec3& points, const AABB& bounds, std::span<uint32_t> codes )
+{
+  encodeMortonBatch(
+    points.size(), [&points]( size_t i ) { return Point3{ points.x[i], points.y[i], points.z[i] }; }, bounds, codes );
+}
+
+inline void encodeMorton63( std::span<const Point3> points, const AABB& bounds, std::span<uint64_t> codes )
+{
+  encodeMortonBatch( points.size(), [points]( size_t i ) { return points[i]; }, bounds, codes );
+}
+
+inline void encodeMorton63( StridedSpan<const Point3> points, const AABB& bounds, std::span<uint64_t> codes )
+{
+  encodeMortonBatch( points.size(), [points]( size_t i ) { return points[i]; }, bounds, codes );
+}
+
+inline void encodeMorton63( const SoAVec3& points, const AABB& bounds, std::span<uint64_t> codes )
+{
+  encodeMortonBatch(
+    points.size(), [&points]( size_t i ) { return Point3{ points.x[i], points.y[i], points.z[i] }; }, bounds, codes );
+}
+
+// Permutation that visits the points in Z-order, for reordering point data so that spatial
+// neighbors are also neighbors in memory. Ties keep their input order.
+inline std::vector<uint32_t> makeMortonOrder( std::span<const Point3> points, const RadixSortOptions& options = {} )
+{
+  std::vector<uint32_t> codes( points.size() );
+  std::vector<uint32_t> order( points.size() );
+  encodeMorton30( points, makeBoundingBox( points ), codes );
+  std::iota( order.begin(), order.end(), 0U );
+  radixSort( codes, order, options );
+  return order;
+}
+
+} // namespace Mirage::Math
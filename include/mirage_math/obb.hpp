@@ -0,0 +1,185 @@
+#pragma once
+
+#include "batch.hpp"
+#include "mat3.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <array>
+#include <cmath>
+#include <limits>
+#include <span>
+
+namespace Mirage::Math {
+
+class OBB
+{
+  Point3 m_center;
+  Mat3   m_axes{ Mat3::identity() };
+  Vec3   m_halfExtents;
+
+public:
+  OBB() = default;
+  OBB( const Point3& center, const Mat3& axes, const Vec3& half_extents )
+    : m_center( center ), m_axes( axes ), m_halfExtents( half_extents )
+  {}
+
+  [[nodiscard]] inline const Point3& center() const { return m_center; }
+  [[nodiscard]] inline const Mat3&   axes() const { return m_axes; }
+  [[nodiscard]] inline const Vec3&   axis( size_t i ) const { return m_axes[i]; }
+  [[nodiscard]] inline const Vec3&   halfExtents() const { return m_halfExtents; }
+};
+
+// Candidate boxes for the batched overlap tests; axes[i] holds the i-th local axis of every box
+struct SoAOBB
+{
+  SoAVec3                center;
+  std::array<SoAVec3, 3> axes;
+  SoAVec3                halfExtents;
+
+  [[nodiscard]] inline size_t size() const { return center.size(); }
+};
+
+inline bool contains( const OBB& box, const Point3& point )
+{
+  const Vec3 d = point - box.center();
+  return std::fabs( dot( d, box.axis( 0 ) ) ) <= box.halfExtents().x()
+         && std::fabs( dot( d, box.axis( 1 ) ) ) <= box.halfExtents().y()
+         && std::fabs( dot( d, box.axis( 2 ) ) ) <= box.halfExtents().z();
+}
+
+// Separating axis test over the 15 candidate axes (Gottschalk). All axes are evaluated without early
+// outs so the same code serves the scalar and the batched query.
+inline bool overlapsSeparatingAxes( const Point3& center_a,
+  const std::array<Vec3, 3>&                      axes_a,
+  const Vec3&                                     half_a,
+  const Point3&                                   center_b,
+  const std::array<Vec3, 3>&                      axes_b,
+  const Vec3&                                     half_b )
+{
+  // Padding keeps near-parallel edge pairs from producing a false separating cross axis
+  constexpr float padding = 1e-6F;
+
+  std::array<std::array<float, 3>, 3> r{};
+  std::array<std::array<float, 3>, 3> abs_r{};
+  for ( size_t i = 0; i != 3; ++i )
+  {
+    for ( size_t j = 0; j != 3; ++j )
+    {
+      r[i][j]     = dot( axes_a[i], axes_b[j] );
+      abs_r[i][j] = std::fabs( r[i][j] ) + padding;
+    }
+  }
+
+  const Vec3                 d = center_b - center_a;
+  const std::array<float, 3> t{ dot( d, axes_a[0] ), dot( d, axes_a[1] ), dot( d, axes_a[2] ) };
+
+  bool separated = false;
+  for ( size_t i = 0; i != 3; ++i )
+  {
+    const float ra = half_a[i];
+    const float rb = half_b[0] * abs_r[i][0] + half_b[1] * abs_r[i][1] + half_b[2] * abs_r[i][2];
+    separated |= std::fabs( t[i] ) > ra + rb;
+  }
+  for ( size_t j = 0; j != 3; ++j )
+  {
+    const float ra = half_a[0] * abs_r[0][j] + half_a[1] * abs_r[1][j] + half_a[2] * abs_r[2][j];
+    const float rb = half_b[j];
+    separated |= std::fabs( t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j] ) > ra + rb;
+  }
+  for ( size_t i = 0; i != 3; ++i )
+  {
+    const size_t i1 = ( i + 1 ) % 3;
+    const size_t i2 = ( i + 2 ) % 3;
+    for ( size_t j = 0; j != 3; ++j )
+    {
+      const size_t j1 = ( j + 1 ) % 3;
+      const size_t j2 = ( j + 2 ) % 3;
+      const float  ra = half_a[i1] * abs_r[i2][j] + half_a[i2] * abs_r[i1][j];
+      const float  rb = half_b[j1] * abs_r[i][j2] + half_b[j2] * abs_r[i][j1];
+      separated |= std::fabs( t[i2] * r[i1][j] - t[i1] * r[i2][j] ) > ra + rb;
+    }
+  }
+  return !separated;
+}
+
+inline bool overlaps( const OBB& a, const OBB& b )
+{
+  return overlapsSeparatingAxes( a.center(),
+    { a.axis( 0 ), a.axis( 1 ), a.axis( 2 ) },
+    a.halfExtents(),
+    b.center(),
+    { b.axis( 0 ), b.axis( 1 ), b.axis( 2 ) },
+    b.halfExtents() );
+}
+
+// Oriented box aligned with the principal axes of the point covariance
+inline OBB makeBoundingOBB( std::span<const Point3> points )
+{
+  if ( points.empty() )
+  {
+    return OBB{};
+  }
+
+  Vec3 mean{};
+  for ( const auto& point : points )
+  {
+    mean = mean + point;
+  }
+  mean /= static_cast<float>( points.size() );
+
+  float c00 = 0.0F;
+  float c01 = 0.0F;
+  float c02 = 0.0F;
+  float c11 = 0.0F;
+  float c12 = 0.0F;
+  float c22 = 0.0F;
+  for ( const auto& point : points )
+  {
+    const Vec3 d = point - mean;
+    c00 += d.x() * d.x();
+    c01 += d.x() * d.y();
+    c02 += d.x() * d.z();
+    c11 += d.y() * d.y();
+    c12 += d.y() * d.z();
+    c22 += d.z() * d.z();
+  }
+
+  Mat3 axes = eigenDecomposition( Mat3{ c00, c01, c02, c01, c11, c12, c02, c12, c22 } ).vectors;
+  if ( determinant( axes ) < 0.0F )
+  {
+    axes[2] = -axes[2];
+  }
+
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  Vec3            local_min{ inf, inf, inf };
+  Vec3            local_max{ -inf, -inf, -inf };
+  for ( const auto& point : points )
+  {
+    const Vec3 local{ dot( Vec3{ point }, axes[0] ), dot( Vec3{ point }, axes[1] ), dot( Vec3{ point }, axes[2] ) };
+    local_min = min( local_min, local );
+    local_max = max( local_max, local );
+  }
+
+  const Vec3   local_center = ( local_min + local_max ) * 0.5F;
+  const Point3 center{ axes[0] * local_center.x() + axes[1] * local_center.y() + axes[2] * local_center.z() };
+  return OBB{ center, axes, ( local_max - local_min ) * 0.5F };
+}
+
+// Tests one query against every candidate and writes one bit per candidate into mask.
+// Returns the number of overlapping candidates.
+inline size_t testOverlaps( const OBB& query, const SoAOBB& candidates, std::span<uint64_t> mask )
+{
+  const std::array<Vec3, 3> query_axes{ query.axis( 0 ), query.axis( 1 ), query.axis( 2 ) };
+
+  return fillMask( candidates.size(), mask, [&]( size_t i ) {
+    const auto load = [i]( const SoAVec3& soa ) { return Vec3{ soa.x[i], soa.y[i], soa.z[i] }; };
+    return overlapsSeparatingAxes( query.center(),
+      query_axes,
+      query.halfExtents(),
+      Point3{ load( candidates.center ) },
+      { load( candidates.axes[0] ), load( candidates.axes[1] ), load( candidates.axes[2] ) },
+      load( candidates.halfExtents ) );
+  } );
+}
+
+} // namespace Mirage::Math
@@ -0,0 +1,362 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "morton.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace Mirage::Math {
+
+enum class Containment
+{
+  OUTSIDE,
+  INTERSECTING,
+  INSIDE
+};
+
+// Classifies a box against a convex volume given as planes whose normals point inwards, e.g. the six
+// planes of a view frustum. Planes need not be normalized.
+inline Containment classify( std::span<const Plane> planes, const AABB& box )
+{
+  const Point3 center  = box.center();
+  const Vec3   extents = box.extents();
+
+  Containment result = Containment::INSIDE;
+  for ( const auto& plane : planes )
+  {
+    const float distance = dot( plane, center );
+    const float radius   = std::fabs( plane.x() ) * extents.x() + std::fabs( plane.y() ) * extents.y()
+                         + std::fabs( plane.z() ) * extents.z();
+    if ( distance < -radius )
+    {
+      return Containment::OUTSIDE;
+    }
+    if ( distance < radius )
+    {
+      result = Containment::INTERSECTING;
+    }
+  }
+  return result;
+}
+
+struct LooseOctreeOptions
+{
+  // Depth is capped so a node location, one sentinel bit plus 3 bits per level, fits in 32 bits
+  uint32_t maxDepth = 8;
+  // Nodes overlap their neighbors: a node's loose bounds are its cell scaled by this factor
+  float looseness = 2.0F;
+};
+
+// Loose octree for dynamic objects. An object's node follows directly from its size and center, so
+// insert, move and remove are O(1) apart from a walk of at most maxDepth levels, and moves that stay
+// in the same node only overwrite the stored bounds. Every node keeps its objects in its own
+// contiguous array, which is also what the queries scan. Objects outside the world bounds live in
+// the root, which the queries always visit.
+class LooseOctree
+{
+  static constexpr uint32_t INVALID   = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t MAX_DEPTH = 10;
+
+  struct Item
+  {
+    AABB     bounds;
+    uint32_t handle{};
+  };
+
+  struct Node
+  {
+    std::vector<Item> items;
+    // Index of the first of eight consecutive children, 0 for leaves since the root is no child
+    uint32_t firstChild{};
+    uint32_t parent{ INVALID };
+    // Objects in this node and all of its descendants, so empty subtrees are skipped
+    uint32_t subtreeCount{};
+  };
+
+  // node is INVALID for free handles, whose slot then links the free list
+  struct Object
+  {
+    uint32_t node{ INVALID };
+    uint32_t slot{};
+    uint32_t location{};
+  };
+
+  AABB                m_bounds;
+  float               m_rootSize{};
+  LooseOctreeOptions  m_options;
+  std::vector<Node>   m_nodes;
+  std::vector<Object> m_objects;
+  uint32_t            m_freeObject{ INVALID };
+  size_t              m_size{};
+
+  [[nodiscard]] inline float cellSize( uint32_t depth ) const
+  {
+    return m_rootSize / static_cast<float>( 1U << depth );
+  }
+
+  [[nodiscard]] inline AABB looseBounds( const Point3& cell_min, float cell_size ) const
+  {
+    const float margin = ( m_options.looseness - 1.0F ) * cell_size * 0.5F;
+    return AABB{ cell_min, cell_min + Vec3{ cell_size, cell_size, cell_size } }.expanded( margin );
+  }
+
+  // Location code of the node for bounds: a sentinel bit above the Morton code of the cell at the
+  // deepest level whose loose bounds still hold an object of this size
+  [[nodiscard]] uint32_t locate( const AABB& bounds ) const
+  {
+    const Vec3  size   = bounds.max() - bounds.min();
+    const float extent = std::max( { size.x(), size.y(), size.z() } );
+
+    uint32_t depth = 0;
+    while ( depth < m_options.maxDepth && extent <= ( m_options.looseness - 1.0F ) * cellSize( depth + 1 ) )
+    {
+      ++depth;
+    }
+
+    const float  cell_size = cellSize( depth );
+    const Point3 center    = bounds.center();
+    const auto   last_cell = static_cast<float>( ( 1U << depth ) - 1 );
+    IVec3        cell;
+    Point3       cell_min;
+    for ( size_t axis = 0; axis != 3; ++axis )
+    {
+      const float offset = ( center[axis] - m_bounds.min()[axis] ) / cell_size;
+      const float index  = std::clamp( std::floor( offset ), 0.0F, last_cell );
+      cell[axis]        = static_cast<int>( index );
+      cell_min[axis]    = m_bounds.min()[axis] + index * cell_size;
+    }
+
+    if ( depth != 0 && !contains( looseBounds( cell_min, cell_size ), bounds ) )
+    {
+      return 1U;
+    }
+    return ( 1U << ( 3 * depth ) ) | encodeMorton30( cell );
+  }
+
+  uint32_t findOrCreateNode( uint32_t location )
+  {
+    const auto depth = static_cast<uint32_t>( std::bit_width( location ) - 1 ) / 3;
+    uint32_t   node  = 0;
+    for ( uint32_t level = depth; level-- != 0; )
+    {
+      if ( m_nodes[node].firstChild == 0 )
+      {
+        const auto first_child = static_cast<uint32_t>( m_nodes.size() );
+        m_nodes.resize( m_nodes.size() + 8 );
+        for ( uint32_t child = 0; child != 8; ++child )
+        {
+          m_nodes[first_child + child].parent = node;
+        }
+        m_nodes[node].firstChild = first_child;
+      }
+      node = m_nodes[node].firstChild + ( ( location >> ( 3 * level ) ) & 7U );
+    }
+    return node;
+  }
+
+  void addToSubtreeCounts( uint32_t node, int delta )
+  {
+    for ( ; node != INVALID; node = m_nodes[node].parent )
+    {
+      m_nodes[node].subtreeCount = static_cast<uint32_t>( static_cast<int>( m_nodes[node].subtreeCount ) + delta );
+    }
+  }
+
+  void attach( uint32_t handle, const AABB& bounds, uint32_t location )
+  {
+    const uint32_t node = findOrCreateNode( location );
+    m_objects[handle]   = Object{ node, static_cast<uint32_t>( m_nodes[node].items.size() ), location };
+    m_nodes[node].items.push_back( Item{ bounds, handle } );
+    addToSubtreeCounts( node, 1 );
+  }
+
+  void detach( uint32_t handle )
+  {
+    const Object       object = m_objects[handle];
+    std::vector<Item>& items  = m_nodes[object.node].items;
+
+    // Swap-remove: the last item of the node moves into the freed slot
+    const Item last = items.back();
+    items.pop_back();
+    if ( object.slot != items.size() )
+    {
+      items[object.slot]          = last;
+      m_objects[last.handle].slot = object.slot;
+    }
+    addToSubtreeCounts( object.node, -1 );
+  }
+
+  template<typename Callback>
+  void reportSubtree( uint32_t node, Callback& callback ) const
+  {
+    if ( m_nodes[node].subtreeCount == 0 )
+    {
+      return;
+    }
+    for ( const auto& item : m_nodes[node].items )
+    {
+      callback( item.handle );
+    }
+    if ( m_nodes[node].firstChild != 0 )
+    {
+      for ( uint32_t child = 0; child != 8; ++child )
+      {
+        reportSubtree( m_nodes[node].firstChild + child, callback );
+      }
+    }
+  }
+
+  // Visits the subtree, calling classify_node( loose_bounds ) to prune nodes and test_item( bounds )
+  // for the items of intersecting nodes. Fully contained subtrees are reported without tests.
+  template<typename ClassifyNode, typename TestItem, typename Callback>
+  void query( uint32_t node,
+    const Point3&      cell_min,
+    float              cell_size,
+    ClassifyNode&      classify_node,
+    TestItem&          test_item,
+    Callback&          callback ) const
+  {
+    if ( m_nodes[node].subtreeCount == 0 )
+    {
+      return;
+    }
+
+    // The root also holds objects outside the world bounds, so it is always intersecting
+    const Containment containment =
+      node == 0 ? Containment::INTERSECTING : classify_node( looseBounds( cell_min, cell_size ) );
+    if ( containment == Containment::OUTSIDE )
+    {
+      return;
+    }
+    if ( containment == Containment::INSIDE )
+    {
+      reportSubtree( node, callback );
+      return;
+    }
+
+    for ( const auto& item : m_nodes[node].items )
+    {
+      if ( test_item( item.bounds ) )
+      {
+        callback( item.handle );
+      }
+    }
+
+    if ( m_nodes[node].firstChild != 0 )
+    {
+      const float child_size = cell_size * 0.5F;
+      for ( uint32_t child = 0; child != 8; ++child )
+      {
+        const Point3 child_min = cell_min
+                                 + Vec3{ static_cast<float>( child & 1U ) * child_size,
+                                     static_cast<float>( ( child >> 1 ) & 1U ) * child_size,
+                                     static_cast<float>( ( child >> 2 ) & 1U ) * child_size };
+        query( m_nodes[node].firstChild + child, child_min, child_size, classify_node, test_item, callback );
+      }
+    }
+  }
+
+public:
+  // The octree's root cell is the cube around world_bounds; objects outside of it are still
+  // supported but all share the root node
+  explicit LooseOctree( const AABB& world_bounds, const LooseOctreeOptions& options = {} )
+    : m_options( options ), m_nodes( 1 )
+  {
+    assert( options.maxDepth <= MAX_DEPTH && options.looseness > 1.0F );
+    const Vec3 size = world_bounds.max() - world_bounds.min();
+    m_rootSize      = std::max( { size.x(), size.y(), size.z(), FLOAT_MIN } );
+    m_bounds        = AABB{ world_bounds.min(), world_bounds.min() + Vec3{ m_rootSize, m_rootSize, m_rootSize } };
+  }
+
+  [[nodiscard]] inline size_t size() const { return m_size; }
+  [[nodiscard]] inline size_t nodeCount() const { return m_nodes.size(); }
+
+  [[nodiscard]] inline const AABB& bounds( uint32_t handle ) const
+  {
+    assert( m_objects[handle].node != INVALID );
+    return m_nodes[m_objects[handle].node].items[m_objects[handle].slot].bounds;
+  }
+
+  // Handles of removed objects are recycled by later inserts
+  uint32_t insert( const AABB& bounds )
+  {
+    uint32_t handle = m_freeObject;
+    if ( handle != INVALID )
+    {
+      m_freeObject = m_objects[handle].slot;
+    } else
+    {
+      handle = static_cast<uint32_t>( m_objects.size() );
+      m_objects.emplace_back();
+    }
+
+    attach( handle, bounds, locate( bounds ) );
+    ++m_size;
+    return handle;
+  }
+
+  uint32_t insert( const Point3& point ) { return insert( AABB{ point, point } ); }
+
+  void update( uint32_t handle, const AABB& bounds )
+  {
+    assert( m_objects[handle].node != INVALID );
+    const uint32_t location = locate( bounds );
+    const Object&  object   = m_objects[handle];
+    if ( location == object.location )
+    {
+      m_nodes[object.node].items[object.slot].bounds = bounds;
+      return;
+    }
+
+    detach( handle );
+    attach( handle, bounds, location );
+  }
+
+  void update( uint32_t handle, const Point3& point ) { update( handle, AABB{ point, point } ); }
+
+  void remove( uint32_t handle )
+  {
+    assert( m_objects[handle].node != INVALID );
+    detach( handle );
+    m_objects[handle] = Object{ INVALID, m_freeObject, 0 };
+    m_freeObject      = handle;
+    --m_size;
+  }
+
+  // Calls callback( handle ) for every object overlapping box
+  template<typename Callback>
+  void queryOverlaps( const AABB& box, Callback&& callback ) const
+  {
+    auto classify_node = [&box]( const AABB& node_bounds ) {
+      if ( contains( box, node_bounds ) )
+      {
+        return Containment::INSIDE;
+      }
+      return overlaps( box, node_bounds ) ? Containment::INTERSECTING : Containment::OUTSIDE;
+    };
+    auto test_item     = [&box]( const AABB& bounds ) { return overlaps( bounds, box ); };
+    query( 0, m_bounds.min(), m_rootSize, classify_node, test_item, callback );
+  }
+
+  // Calls callback( handle ) for every object not fully outside the convex volume bounded by planes,
+  // with normals pointing inwards. Objects near the corners of the volume may be reported
+  // conservatively, as with any plane-by-plane box test.
+  template<typename Callback>
+  void queryFrustum( std::span<const Plane> planes, Callback&& callback ) const
+  {
+    auto classify_node = [planes]( const AABB& node_bounds ) { return classify( planes, node_bounds ); };
+    auto test_item     = [planes]( const AABB& bounds ) { return classify( planes, bounds ) != Containment::OUTSIDE; };
+    query( 0, m_bounds.min(), m_rootSize, classify_node, test_item, callback );
+  }
+};
+
+} // namespace Mirage::Math
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// Define to 1, or configure with -DMIRAGE_MATH_PERF_COUNTERS=ON, to count hardware events in
+// MIRAGE_MATH_PERF_SCOPE regions. Disabled, the scopes expand to nothing and the counter group is an empty
+// stub whose reads fold away.
+#ifndef MIRAGE_MATH_PERF_COUNTERS
+#define MIRAGE_MATH_PERF_COUNTERS 0
+#endif
+
+#if MIRAGE_MATH_PERF_COUNTERS
+#ifndef __linux__
+#error "MIRAGE_MATH_PERF_COUNTERS needs Linux perf_event_open"
+#endif
+#include <array>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Mirage::Math {
+
+constexpr bool PERF_COUNTERS_ENABLED = MIRAGE_MATH_PERF_COUNTERS != 0;
+
+// Counts averaged over calls or elements
+struct PerfRates
+{
+  double cycles{};
+  double instructions{};
+  double cacheMisses{};
+  double branchMisses{};
+};
+
+// Hardware event counts of the user-space code of one thread
+struct PerfCounts
+{
+  uint64_t cycles{};
+  uint64_t instructions{};
+  uint64_t cacheMisses{};
+  uint64_t branchMisses{};
+
+  [[nodiscard]] inline double ipc() const
+  {
+    return cycles != 0 ? static_cast<double>( instructions ) / static_cast<double>( cycles ) : 0.0;
+  }
+
+  [[nodiscard]] inline PerfRates per( uint64_t count ) const
+  {
+    if ( count == 0 )
+    {
+      return {};
+    }
+    const auto divisor = static_cast<double>( count );
+    return PerfRates{ static_cast<double>( cycles ) / divisor,
+      static_cast<double>( instructions ) / divisor,
+      static_cast<double>( cacheMisses ) / divisor,
+      static_cast<double>( branchMisses ) / divisor };
+  }
+
+  inline PerfCounts& operator+=( const PerfCounts& other )
+  {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cacheMisses += other.cacheMisses;
+    branchMisses += other.branchMisses;
+    return *this;
+  }
+};
+
+// Counts between two reads
+inline PerfCounts operator-( const PerfCounts& end, const PerfCounts& begin )
+{
+  return PerfCounts{ end.cycles - begin.cycles,
+    end.instructions - begin.instructions,
+    end.cacheMisses - begin.cacheMisses,
+    end.branchMisses - begin.branchMisses };
+}
+
+#if MIRAGE_MATH_PERF_COUNTERS
+
+// Cycles, instructions, cache misses and branch misses of the calling thread, opened as one perf_event group
+// so that the kernel schedules them together and the ratios between them hold. The group counts from
+// construction on and is read without stopping it, so measurements can nest. Threads need their own group,
+// see threadPerfCounters().
+class PerfCounterGroup
+{
+  static constexpr std::array<uint64_t, 4> EVENTS{ PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES };
+
+  std::array<int, EVENTS.size()> m_fds{};
+
+  static int open( uint64_t config, int group_fd )
+  {
+    perf_event_attr attr{};
+    attr.size           = sizeof( attr );
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>( syscall( SYS_perf_event_open, &attr, 0, -1, group_fd, 0 ) );
+  }
+
+  void close()
+  {
+    for ( auto& fd : m_fds )
+    {
+      if ( fd >= 0 )
+      {
+        ::close( fd );
+      }
+      fd = -1;
+    }
+  }
+
+public:
+  // Without a PMU, e.g. in most VMs, or when perf_event_paranoid forbids it, the group is unavailable
+  PerfCounterGroup()
+  {
+    m_fds.fill( -1 );
+    for ( size_t i = 0; i != EVENTS.size(); ++i )
+    {
+      m_fds[i] = open( EVENTS[i], m_fds[0] );
+      if ( m_fds[i] < 0 )
+      {
+        close();
+        return;
+      }
+    }
+  }
+
+  ~PerfCounterGroup() { close(); }
+
+  PerfCounterGroup( const PerfCounterGroup& )            = delete;
+  PerfCounterGroup& operator=( const PerfCounterGroup& ) = delete;
+
+  [[nodiscard]] inline bool available() const { return m_fds[0] >= 0; }
+
+  // Totals since construction, scaled up for the time the kernel had the group multiplexed out
+  [[nodiscard]] inline PerfCounts read() const
+  {
+    if ( !available() )
+    {
+      return {};
+    }
+
+    struct
+    {
+      uint64_t count;
+      uint64_t timeEnabled;
+      uint64_t timeRunning;
+      uint64_t values[EVENTS.size()];
+    } group{};
+    const auto bytes = ::read( m_fds[0], &group, sizeof( group ) );
+    if ( bytes != static_cast<ssize_t>( sizeof( group ) ) || group.timeRunning == 0 )
+    {
+      return {};
+    }
+
+    const double scale = static_cast<double>( group.timeEnabled ) / static_cast<double>( group.timeRunning );
+    const auto   value = [&]( size_t i ) {
+      return static_cast<uint64_t>( static_cast<double>( group.values[i] ) * scale );
+    };
+    return PerfCounts{ value( 0 ), value( 1 ), value( 2 ), value( 3 ) };
+  }
+};
+
+#else
+
+class PerfCounterGroup
+{
+public:
+  [[nodiscard]] static constexpr bool       available() { return false; }
+  [[nodiscard]] static constexpr PerfCounts read() { return {}; }
+};
+
+#endif
+
+// The counter group of the calling thread, opened on first use
+inline PerfCounterGroup& threadPerfCounters()
+{
+  thread_local PerfCounterGroup counters;
+  return counters;
+}
+
+// Totals of one instrumented region
+struct PerfStats
+{
+  PerfCounts counts;
+  uint64_t   calls{};
+  uint64_t   elements{};
+
+  [[nodiscard]] inline PerfRates perCall() const { return counts.per( calls ); }
+  [[nodiscard]] inline PerfRates perElement() const { return counts.per( elements ); }
+};
+
+// Named regions, shared by every thread
+class PerfRegistry
+{
+  mutable std::mutex                            m_mutex;
+  std::map<std::string, PerfStats, std::less<>> m_stats;
+
+public:
+  void record( std::string_view name, const PerfCounts& counts, uint64_t elements )
+  {
+    std::lock_guard lock( m_mutex );
+    auto            it = m_stats.find( name );
+    if ( it == m_stats.end() )
+    {
+      it = m_stats.emplace( std::string( name ), PerfStats{} ).first;
+    }
+    it->second.counts += counts;
+    it->second.calls += 1;
+    it->second.elements += elements;
+  }
+
+  [[nodiscard]] std::map<std::string, PerfStats, std::less<>> stats() const
+  {
+    std::lock_guard lock( m_mutex );
+    return m_stats;
+  }
+
+  void reset()
+  {
+    std::lock_guard lock( m_mutex );
+    m_stats.clear();
+  }
+
+  // One line per region, with the counts per element and the cycles per call
+  [[nodiscard]] std::string report() const
+  {
+    std::string result = std::format( "{:<32} {:>10} {:>12} {:>12} {:>11} {:>11} {:>6} {:>11} {:>11}\n",
+      "region",
+      "calls",
+      "elements",
+      "cycles/call",
+      "cycles/elem",
+      "instr/elem",
+      "IPC",
+      "cache/elem",
+      "branch/elem" );
+    for ( const auto& [name, stats] : this->stats() )
+    {
+      const PerfRates element = stats.perElement();
+      result += std::format( "{:<32} {:>10} {:>12} {:>12.1f} {:>11.2f} {:>11.2f} {:>6.2f} {:>11.4f} {:>11.4f}\n",
+        name,
+        stats.calls,
+        stats.elements,
+        stats.perCall().cycles,
+        element.cycles,
+        element.instructions,
+        stats.counts.ipc(),
+        element.cacheMisses,
+        element.branchMisses );
+    }
+    return result;
+  }
+};
+
+inline PerfRegistry& defaultPerfRegistry()
+{
+  static PerfRegistry registry;
+  return registry;
+}
+
+// Records the counts of the calling thread from construction to destruction as one call of a named region.
+// Each scope costs two read() system calls, so it should wrap a batch of work rather than a single small kernel.
+class PerfScope
+{
+  std::string_view m_name;
+  uint64_t         m_elements;
+  PerfRegistry&    m_registry;
+  PerfCounts       m_begin;
+
+public:
+  explicit PerfScope( std::string_view name, uint64_t elements = 1, PerfRegistry& registry = defaultPerfRegistry() )
+    : m_name( name ), m_elements( elements ), m_registry( registry ), m_begin( threadPerfCounters().read() )
+  {}
+
+  ~PerfScope()
+  {
+    if ( threadPerfCounters().available() )
+    {
+      m_registry.record( m_name, threadPerfCounters().read() - m_begin, m_elements );
+    }
+  }
+
+  PerfScope( const PerfScope& )            = delete;
+  PerfScope& operator=( const PerfScope& ) = delete;
+};
+
+} // namespace Mirage::Math
+
+// Counts the rest of the enclosing block as one call of region name over elements elements. Compiles to
+// nothing, without evaluating its arguments, unless MIRAGE_MATH_PERF_COUNTERS is enabled.
+#if MIRAGE_MATH_PERF_COUNTERS
+#define MIRAGE_MATH_PERF_CONCAT_IMPL( a, b ) a##b
+#define MIRAGE_MATH_PERF_CONCAT( a, b ) MIRAGE_MATH_PERF_CONCAT_IMPL( a, b )
+#define MIRAGE_MATH_PERF_SCOPE( name, elements ) \
+  const ::Mirage::Math::PerfScope MIRAGE_MATH_PERF_CONCAT( mirage_math_perf_scope_, __LINE__ )( name, elements )
+#else
+#define MIRAGE_MATH_PERF_SCOPE( name, elements ) static_cast<void>( 0 )
+#endif
@@ -0,0 +1,522 @@
+#pragma once
+
+#include "batch_transform.hpp"
+#include "job_system.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+#include "point_stream.hpp"
+#include "transform.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Coroutine pipelines: stages are coroutines connected by bounded channels, and every time a stage
+// resumes it runs as a job on a job system. A stage that sends to a full channel or receives from an
+// empty one suspends instead of blocking a worker, so any number of stages share the workers, and a
+// slow stage holds back the ones feeding it once the channels in between fill up.
+//
+//   Pipeline            pipeline;
+//   Channel<PointChunk> read( pipeline, 2 ), moved( pipeline, 2 );
+//   pipeline.spawn( readPointChunks( reader, read, 1 << 16 ) );
+//   pipeline.spawn( transformPointChunks( read, moved, transform ) );
+//   pipeline.spawn( writePointChunks( moved, writer ) );
+//   const bool completed = pipeline.wait();
+//
+// Stages take channels, sources and sinks by reference, so those must outlive wait(); everything else
+// they need is copied into the coroutine frame, since temporaries passed to a stage are gone by the
+// time it runs.
+
+class PipelineStage;
+
+// Base of the channels, through which a pipeline closes them all when it is cancelled
+class PipelineChannel
+{
+public:
+  PipelineChannel()                                    = default;
+  PipelineChannel( const PipelineChannel& )            = delete;
+  PipelineChannel& operator=( const PipelineChannel& ) = delete;
+  virtual ~PipelineChannel()                           = default;
+
+  virtual void close() = 0;
+};
+
+class Pipeline
+{
+  TaskGroup                     m_group;
+  std::atomic<size_t>           m_liveStages{};
+  std::mutex                    m_mutex;
+  std::vector<PipelineChannel*> m_channels;
+  std::exception_ptr            m_error;
+  bool                          m_cancelled{ false };
+
+public:
+  explicit Pipeline( JobSystem& jobs = defaultJobSystem() ) : m_group( jobs ) {}
+
+  Pipeline( const Pipeline& )            = delete;
+  Pipeline& operator=( const Pipeline& ) = delete;
+
+  ~Pipeline() { m_group.wait(); }
+
+  [[nodiscard]] inline JobSystem& jobSystem() const { return m_group.jobSystem(); }
+
+  // Starts a stage; the pipeline owns it from now on
+  void spawn( PipelineStage stage );
+
+  // Resumes a suspended stage as a job
+  void schedule( std::coroutine_handle<> handle )
+  {
+    m_group.run( [handle]() { handle.resume(); } );
+  }
+
+  // Closes every channel, so that sends fail and receives end and all stages run to their end
+  void cancel()
+  {
+    std::vector<PipelineChannel*> channels;
+    {
+      const std::lock_guard lock( m_mutex );
+      m_cancelled = true;
+      channels    = m_channels;
+    }
+    for ( auto* channel : channels )
+    {
+      channel->close();
+    }
+  }
+
+  // Cancels the pipeline with the exception a stage ended with; wait() rethrows the first one
+  void fail( std::exception_ptr error )
+  {
+    {
+      const std::lock_guard lock( m_mutex );
+      if ( !m_error )
+      {
+        m_error = std::move( error );
+      }
+    }
+    cancel();
+  }
+
+  // Waits for every stage to end. Returns false if the pipeline was cancelled.
+  bool wait()
+  {
+    m_group.wait();
+    // Stages still suspended here wait on channels no other stage will ever use again
+    assert( m_liveStages.load() == 0 );
+
+    const std::lock_guard lock( m_mutex );
+    if ( auto error = std::exchange( m_error, nullptr ) )
+    {
+      std::rethrow_exception( error );
+    }
+    return !std::exchange( m_cancelled, false );
+  }
+
+  void attach( PipelineChannel* channel )
+  {
+    const std::lock_guard lock( m_mutex );
+    m_channels.push_back( channel );
+  }
+
+  void detach( PipelineChannel* channel )
+  {
+    const std::lock_guard lock( m_mutex );
+    std::erase( m_channels, channel );
+  }
+
+  void stageStarted() { m_liveStages.fetch_add( 1 ); }
+  void stageFinished() { m_liveStages.fetch_sub( 1 ); }
+};
+
+// Coroutine type of pipeline stages. Stages start when spawned and free themselves when they end;
+// an exception that escapes a stage fails the pipeline.
+class PipelineStage
+{
+public:
+  struct promise_type
+  {
+    Pipeline* pipeline{};
+
+    ~promise_type()
+    {
+      if ( pipeline != nullptr )
+      {
+        pipeline->stageFinished();
+      }
+    }
+
+    PipelineStage get_return_object()
+    {
+      return PipelineStage{ std::coroutine_handle<promise_type>::from_promise( *this ) };
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_never  final_suspend() noexcept { return {}; }
+    void                return_void() noexcept {}
+    void                unhandled_exception() { pipeline->fail( std::current_exception() ); }
+  };
+
+private:
+  std::coroutine_handle<promise_type> m_handle;
+
+  explicit PipelineStage( std::coroutine_handle<promise_type> handle ) : m_handle( handle ) {}
+
+  friend class Pipeline;
+
+public:
+  PipelineStage( PipelineStage&& other ) noexcept : m_handle( std::exchange( other.m_handle, nullptr ) ) {}
+  PipelineStage& operator=( PipelineStage&& ) = delete;
+
+  // A stage that was never spawned is destroyed without running
+  ~PipelineStage()
+  {
+    if ( m_handle )
+    {
+      m_handle.destroy();
+    }
+  }
+};
+
+inline void Pipeline::spawn( PipelineStage stage )
+{
+  auto handle               = std::exchange( stage.m_handle, nullptr );
+  handle.promise().pipeline = this;
+  stageStarted();
+  schedule( handle );
+}
+
+// Bounded queue between stages. Senders suspend while it holds capacity items and receivers while it
+// is empty; once closed, sends fail and receives drain what is left and then end.
+template<typename T>
+class Channel : public PipelineChannel
+{
+  struct SendAwaiter;
+  struct ReceiveAwaiter;
+
+  Pipeline&                   m_pipeline;
+  size_t                      m_capacity;
+  std::mutex                  m_mutex;
+  std::deque<T>               m_items;
+  std::deque<SendAwaiter*>    m_senders;
+  std::deque<ReceiveAwaiter*> m_receivers;
+  bool                        m_closed{ false };
+
+  // Suspending awaiters are resumed with their result already in place
+  struct SendAwaiter
+  {
+    Channel&                channel;
+    T                       value;
+    bool                    sent{ false };
+    std::coroutine_handle<> handle;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend( std::coroutine_handle<> suspended )
+    {
+      const std::lock_guard lock( channel.m_mutex );
+      if ( channel.m_closed )
+      {
+        return false;
+      }
+      if ( !channel.m_receivers.empty() )
+      {
+        ReceiveAwaiter* receiver = channel.m_receivers.front();
+        channel.m_receivers.pop_front();
+        receiver->value.emplace( std::move( value ) );
+        channel.m_pipeline.schedule( receiver->handle );
+        sent = true;
+        return false;
+      }
+      if ( channel.m_items.size() < channel.m_capacity )
+      {
+        channel.m_items.push_back( std::move( value ) );
+        sent = true;
+        return false;
+      }
+      handle = suspended;
+      channel.m_senders.push_back( this );
+      return true;
+    }
+
+    bool await_resume() const noexcept { return sent; }
+  };
+
+  struct ReceiveAwaiter
+  {
+    Channel&                channel;
+    std::optional<T>        value;
+    std::coroutine_handle<> handle;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend( std::coroutine_handle<> suspended )
+    {
+      const std::lock_guard lock( channel.m_mutex );
+      if ( !channel.m_items.empty() || !channel.m_senders.empty() )
+      {
+        // The longest waiting sender gets the space this frees, or hands its value over directly
+        // when the channel has no capacity
+        SendAwaiter* sender = nullptr;
+        if ( !channel.m_senders.empty() )
+        {
+          sender = channel.m_senders.front();
+          channel.m_senders.pop_front();
+          channel.m_items.push_back( std::move( sender->value ) );
+          sender->sent = true;
+        }
+        value.emplace( std::move( channel.m_items.front() ) );
+        channel.m_items.pop_front();
+        if ( sender != nullptr )
+        {
+          channel.m_pipeline.schedule( sender->handle );
+        }
+        return false;
+      }
+      if ( channel.m_closed )
+      {
+        return false;
+      }
+      handle = suspended;
+      channel.m_receivers.push_back( this );
+      return true;
+    }
+
+    std::optional<T> await_resume() { return std::move( value ); }
+  };
+
+public:
+  // capacity 0 hands every item straight from a sender to a receiver
+  Channel( Pipeline& pipeline, size_t capacity ) : m_pipeline( pipeline ), m_capacity( capacity )
+  {
+    m_pipeline.attach( this );
+  }
+
+  ~Channel() override { m_pipeline.detach( this ); }
+
+  // co_await send( value ) is false if the channel was closed, after which the stage should end
+  [[nodiscard]] SendAwaiter send( T value ) { return SendAwaiter{ *this, std::move( value ), false, {} }; }
+
+  // co_await receive() is std::nullopt once the channel is closed and empty
+  [[nodiscard]] ReceiveAwaiter receive() { return ReceiveAwaiter{ *this, std::nullopt, {} }; }
+
+  void close() override
+  {
+    const std::lock_guard lock( m_mutex );
+    if ( std::exchange( m_closed, true ) )
+    {
+      return;
+    }
+    for ( auto* sender : m_senders )
+    {
+      m_pipeline.schedule( sender->handle );
+    }
+    for ( auto* receiver : m_receivers )
+    {
+      m_pipeline.schedule( receiver->handle );
+    }
+    m_senders.clear();
+    m_receivers.clear();
+  }
+
+  [[nodiscard]] inline Pipeline& pipeline() const { return m_pipeline; }
+  [[nodiscard]] inline size_t    capacity() const { return m_capacity; }
+
+  // Items queued right now
+  [[nodiscard]] size_t size()
+  {
+    const std::lock_guard lock( m_mutex );
+    return m_items.size();
+  }
+};
+
+// Lazily computed sequence, for stages that produce their output with co_yield. Yielded values can be
+// moved out through the iterator.
+template<typename T>
+class Generator
+{
+public:
+  struct promise_type
+  {
+    T*                 current{};
+    std::exception_ptr error;
+
+    Generator get_return_object() { return Generator{ std::coroutine_handle<promise_type>::from_promise( *this ) }; }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    std::suspend_always yield_value( T& value ) noexcept
+    {
+      current = std::addressof( value );
+      return {};
+    }
+
+    std::suspend_always yield_value( T&& value ) noexcept
+    {
+      current = std::addressof( value );
+      return {};
+    }
+
+    void return_void() noexcept {}
+    void unhandled_exception() { error = std::current_exception(); }
+  };
+
+  class Iterator
+  {
+    std::coroutine_handle<promise_type> m_handle;
+
+  public:
+    using value_type      = T;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    explicit Iterator( std::coroutine_handle<promise_type> handle ) : m_handle( handle ) {}
+
+    [[nodiscard]] inline T& operator*() const { return *m_handle.promise().current; }
+
+    Iterator& operator++()
+    {
+      m_handle.resume();
+      if ( auto error = std::exchange( m_handle.promise().error, nullptr ) )
+      {
+        std::rethrow_exception( error );
+      }
+      return *this;
+    }
+
+    void operator++( int ) { ++*this; }
+
+    [[nodiscard]] friend inline bool operator==( const Iterator& it, std::default_sentinel_t )
+    {
+      return it.m_handle.done();
+    }
+  };
+
+private:
+  std::coroutine_handle<promise_type> m_handle;
+
+  explicit Generator( std::coroutine_handle<promise_type> handle ) : m_handle( handle ) {}
+
+public:
+  Generator( Generator&& other ) noexcept : m_handle( std::exchange( other.m_handle, nullptr ) ) {}
+  Generator& operator=( Generator&& ) = delete;
+
+  ~Generator()
+  {
+    if ( m_handle )
+    {
+      m_handle.destroy();
+    }
+  }
+
+  // Runs to the first value; iterate only once
+  Iterator begin()
+  {
+    Iterator it( m_handle );
+    return ++it;
+  }
+
+  [[nodiscard]] inline std::default_sentinel_t end() const { return {}; }
+};
+
+// Stages over chunks of points, composing the batch operations. Each ends when its input does and
+// then closes its output, so the end of the data travels down the pipeline.
+using PointChunk = std::vector<Point3>;
+
+// Chunks of up to chunk_size points from a PointSource; a read failure cancels the pipeline
+template<PointSource Source>
+PipelineStage readPointChunks( Source& source, Channel<PointChunk>& out, size_t chunk_size )
+{
+  while ( true )
+  {
+    PointChunk chunk( chunk_size );
+    const auto count = source.read( chunk );
+    if ( !count )
+    {
+      out.pipeline().cancel();
+      break;
+    }
+    if ( *count == 0 )
+    {
+      break;
+    }
+    chunk.resize( *count );
+    if ( !co_await out.send( std::move( chunk ) ) )
+    {
+      break;
+    }
+  }
+  out.close();
+}
+
+// Calls function( item ) for every item of in and sends the results to out
+template<typename In, typename Out, typename Function>
+PipelineStage mapChunks( Channel<In>& in, Channel<Out>& out, Function function )
+{
+  while ( auto item = co_await in.receive() )
+  {
+    if ( !co_await out.send( function( std::move( *item ) ) ) )
+    {
+      break;
+    }
+  }
+  out.close();
+}
+
+// transform and options are copied into the stage, unlike the referenced channels
+inline PipelineStage transformPointChunks(
+  Channel<PointChunk>& in, Channel<PointChunk>& out, Transform4 transform, BatchTransformOptions options = {} )
+{
+  while ( auto chunk = co_await in.receive() )
+  {
+    transformPoints( transform, *chunk, *chunk, options );
+    if ( !co_await out.send( std::move( *chunk ) ) )
+    {
+      break;
+    }
+  }
+  out.close();
+}
+
+// Keeps the points on the positive side of all planes, dot( plane, point ) >= 0, as streamPoints does.
+// planes are copied into the stage, which first runs after spawn() returns.
+inline PipelineStage cullPointChunks( Channel<PointChunk>& in, Channel<PointChunk>& out, std::vector<Plane> planes )
+{
+  while ( auto chunk = co_await in.receive() )
+  {
+    std::erase_if( *chunk, [&planes]( const Point3& point ) {
+      return !std::ranges::all_of( planes, [&point]( const Plane& plane ) { return dot( plane, point ) >= 0.0F; } );
+    } );
+    if ( !chunk->empty() && !co_await out.send( std::move( *chunk ) ) )
+    {
+      break;
+    }
+  }
+  out.close();
+}
+
+// Writes every chunk to a PointSink; a write failure cancels the pipeline
+template<PointSink Sink>
+PipelineStage writePointChunks( Channel<PointChunk>& in, Sink& sink )
+{
+  while ( auto chunk = co_await in.receive() )
+  {
+    if ( !sink.write( *chunk ) )
+    {
+      in.pipeline().cancel();
+      break;
+    }
+  }
+}
+
+} // namespace Mirage::Math
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "batch.hpp"
 #include "mirage_math/line.hpp"
 #include "point.hpp"
 #include "transform.hpp"
 #include "vec.hpp"
+#include <cassert>
+#include <cmath>
+#include <optional>
+#include <span>
 
 namespace Mirage::Math {
 
@@ -31,7 +36,7 @@ inline float dot( const Plane& plane, const Vec3& point )
   return plane.x() * point.x() + plane.y() * point.y() + plane.z() * point.z();
 }
 
-Plane operator*( const Plane& plane, const Transform4& transform )
+inline Plane operator*( const Plane& plane, const Transform4& transform )
 {
   return Plane{
     plane.x() * transform( 0, 0 ) + plane.y() * transform( 1, 0 ) + plane.z() * transform( 2, 0 ),
@@ -69,43 +74,148 @@ inline Transform4 makeReflection( const Plane& plane )
   };
 }
 
-inline std::optional<Point3> getIntersection( const Plane& plane, const Line& line )
+// The intersect() kernels are branch-free: the output is always written and the return value says
+// whether it is meaningful. They back both the std::optional queries and the batched versions.
+inline bool intersect( const Plane& plane, const Line& line, Point3& point )
 {
-  float fp = dot( plane, line.point() );
-  float fv = dot( plane, line.vector() );
-  return std::fabs( fv ) > FLOAT_MIN ? std::optional{ line.point() - ( fp / fv ) * line.vector() } : std::nullopt;
+  const float fp    = dot( plane, line.point() );
+  const float fv    = dot( plane, line.vector() );
+  const bool  valid = std::fabs( fv ) > FLOAT_MIN;
+  point             = line.point() - ( fp / safeDivisor( fv, valid ) ) * line.vector();
+  return valid;
 }
 
-inline std::optional<Point3> getIntersection( const Plane& a, const Plane& b, const Plane& c )
+inline bool intersect( const Plane& a, const Plane& b, const Plane& c, Point3& point )
 {
   const Vec3& na = a.getNormal();
   const Vec3& nb = b.getNormal();
   const Vec3& nc = c.getNormal();
 
-  Vec3  cross_na_nb           = cross( na, nb );
-  float scalar_triple_product = dot( cross_na_nb, nc );
+  Vec3       cross_na_nb           = cross( na, nb );
+  float      scalar_triple_product = dot( cross_na_nb, nc );
+  const bool valid                 = std::fabs( scalar_triple_product ) > FLOAT_MIN;
 
-  return std::fabs( scalar_triple_product ) > FLOAT_MIN
-           ? std::optional{ ( a.w() * cross( nc, nb ) + b.w() * cross( na, nc ) - c.w() * cross_na_nb )
-                            / scalar_triple_product }
-           : std::nullopt;
+  point = ( a.w() * cross( nc, nb ) + b.w() * cross( na, nc ) - c.w() * cross_na_nb )
+          / safeDivisor( scalar_triple_product, valid );
+  return valid;
 }
 
-inline std::optional<Line> getIntersection( const Plane& a, const Plane& b )
+inline bool intersect( const Plane& a, const Plane& b, Line& line )
 {
   const Vec3& na = a.getNormal();
   const Vec3& nb = b.getNormal();
 
-  const Vec3& vec                   = cross( na, nb );
-  float       scalar_triple_product = dot( vec, vec );
-  if ( std::fabs( scalar_triple_product ) > FLOAT_MIN )
+  const Vec3 vec                   = cross( na, nb );
+  float      scalar_triple_product = dot( vec, vec );
+  const bool valid                 = std::fabs( scalar_triple_product ) > FLOAT_MIN;
+
+  Point3 point{ ( a.w() * cross( vec, nb ) + b.w() * cross( na, vec ) ) / safeDivisor( scalar_triple_product, valid ) };
+  line = Line{ point, vec };
+  return valid;
+}
+
+inline std::optional<Point3> getIntersection( const Plane& plane, const Line& line )
+{
+  Point3 point;
+  return intersect( plane, line, point ) ? std::optional{ point } : std::nullopt;
+}
+
+inline std::optional<Point3> getIntersection( const Plane& a, const Plane& b, const Plane& c )
+{
+  Point3 point;
+  return intersect( a, b, c, point ) ? std::optional{ point } : std::nullopt;
+}
+
+inline std::optional<Line> getIntersection( const Plane& a, const Plane& b )
+{
+  Line line;
+  return intersect( a, b, line ) ? std::optional{ line } : std::nullopt;
+}
+
+// Planes for the batched queries, one stream per coefficient
+struct SoAPlane
+{
+  std::span<const float> x;
+  std::span<const float> y;
+  std::span<const float> z;
+  std::span<const float> w;
+
+  [[nodiscard]] inline size_t size() const
   {
-    Point3 point{ ( a.w() * cross( vec, nb ) + b.w() * cross( na, vec ) ) / scalar_triple_product };
-    return std::optional{
-      Line{ point, vec }
-    };
+    assert( x.size() == y.size() && y.size() == z.size() && z.size() == w.size() );
+    return x.size();
   }
-  return std::nullopt;
+
+  [[nodiscard]] inline Plane operator[]( size_t i ) const { return Plane{ x[i], y[i], z[i], w[i] }; }
+};
+
+// Batched queries: element i of every input forms query i. Results go to SoA outputs and the validity
+// of each query to one bit of valid; outputs of invalid queries hold unspecified values.
+// Each returns the number of valid queries.
+inline size_t getIntersections(
+  const SoAPlane& planes, const SoALine& lines, MutableSoAVec3 points, std::span<uint64_t> valid )
+{
+  assert( planes.size() == lines.size() && points.size() >= lines.size() );
+  return fillMask( lines.size(), valid, [&]( size_t i ) {
+    Point3     point;
+    const bool hit = intersect( planes[i], lines[i], point );
+    points.x[i]    = point.x();
+    points.y[i]    = point.y();
+    points.z[i]    = point.z();
+    return hit;
+  } );
+}
+
+// One plane against many lines, e.g. a single clip or portal plane
+inline size_t getIntersections(
+  const Plane& plane, const SoALine& lines, MutableSoAVec3 points, std::span<uint64_t> valid )
+{
+  assert( points.size() >= lines.size() );
+  return fillMask( lines.size(), valid, [&]( size_t i ) {
+    Point3     point;
+    const bool hit = intersect( plane, lines[i], point );
+    points.x[i]    = point.x();
+    points.y[i]    = point.y();
+    points.z[i]    = point.z();
+    return hit;
+  } );
+}
+
+inline size_t getIntersections( const SoAPlane& a,
+  const SoAPlane&                                b,
+  const SoAPlane&                                c,
+  MutableSoAVec3                                 points,
+  std::span<uint64_t>                            valid )
+{
+  assert( a.size() == b.size() && b.size() == c.size() && points.size() >= a.size() );
+  return fillMask( a.size(), valid, [&]( size_t i ) {
+    Point3     point;
+    const bool hit = intersect( a[i], b[i], c[i], point );
+    points.x[i]    = point.x();
+    points.y[i]    = point.y();
+    points.z[i]    = point.z();
+    return hit;
+  } );
+}
+
+inline size_t getIntersections( const SoAPlane& a,
+  const SoAPlane&                                b,
+  MutableSoAVec3                                 points,
+  MutableSoAVec3                                 vectors,
+  std::span<uint64_t>                            valid )
+{
+  assert( a.size() == b.size() && points.size() >= a.size() && vectors.size() >= a.size() );
+  return fillMask( a.size(), valid, [&]( size_t i ) {
+    Line       line;
+    const bool hit = intersect( a[i], b[i], line );
+    points.x[i]    = line.point().x();
+    points.y[i]    = line.point().y();
+    points.z[i]    = line.point().z();
+    vectors.x[i]   = line.vector().x();
+    vectors.y[i]   = line.vector().y();
+    vectors.z[i]   = line.vector().z();
+    return hit;
+  } );
 }
 
 } // namespace Mirage::Math
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "plane.hpp"
+#include "point.hpp"
+#include "transform.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Streaming transform of point sets larger than memory. Points move through a fixed ring of chunk
+// buffers: one thread reads chunks from the source, the calling thread transforms and culls them, and
+// another thread writes them to the sink, so reading, computing and writing overlap and memory stays
+// at chunkSize * chunkCount points whatever the input size.
+
+// read() fills a prefix of the chunk and returns the number of points read, 0 at the end of the
+// input, or std::nullopt on failure
+template<typename Source>
+concept PointSource = requires( Source& source, std::span<Point3> chunk ) {
+  { source.read( chunk ) } -> std::same_as<std::optional<size_t>>;
+};
+
+// write() returns false on failure, which stops the stream
+template<typename Sink>
+concept PointSink = requires( Sink& sink, std::span<const Point3> chunk ) {
+  { sink.write( chunk ) } -> std::same_as<bool>;
+};
+
+// Packed x, y, z floats in native byte order
+class RawPointReader
+{
+  std::ifstream m_file;
+
+public:
+  explicit RawPointReader( const std::filesystem::path& path ) : m_file( path, std::ios::binary ) {}
+
+  [[nodiscard]] inline bool isOpen() const { return m_file.is_open(); }
+
+  std::optional<size_t> read( std::span<Point3> chunk )
+  {
+    static_assert( sizeof( Point3 ) == 3 * sizeof( float ) );
+    if ( !m_file.is_open() || m_file.bad() )
+    {
+      return std::nullopt;
+    }
+    m_file.read( reinterpret_cast<char*>( chunk.data() ), static_cast<std::streamsize>( chunk.size_bytes() ) );
+
+    // A trailing partial point means the file is not a point file
+    const auto bytes = static_cast<size_t>( m_file.gcount() );
+    if ( m_file.bad() || bytes % sizeof( Point3 ) != 0 )
+    {
+      return std::nullopt;
+    }
+    return bytes / sizeof( Point3 );
+  }
+};
+
+class RawPointWriter
+{
+  std::ofstream m_file;
+
+public:
+  explicit RawPointWriter( const std::filesystem::path& path ) : m_file( path, std::ios::binary | std::ios::trunc ) {}
+
+  bool write( std::span<const Point3> chunk )
+  {
+    m_file.write( reinterpret_cast<const char*>( chunk.data() ), static_cast<std::streamsize>( chunk.size_bytes() ) );
+    return m_file.good();
+  }
+
+  // Flushes buffered output; false if anything failed to write
+  bool close()
+  {
+    m_file.close();
+    return !m_file.fail();
+  }
+};
+
+// Points already in memory or mapped, e.g. a section of a MappedBinaryFile. Copying a chunk out of a
+// mapping is where its pages are faulted in, so this happens on the reading thread.
+class PointSpanReader
+{
+  std::span<const Point3> m_points;
+
+public:
+  explicit PointSpanReader( std::span<const Point3> points ) : m_points( points ) {}
+
+  std::optional<size_t> read( std::span<Point3> chunk )
+  {
+    const size_t count = std::min( chunk.size(), m_points.size() );
+    std::copy_n( m_points.begin(), count, chunk.begin() );
+    m_points = m_points.subspan( count );
+    return count;
+  }
+};
+
+struct PointStreamOptions
+{
+  // Points per chunk
+  size_t chunkSize = size_t{ 1 } << 16;
+  // Chunk buffers in flight; three let reading, computing and writing each hold one
+  size_t chunkCount = 4;
+};
+
+struct PointStreamStats
+{
+  uint64_t read{};
+  uint64_t written{};
+};
+
+// Blocking queue of chunk buffer indices. Never holds more than the number of chunks, so it needs no
+// bound of its own. Once closed, pop() drains what is left and then returns std::nullopt.
+class PointChunkQueue
+{
+  std::mutex              m_mutex;
+  std::condition_variable m_ready;
+  std::deque<size_t>      m_chunks;
+  bool                    m_closed{ false };
+
+public:
+  void push( size_t chunk )
+  {
+    {
+      const std::lock_guard lock( m_mutex );
+      m_chunks.push_back( chunk );
+    }
+    m_ready.notify_one();
+  }
+
+  void close()
+  {
+    {
+      const std::lock_guard lock( m_mutex );
+      m_closed = true;
+    }
+    m_ready.notify_all();
+  }
+
+  std::optional<size_t> pop()
+  {
+    std::unique_lock lock( m_mutex );
+    m_ready.wait( lock, [this]() { return m_closed || !m_chunks.empty(); } );
+    if ( m_chunks.empty() )
+    {
+      return std::nullopt;
+    }
+    const size_t chunk = m_chunks.front();
+    m_chunks.pop_front();
+    return chunk;
+  }
+};
+
+// Transforms every point of the source and writes those on the positive side of all planes,
+// dot( plane, point ) >= 0 as in clip.hpp, to the sink in input order. Planes apply to the
+// transformed points. Returns the point counts, or std::nullopt if reading or writing failed, in
+// which case the sink may have received part of the output.
+template<PointSource Source, PointSink Sink>
+std::optional<PointStreamStats> streamPoints( Source& source,
+  Sink&                                              sink,
+  const Transform4&                                  transform,
+  std::span<const Plane>                             planes  = {},
+  const PointStreamOptions&                          options = {} )
+{
+  assert( options.chunkSize != 0 && options.chunkCount != 0 );
+
+  std::vector<std::vector<Point3>> chunks( options.chunkCount, std::vector<Point3>( options.chunkSize ) );
+  std::vector<size_t>              counts( options.chunkCount );
+  PointChunkQueue                  free_chunks;
+  PointChunkQueue                  read_chunks;
+  PointChunkQueue                  done_chunks;
+  std::atomic<bool>                failed{ false };
+  PointStreamStats                 stats;
+
+  for ( size_t chunk = 0; chunk != options.chunkCount; ++chunk )
+  {
+    free_chunks.push( chunk );
+  }
+
+  // The reader and writer run on threads of their own rather than as jobs: they block on I/O and on
+  // the queues, which would hold up a job system worker for as long and could leave no worker free
+  // for the transform. Each side closes the queue the other stages wait on when it stops, also when
+  // it throws, so an exception reaches the caller instead of leaving them blocked
+  auto reader = std::async( std::launch::async, [&]() {
+    try
+    {
+      while ( const auto chunk = free_chunks.pop() )
+      {
+        const auto count = source.read( chunks[*chunk] );
+        if ( !count )
+        {
+          failed = true;
+        }
+        if ( !count || *count == 0 )
+        {
+          break;
+        }
+        counts[*chunk] = *count;
+        stats.read += *count;
+        read_chunks.push( *chunk );
+      }
+    } catch ( ... )
+    {
+      read_chunks.close();
+      throw;
+    }
+    read_chunks.close();
+  } );
+
+  auto writer = std::async( std::launch::async, [&]() {
+    try
+    {
+      while ( const auto chunk = done_chunks.pop() )
+      {
+        if ( !sink.write( std::span{ chunks[*chunk] }.first( counts[*chunk] ) ) )
+        {
+          // The reader stops once the chunks it still holds are used up
+          failed = true;
+          free_chunks.close();
+          break;
+        }
+        stats.written += counts[*chunk];
+        free_chunks.push( *chunk );
+      }
+    } catch ( ... )
+    {
+      free_chunks.close();
+      throw;
+    }
+  } );
+
+  while ( const auto chunk = read_chunks.pop() )
+  {
+    std::vector<Point3>& points = chunks[*chunk];
+    size_t               kept   = 0;
+    for ( size_t i = 0; i != counts[*chunk]; ++i )
+    {
+      const Point3 point = transform * points[i];
+      points[kept]       = point;
+      kept += static_cast<size_t>(
+        std::ranges::all_of( planes, [&point]( const Plane& plane ) { return dot( plane, point ) >= 0.0F; } ) );
+    }
+    counts[*chunk] = kept;
+    done_chunks.push( *chunk );
+  }
+  done_chunks.close();
+
+  reader.get();
+  writer.get();
+  if ( failed )
+  {
+    return std::nullopt;
+  }
+  return stats;
+}
+
+// Applies chain[0] first and the last transform last
+template<PointSource Source, PointSink Sink>
+std::optional<PointStreamStats> streamPoints( Source& source,
+  Sink&                                              sink,
+  std::span<const Transform4>                        chain,
+  std::span<const Plane>                             planes  = {},
+  const PointStreamOptions&                          options = {} )
+{
+  Transform4 combined{ Transform4::identity() };
+  for ( const auto& transform : chain )
+  {
+    combined = compose( combined, transform );
+  }
+  return streamPoints( source, sink, combined, planes, options );
+}
+
+} // namespace Mirage::Math
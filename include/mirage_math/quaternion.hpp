@@ -11,7 +11,7 @@ public:
   using Vec4::Vec;
 
   [[nodiscard]] inline const Vec3& getVector() const { return toSubVec<3>(); }
-  [[nodiscard]] inline Mat3        getRotationMatrix()
+  [[nodiscard]] inline Mat3        getRotationMatrix() const
   {
     float x2 = x() * x();
     float y2 = y() * y();
@@ -77,7 +77,7 @@ public:
   }
 };
 
-Quaternion operator*( const Quaternion& q00, const Quaternion& q01 )
+inline Quaternion operator*( const Quaternion& q00, const Quaternion& q01 )
 {
   return Quaternion{
     q00.x() * q01.w() + q00.y() * q01.z() - q00.z() * q01.y() + q00.w() * q01.x(),
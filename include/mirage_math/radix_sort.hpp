@@ -0,0 +1,138 @@
+#pragma once
+
+#include "job_system.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Maps a float to an unsigned key with the same ordering: negative values have all bits flipped so
+// larger magnitudes sort first, positive values only get the sign bit set
+inline uint32_t toSortableKey( float value )
+{
+  const auto bits = std::bit_cast<uint32_t>( value );
+  const auto mask = static_cast<uint32_t>( -static_cast<int32_t>( bits >> 31 ) ) | 0x80000000U;
+  return bits ^ mask;
+}
+
+inline float fromSortableKey( uint32_t key )
+{
+  const uint32_t mask = ( ( key >> 31 ) - 1 ) | 0x80000000U;
+  return std::bit_cast<float>( key ^ mask );
+}
+
+struct RadixSortOptions
+{
+  // Inputs with at least this many elements are split across threads
+  size_t parallelThreshold = size_t{ 1 } << 16;
+  // Elements per chunk of a split input; every chunk keeps its own digit histogram
+  size_t grainSize = size_t{ 1 } << 14;
+  // nullptr for defaultJobSystem()
+  JobSystem* jobSystem{};
+};
+
+// Stable LSD radix sort of keys with their values, 8 bits per pass. Every pass counts digits per
+// chunk in parallel, turns the counts into per-chunk output offsets and scatters the chunks in
+// parallel; passes whose digit is the same for every key are skipped. Scratch spans must be at
+// least as large as the input, and the result always ends up in keys/values.
+inline void radixSort( std::span<uint32_t> keys,
+  std::span<uint32_t>                      values,
+  std::span<uint32_t>                      scratch_keys,
+  std::span<uint32_t>                      scratch_values,
+  const RadixSortOptions&                  options = {} )
+{
+  constexpr size_t RADIX_BITS = 8;
+  constexpr size_t RADIX      = size_t{ 1 } << RADIX_BITS;
+  using Histogram             = std::array<uint32_t, RADIX>;
+
+  const size_t count = keys.size();
+  assert( values.size() == count && scratch_keys.size() >= count && scratch_values.size() >= count );
+
+  size_t chunk_count = 1;
+  if ( count >= options.parallelThreshold )
+  {
+    const size_t grain = std::max( options.grainSize, size_t{ 1 } );
+    chunk_count        = std::max( ( count + grain - 1 ) / grain, size_t{ 1 } );
+  }
+  const size_t chunk_size = ( count + chunk_count - 1 ) / chunk_count;
+
+  JobSystem& jobs           = options.jobSystem != nullptr ? *options.jobSystem : defaultJobSystem();
+  const auto for_each_chunk = [&jobs, chunk_count, chunk_size, count]( auto&& function ) {
+    jobs.parallelFor( 0, chunk_count, 1, [&function, chunk_size, count]( size_t first_chunk, size_t last_chunk ) {
+      for ( size_t chunk = first_chunk; chunk != last_chunk; ++chunk )
+      {
+        function( chunk, std::min( chunk * chunk_size, count ), std::min( ( chunk + 1 ) * chunk_size, count ) );
+      }
+    } );
+  };
+
+  std::span<uint32_t>    source_keys    = keys;
+  std::span<uint32_t>    source_values  = values;
+  std::span<uint32_t>    target_keys    = scratch_keys.first( count );
+  std::span<uint32_t>    target_values  = scratch_values.first( count );
+  std::vector<Histogram> histograms( chunk_count );
+  for ( size_t shift = 0; shift != 32; shift += RADIX_BITS )
+  {
+    for_each_chunk( [&]( size_t chunk, size_t begin, size_t end ) {
+      Histogram& histogram = histograms[chunk];
+      histogram.fill( 0 );
+      for ( size_t i = begin; i != end; ++i )
+      {
+        ++histogram[( source_keys[i] >> shift ) & ( RADIX - 1 )];
+      }
+    } );
+
+    // Exclusive prefix over ( digit, chunk ) so every chunk writes its own run of each digit
+    uint32_t offset = 0;
+    bool     single = false;
+    for ( size_t digit = 0; digit != RADIX; ++digit )
+    {
+      uint32_t digit_count = 0;
+      for ( auto& histogram : histograms )
+      {
+        const uint32_t chunk_digits = histogram[digit];
+        histogram[digit]            = offset + digit_count;
+        digit_count += chunk_digits;
+      }
+      single |= digit_count == count;
+      offset += digit_count;
+    }
+    if ( single )
+    {
+      continue;
+    }
+
+    for_each_chunk( [&]( size_t chunk, size_t begin, size_t end ) {
+      Histogram& histogram = histograms[chunk];
+      for ( size_t i = begin; i != end; ++i )
+      {
+        const uint32_t destination  = histogram[( source_keys[i] >> shift ) & ( RADIX - 1 )]++;
+        target_keys[destination]   = source_keys[i];
+        target_values[destination] = source_values[i];
+      }
+    } );
+    std::swap( source_keys, target_keys );
+    std::swap( source_values, target_values );
+  }
+
+  if ( source_keys.data() != keys.data() )
+  {
+    std::copy( source_keys.begin(), source_keys.end(), keys.begin() );
+    std::copy( source_values.begin(), source_values.end(), values.begin() );
+  }
+}
+
+// Convenience overload that allocates its own scratch
+inline void radixSort( std::span<uint32_t> keys, std::span<uint32_t> values, const RadixSortOptions& options = {} )
+{
+  std::vector<uint32_t> scratch_keys( keys.size() );
+  std::vector<uint32_t> scratch_values( values.size() );
+  radixSort( keys, values, scratch_keys, scratch_values, options );
+}
+
+} // namespace Mirage::Math
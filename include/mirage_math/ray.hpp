@@ -0,0 +1,528 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "bvh.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+
+namespace Mirage::Math {
+
+constexpr uint32_t INVALID_PRIMITIVE = std::numeric_limits<uint32_t>::max();
+
+class Ray
+{
+  Point3 m_origin;
+  Vec3   m_direction;
+  Vec3   m_inverseDirection;
+  float  m_tMin{};
+  float  m_tMax{ std::numeric_limits<float>::infinity() };
+
+public:
+  Ray() = default;
+  Ray( const Point3& origin,
+    const Vec3&      direction,
+    float            t_min = 0.0F,
+    float            t_max = std::numeric_limits<float>::infinity() )
+    : m_origin( origin ),
+      m_direction( direction ),
+      m_inverseDirection( 1.0F / direction.x(), 1.0F / direction.y(), 1.0F / direction.z() ),
+      m_tMin( t_min ),
+      m_tMax( t_max )
+  {}
+
+  [[nodiscard]] inline const Point3& origin() const { return m_origin; }
+  [[nodiscard]] inline const Vec3&   direction() const { return m_direction; }
+  [[nodiscard]] inline const Vec3&   inverseDirection() const { return m_inverseDirection; }
+  [[nodiscard]] inline float         tMin() const { return m_tMin; }
+  [[nodiscard]] inline float         tMax() const { return m_tMax; }
+
+  inline void setTMax( float t_max ) { m_tMax = t_max; }
+
+  [[nodiscard]] inline Point3 at( float t ) const { return m_origin + m_direction * t; }
+};
+
+struct TriangleHit
+{
+  float t{};
+  float u{}; // Barycentric weight of the second vertex
+  float v{}; // Barycentric weight of the third vertex
+};
+
+// Slab test; returns the parametric distance at which the ray enters the box, clamped to tMin
+inline std::optional<float> getIntersection( const Ray& ray, const AABB& box )
+{
+  float t_near = ray.tMin();
+  float t_far  = ray.tMax();
+  for ( size_t axis = 0; axis != 3; ++axis )
+  {
+    const float t0 = ( box.min()[axis] - ray.origin()[axis] ) * ray.inverseDirection()[axis];
+    const float t1 = ( box.max()[axis] - ray.origin()[axis] ) * ray.inverseDirection()[axis];
+    t_near         = std::max( t_near, std::min( t0, t1 ) );
+    t_far          = std::min( t_far, std::max( t0, t1 ) );
+  }
+  return t_near <= t_far ? std::optional{ t_near } : std::nullopt;
+}
+
+// Möller-Trumbore. Fast, but rays through a shared edge may miss both neighbouring triangles.
+inline std::optional<TriangleHit> getIntersection( const Ray& ray, const Point3& a, const Point3& b, const Point3& c )
+{
+  const Vec3  e1  = b - a;
+  const Vec3  e2  = c - a;
+  const Vec3  p   = cross( ray.direction(), e2 );
+  const float det = dot( e1, p );
+  if ( std::fabs( det ) <= FLOAT_MIN )
+  {
+    return std::nullopt;
+  }
+
+  const float inv_det = 1.0F / det;
+  const Vec3  s       = ray.origin() - a;
+  const float u       = dot( s, p ) * inv_det;
+  const Vec3  q       = cross( s, e1 );
+  const float v       = dot( ray.direction(), q ) * inv_det;
+  const float t       = dot( e2, q ) * inv_det;
+
+  const bool hit = u >= 0.0F && v >= 0.0F && u + v <= 1.0F && t >= ray.tMin() && t <= ray.tMax();
+  return hit ? std::optional{ TriangleHit{ t, u, v } } : std::nullopt;
+}
+
+// Ray direction of the watertight triangle test: kz is its dominant axis, and kx, ky the other two,
+// swapped for negative directions to keep the winding. The shear maps the direction onto +z.
+struct RayShear
+{
+  uint8_t kx{};
+  uint8_t ky{};
+  uint8_t kz{};
+  float   sx{};
+  float   sy{};
+  float   sz{};
+};
+
+inline RayShear makeRayShear( const Vec3& direction )
+{
+  size_t kz = std::fabs( direction.x() ) > std::fabs( direction.y() ) ? 0 : 1;
+  kz        = std::fabs( direction[kz] ) > std::fabs( direction.z() ) ? kz : 2;
+  size_t kx = ( kz + 1 ) % 3;
+  size_t ky = ( kx + 1 ) % 3;
+  if ( direction[kz] < 0.0F )
+  {
+    std::swap( kx, ky );
+  }
+
+  return RayShear{ static_cast<uint8_t>( kx ),
+    static_cast<uint8_t>( ky ),
+    static_cast<uint8_t>( kz ),
+    direction[kx] / direction[kz],
+    direction[ky] / direction[kz],
+    1.0F / direction[kz] };
+}
+
+// Watertight ray/triangle test (Woop, Benthin and Wald). Edges shared by two triangles are always
+// reported by at least one of them, which matters for lightmap baking and visibility rays.
+inline std::optional<TriangleHit> getIntersectionWatertight( const RayShear& shear,
+  const Point3&                                                              origin,
+  float                                                                      t_min,
+  float                                                                      t_max,
+  const Point3&                                                              a,
+  const Point3&                                                              b,
+  const Point3&                                                              c )
+{
+  const size_t kx = shear.kx;
+  const size_t ky = shear.ky;
+  const size_t kz = shear.kz;
+
+  const Vec3 va = a - origin;
+  const Vec3 vb = b - origin;
+  const Vec3 vc = c - origin;
+
+  const float ax = va[kx] - shear.sx * va[kz];
+  const float ay = va[ky] - shear.sy * va[kz];
+  const float bx = vb[kx] - shear.sx * vb[kz];
+  const float by = vb[ky] - shear.sy * vb[kz];
+  const float cx = vc[kx] - shear.sx * vc[kz];
+  const float cy = vc[ky] - shear.sy * vc[kz];
+
+  float u = cx * by - cy * bx;
+  float v = ax * cy - ay * cx;
+  float w = bx * ay - by * ax;
+
+  // Exactly on an edge in single precision: settle the sign in double precision
+  if ( u == 0.0F || v == 0.0F || w == 0.0F )
+  {
+    u = static_cast<float>( static_cast<double>( cx ) * by - static_cast<double>( cy ) * bx );
+    v = static_cast<float>( static_cast<double>( ax ) * cy - static_cast<double>( ay ) * cx );
+    w = static_cast<float>( static_cast<double>( bx ) * ay - static_cast<double>( by ) * ax );
+  }
+
+  if ( ( u < 0.0F || v < 0.0F || w < 0.0F ) && ( u > 0.0F || v > 0.0F || w > 0.0F ) )
+  {
+    return std::nullopt;
+  }
+
+  const float det = u + v + w;
+  if ( det == 0.0F )
+  {
+    return std::nullopt;
+  }
+
+  const float t_scaled = u * shear.sz * va[kz] + v * shear.sz * vb[kz] + w * shear.sz * vc[kz];
+  const float inv_det  = 1.0F / det;
+  const float t        = t_scaled * inv_det;
+  if ( t < t_min || t > t_max )
+  {
+    return std::nullopt;
+  }
+
+  return TriangleHit{ t, v * inv_det, w * inv_det };
+}
+
+inline std::optional<TriangleHit> getIntersectionWatertight(
+  const Ray& ray, const Point3& a, const Point3& b, const Point3& c )
+{
+  return getIntersectionWatertight( makeRayShear( ray.direction() ), ray.origin(), ray.tMin(), ray.tMax(), a, b, c );
+}
+
+// Rays stored one component per array so every operation below runs across all lanes at once.
+// Widths of 4, 8 and 16 match SSE, AVX2 and AVX-512 registers; the lane loops are fixed-trip-count
+// and branch-free so the compiler maps them onto whichever of those the target provides. The
+// RayShear of every lane is kept in shearAxes ( kx, ky, kz ) and shear ( sx, sy, sz ).
+template<size_t Width>
+  requires( Width <= 32 )
+struct RayPacket
+{
+  std::array<std::array<float, Width>, 3>    origin{};
+  std::array<std::array<float, Width>, 3>    direction{};
+  std::array<std::array<float, Width>, 3>    inverseDirection{};
+  std::array<float, Width>                   tMin{};
+  std::array<float, Width>                   tMax{};
+  std::array<std::array<uint32_t, Width>, 3> shearAxes{};
+  std::array<std::array<float, Width>, 3>    shear{};
+
+  static constexpr uint32_t ALL_LANES = Width == 32 ? ~0U : ( 1U << Width ) - 1U;
+
+  // Lanes past the end of rays are filled with rays that can never hit anything
+  static RayPacket fromRays( std::span<const Ray> rays )
+  {
+    assert( !rays.empty() && rays.size() <= Width );
+
+    RayPacket packet;
+    for ( size_t lane = 0; lane != Width; ++lane )
+    {
+      const bool active = lane < rays.size();
+      const Ray& ray    = rays[active ? lane : 0];
+      for ( size_t axis = 0; axis != 3; ++axis )
+      {
+        packet.origin[axis][lane]           = ray.origin()[axis];
+        packet.direction[axis][lane]        = ray.direction()[axis];
+        packet.inverseDirection[axis][lane] = ray.inverseDirection()[axis];
+      }
+      packet.tMin[lane] = ray.tMin();
+      packet.tMax[lane] = active ? ray.tMax() : -std::numeric_limits<float>::infinity();
+
+      const RayShear shear      = makeRayShear( ray.direction() );
+      packet.shearAxes[0][lane] = shear.kx;
+      packet.shearAxes[1][lane] = shear.ky;
+      packet.shearAxes[2][lane] = shear.kz;
+      packet.shear[0][lane]     = shear.sx;
+      packet.shear[1][lane]     = shear.sy;
+      packet.shear[2][lane]     = shear.sz;
+    }
+    return packet;
+  }
+};
+
+using RayPacket4  = RayPacket<4>;
+using RayPacket8  = RayPacket<8>;
+using RayPacket16 = RayPacket<16>;
+
+template<size_t Width>
+struct PacketHit
+{
+  std::array<float, Width>    t{};
+  std::array<float, Width>    u{};
+  std::array<float, Width>    v{};
+  std::array<uint32_t, Width> primitive{};
+
+  PacketHit()
+  {
+    t.fill( std::numeric_limits<float>::infinity() );
+    primitive.fill( INVALID_PRIMITIVE );
+  }
+};
+
+// Slab test for every lane; writes the entry distances to t_near and returns the mask of lanes that hit
+template<size_t Width>
+inline uint32_t intersect( const RayPacket<Width>& packet, const AABB& box, std::array<float, Width>& t_near )
+{
+  std::array<float, Width> t_far = packet.tMax;
+  t_near                         = packet.tMin;
+  for ( size_t axis = 0; axis != 3; ++axis )
+  {
+    const float box_min = box.min()[axis];
+    const float box_max = box.max()[axis];
+    for ( size_t lane = 0; lane != Width; ++lane )
+    {
+      const float t0 = ( box_min - packet.origin[axis][lane] ) * packet.inverseDirection[axis][lane];
+      const float t1 = ( box_max - packet.origin[axis][lane] ) * packet.inverseDirection[axis][lane];
+      t_near[lane]   = std::max( t_near[lane], std::min( t0, t1 ) );
+      t_far[lane]    = std::min( t_far[lane], std::max( t0, t1 ) );
+    }
+  }
+
+  uint32_t mask = 0;
+  for ( size_t lane = 0; lane != Width; ++lane )
+  {
+    mask |= static_cast<uint32_t>( t_near[lane] <= t_far[lane] ) << lane;
+  }
+  return mask;
+}
+
+// Component axis of ( x, y, z ) as selects, which vectorize where an indexed load would not
+inline float selectAxis( float x, float y, float z, uint32_t axis )
+{
+  return axis == 0 ? x : ( axis == 1 ? y : z );
+}
+
+// The watertight test of getIntersectionWatertight() across all lanes, with the same arithmetic so
+// packets and single rays agree on shared edges. Lanes that hit closer than their current tMax get
+// their tMax, hit record and primitive id updated. Returns the mask of updated lanes.
+template<size_t Width>
+inline uint32_t intersect( RayPacket<Width>& packet,
+  PacketHit<Width>&                          hit,
+  const Point3&                              a,
+  const Point3&                              b,
+  const Point3&                              c,
+  uint32_t                                   primitive )
+{
+  // Vertices relative to the origin in the sheared frame of each lane
+  std::array<float, Width> ax, ay, az, bx, by, bz, cx, cy, cz;
+  std::array<float, Width> u, v, w;
+  uint32_t                 on_edge = 0;
+  for ( size_t lane = 0; lane != Width; ++lane )
+  {
+    const uint32_t kx = packet.shearAxes[0][lane];
+    const uint32_t ky = packet.shearAxes[1][lane];
+    const uint32_t kz = packet.shearAxes[2][lane];
+    const float    ox = selectAxis( packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane], kx );
+    const float    oy = selectAxis( packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane], ky );
+    const float    oz = selectAxis( packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane], kz );
+    const float    sx = packet.shear[0][lane];
+    const float    sy = packet.shear[1][lane];
+
+    az[lane] = selectAxis( a.x(), a.y(), a.z(), kz ) - oz;
+    bz[lane] = selectAxis( b.x(), b.y(), b.z(), kz ) - oz;
+    cz[lane] = selectAxis( c.x(), c.y(), c.z(), kz ) - oz;
+    ax[lane] = ( selectAxis( a.x(), a.y(), a.z(), kx ) - ox ) - sx * az[lane];
+    ay[lane] = ( selectAxis( a.x(), a.y(), a.z(), ky ) - oy ) - sy * az[lane];
+    bx[lane] = ( selectAxis( b.x(), b.y(), b.z(), kx ) - ox ) - sx * bz[lane];
+    by[lane] = ( selectAxis( b.x(), b.y(), b.z(), ky ) - oy ) - sy * bz[lane];
+    cx[lane] = ( selectAxis( c.x(), c.y(), c.z(), kx ) - ox ) - sx * cz[lane];
+    cy[lane] = ( selectAxis( c.x(), c.y(), c.z(), ky ) - oy ) - sy * cz[lane];
+
+    u[lane]  = cx[lane] * by[lane] - cy[lane] * bx[lane];
+    v[lane]  = ax[lane] * cy[lane] - ay[lane] * cx[lane];
+    w[lane]  = bx[lane] * ay[lane] - by[lane] * ax[lane];
+    on_edge |= static_cast<uint32_t>( ( u[lane] == 0.0F ) | ( v[lane] == 0.0F ) | ( w[lane] == 0.0F ) ) << lane;
+  }
+
+  // Exactly on an edge in single precision: settle the sign in double precision. Rare enough to be
+  // worth a branch for the whole packet rather than double precision in every lane.
+  if ( on_edge != 0 )
+  {
+    for ( size_t lane = 0; lane != Width; ++lane )
+    {
+      const bool   redo = ( ( on_edge >> lane ) & 1U ) != 0;
+      const double dax  = ax[lane];
+      const double day  = ay[lane];
+      const double dbx  = bx[lane];
+      const double dby  = by[lane];
+      const double dcx  = cx[lane];
+      const double dcy  = cy[lane];
+      u[lane]           = redo ? static_cast<float>( dcx * dby - dcy * dbx ) : u[lane];
+      v[lane]           = redo ? static_cast<float>( dax * dcy - day * dcx ) : v[lane];
+      w[lane]           = redo ? static_cast<float>( dbx * day - dby * dax ) : w[lane];
+    }
+  }
+
+  uint32_t mask = 0;
+  for ( size_t lane = 0; lane != Width; ++lane )
+  {
+    const float sz       = packet.shear[2][lane];
+    const float det      = u[lane] + v[lane] + w[lane];
+    const float t_scaled = u[lane] * sz * az[lane] + v[lane] * sz * bz[lane] + w[lane] * sz * cz[lane];
+    const float inv_det  = 1.0F / det;
+    const float t        = t_scaled * inv_det;
+
+    const bool mixed_signs = ( ( u[lane] < 0.0F ) | ( v[lane] < 0.0F ) | ( w[lane] < 0.0F ) )
+                             & ( ( u[lane] > 0.0F ) | ( v[lane] > 0.0F ) | ( w[lane] > 0.0F ) );
+    const bool accept = !mixed_signs & ( det != 0.0F ) & ( t >= packet.tMin[lane] ) & ( t < packet.tMax[lane] );
+
+    packet.tMax[lane]    = accept ? t : packet.tMax[lane];
+    hit.t[lane]          = accept ? t : hit.t[lane];
+    hit.u[lane]          = accept ? v[lane] * inv_det : hit.u[lane];
+    hit.v[lane]          = accept ? w[lane] * inv_det : hit.v[lane];
+    hit.primitive[lane]  = accept ? primitive : hit.primitive[lane];
+    mask                |= static_cast<uint32_t>( accept ) << lane;
+  }
+  return mask;
+}
+
+struct MeshHit
+{
+  TriangleHit triangle;
+  uint32_t    primitive{ INVALID_PRIMITIVE };
+};
+
+// Closest hit against an indexed triangle mesh whose BVH was built from makeTriangleBounds.
+// Near children are visited first so tMax shrinks as early as possible.
+inline std::optional<MeshHit> intersect(
+  const BVH& bvh, std::span<const Point3> positions, std::span<const uint32_t> indices, Ray ray )
+{
+  if ( bvh.isEmpty() )
+  {
+    return std::nullopt;
+  }
+
+  struct Entry
+  {
+    uint32_t node;
+    float    t;
+  };
+
+  const auto root_entry = getIntersection( ray, bvh.nodes()[0].bounds() );
+  if ( !root_entry )
+  {
+    return std::nullopt;
+  }
+
+  // The same for every triangle tested
+  const RayShear                        shear = makeRayShear( ray.direction() );
+  MeshHit                               closest;
+  std::array<Entry, BVH::MAX_DEPTH + 1> stack{ Entry{ 0, *root_entry } };
+  size_t                                stack_size = 1;
+  while ( stack_size != 0 )
+  {
+    const Entry entry = stack[--stack_size];
+
+    // The box was hit when it was pushed, but a closer triangle may have been found since
+    if ( entry.t > ray.tMax() )
+    {
+      continue;
+    }
+
+    const BVHNode& node = bvh.nodes()[entry.node];
+    if ( node.isLeaf() )
+    {
+      for ( uint32_t i = node.leftFirst; i != node.leftFirst + node.count; ++i )
+      {
+        const uint32_t primitive = bvh.primitiveIndices()[i];
+        const auto     hit       = getIntersectionWatertight( shear,
+          ray.origin(),
+          ray.tMin(),
+          ray.tMax(),
+          positions[indices[primitive * 3]],
+          positions[indices[primitive * 3 + 1]],
+          positions[indices[primitive * 3 + 2]] );
+        if ( hit )
+        {
+          closest = MeshHit{ *hit, primitive };
+          ray.setTMax( hit->t );
+        }
+      }
+      continue;
+    }
+
+    const auto left  = getIntersection( ray, bvh.nodes()[node.leftFirst].bounds() );
+    const auto right = getIntersection( ray, bvh.nodes()[node.leftFirst + 1].bounds() );
+    if ( left && right )
+    {
+      // Push the far child first so the near one is popped next
+      const bool left_is_near = *left <= *right;
+      stack[stack_size++] = left_is_near ? Entry{ node.leftFirst + 1, *right } : Entry{ node.leftFirst, *left };
+      stack[stack_size++] = left_is_near ? Entry{ node.leftFirst, *left } : Entry{ node.leftFirst + 1, *right };
+    } else if ( left )
+    {
+      stack[stack_size++] = Entry{ node.leftFirst, *left };
+    } else if ( right )
+    {
+      stack[stack_size++] = Entry{ node.leftFirst + 1, *right };
+    }
+  }
+
+  return closest.primitive != INVALID_PRIMITIVE ? std::optional{ closest } : std::nullopt;
+}
+
+// Packet traversal: a node is visited while any lane still overlaps it, and each triangle is tested
+// against all lanes together. Coherent packets (camera, lightmap texel neighbourhoods) share most of
+// their traversal, which is where the win over single rays comes from.
+template<size_t Width>
+inline PacketHit<Width> intersect( const BVH& bvh,
+  std::span<const Point3>                     positions,
+  std::span<const uint32_t>                   indices,
+  RayPacket<Width>&                           packet )
+{
+  PacketHit<Width> hit;
+  if ( bvh.isEmpty() )
+  {
+    return hit;
+  }
+
+  std::array<float, Width>                 t_near{};
+  std::array<uint32_t, BVH::MAX_DEPTH + 1> stack{};
+  size_t                                   stack_size = 1;
+  while ( stack_size != 0 )
+  {
+    const BVHNode& node = bvh.nodes()[stack[--stack_size]];
+
+    if ( intersect( packet, node.bounds(), t_near ) == 0 )
+    {
+      continue;
+    }
+
+    if ( node.isLeaf() )
+    {
+      for ( uint32_t i = node.leftFirst; i != node.leftFirst + node.count; ++i )
+      {
+        const uint32_t primitive = bvh.primitiveIndices()[i];
+        intersect( packet,
+          hit,
+          positions[indices[primitive * 3]],
+          positions[indices[primitive * 3 + 1]],
+          positions[indices[primitive * 3 + 2]],
+          primitive );
+      }
+      continue;
+    }
+
+    // Order children by the direction of the first lane along the axis that separates them most
+    const BVHNode& left  = bvh.nodes()[node.leftFirst];
+    const BVHNode& right = bvh.nodes()[node.leftFirst + 1];
+    size_t         axis  = 0;
+    float          best  = -1.0F;
+    for ( size_t k = 0; k != 3; ++k )
+    {
+      const float separation
+        = std::fabs( ( left.boundsMin[k] + left.boundsMax[k] ) - ( right.boundsMin[k] + right.boundsMax[k] ) );
+      if ( separation > best )
+      {
+        best = separation;
+        axis = k;
+      }
+    }
+    const bool left_is_near
+      = ( left.boundsMin[axis] < right.boundsMin[axis] ) == ( packet.direction[axis][0] >= 0.0F );
+    stack[stack_size++] = left_is_near ? node.leftFirst + 1 : node.leftFirst;
+    stack[stack_size++] = left_is_near ? node.leftFirst : node.leftFirst + 1;
+  }
+  return hit;
+}
+
+} // namespace Mirage::Math
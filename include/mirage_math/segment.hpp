@@ -0,0 +1,122 @@
+#pragma once
+
+#include "batch.hpp"
+#include "line.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <span>
+
+namespace Mirage::Math {
+
+// Segment from start to end, parameterized as start + t * vector() for t in [0, 1]
+class Segment
+{
+  Point3 m_start;
+  Point3 m_end;
+
+public:
+  Segment() = default;
+  Segment( const Point3& start, const Point3& end ) : m_start( start ), m_end( end ) {}
+
+  [[nodiscard]] inline const Point3& start() const { return m_start; }
+  [[nodiscard]] inline const Point3& end() const { return m_end; }
+  [[nodiscard]] inline Vec3          vector() const { return m_end - m_start; }
+  [[nodiscard]] inline Line          line() const { return Line{ m_start, vector() }; }
+  [[nodiscard]] inline Point3        at( float t ) const { return m_start + t * vector(); }
+};
+
+// Segments for the batched queries, one stream per component
+struct SoASegment
+{
+  SoAVec3 start;
+  SoAVec3 end;
+
+  [[nodiscard]] inline size_t size() const
+  {
+    assert( start.size() == end.size() );
+    return start.size();
+  }
+
+  [[nodiscard]] inline Segment operator[]( size_t i ) const
+  {
+    return Segment{
+      Point3{ start.x[i], start.y[i], start.z[i] },
+      Point3{ end.x[i], end.y[i], end.z[i] }
+    };
+  }
+};
+
+inline float closestParameter( const Segment& segment, const Point3& point )
+{
+  const Vec3  vector = segment.vector();
+  const float length = dot( vector, vector );
+  return std::clamp( dot( point - segment.start(), vector ) / safeDivisor( length, length > FLOAT_MIN ), 0.0F, 1.0F );
+}
+
+inline Point3 closestPoint( const Segment& segment, const Point3& point )
+{
+  return segment.at( closestParameter( segment, point ) );
+}
+
+inline float distance( const Point3& point, const Segment& segment )
+{
+  return magnitude( point - closestPoint( segment, point ) );
+}
+
+// Closest parameters of two segments, both in [0, 1] (Ericson, Real-Time Collision Detection 5.1.9).
+// Instead of branching on which constraint is active, t is clamped and s recomputed from it: when the
+// unclamped t was already in range this reproduces s, so the result is the same for every case and
+// the function can run inside batched loops. Degenerate (point) segments get parameter 0.
+inline ClosestParameters closestParameters( const Segment& segment_a, const Segment& segment_b )
+{
+  const Vec3 d1 = segment_a.vector();
+  const Vec3 d2 = segment_b.vector();
+  const Vec3 r  = segment_a.start() - segment_b.start();
+
+  const float a     = dot( d1, d1 );
+  const float e     = dot( d2, d2 );
+  const float b     = dot( d1, d2 );
+  const float c     = dot( d1, r );
+  const float f     = dot( d2, r );
+  const float denom = a * e - b * b;
+
+  const bool a_valid     = a > FLOAT_MIN;
+  const bool e_valid     = e > FLOAT_MIN;
+  const bool denom_valid = denom > FLOAT_MIN;
+
+  // Parallel segments have no unique pair, any s works and 0 is picked
+  const float s0 = std::clamp( ( b * f - c * e ) / safeDivisor( denom, denom_valid ), 0.0F, 1.0F )
+                   * static_cast<float>( denom_valid );
+  const float t = std::clamp( ( b * s0 + f ) / safeDivisor( e, e_valid ), 0.0F, 1.0F ) * static_cast<float>( e_valid );
+  const float s = std::clamp( ( b * t - c ) / safeDivisor( a, a_valid ), 0.0F, 1.0F ) * static_cast<float>( a_valid );
+  return ClosestParameters{ s, t };
+}
+
+inline float distanceSquared( const Segment& segment_a, const Segment& segment_b )
+{
+  const ClosestParameters parameters = closestParameters( segment_a, segment_b );
+  return magnitudeSquared( segment_b.at( parameters.t2 ) - segment_a.at( parameters.t1 ) );
+}
+
+inline float distance( const Segment& segment_a, const Segment& segment_b )
+{
+  return std::sqrt( distanceSquared( segment_a, segment_b ) );
+}
+
+// Pairwise closest parameters of two segment streams
+inline void getClosestParameters(
+  const SoASegment& segments_a, const SoASegment& segments_b, std::span<float> t1, std::span<float> t2 )
+{
+  assert( segments_a.size() == segments_b.size() && t1.size() >= segments_a.size() && t2.size() >= segments_a.size() );
+  for ( size_t i = 0; i != segments_a.size(); ++i )
+  {
+    const ClosestParameters parameters = closestParameters( segments_a[i], segments_b[i] );
+    t1[i]                              = parameters.t1;
+    t2[i]                              = parameters.t2;
+  }
+}
+
+} // namespace Mirage::Math
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Mirage::Math {
+
+// Uniform grid over an unbounded domain. Occupied cells live in a flat open-addressing table and the
+// entries of every cell are stored contiguously in one shared array, so a rebuild performs no
+// per-cell allocations and reuses the storage of the previous step. Boxes are stored in every cell
+// they overlap; a cell size around the typical entry size keeps that to a few cells each.
+class SpatialHash
+{
+  struct Slot
+  {
+    IVec3    cell;
+    uint32_t first{};
+    // Zero marks an empty slot, occupied cells hold at least one entry
+    uint32_t count{};
+  };
+
+  // Entries are stored in cell order together with everything the queries read, so walking a cell
+  // touches one contiguous range
+  struct Entry
+  {
+    AABB     bounds;
+    // First cell of the entry, the one holding the min corner of its bounds
+    IVec3    home;
+    uint32_t id{};
+  };
+
+  struct CellRange
+  {
+    IVec3 min;
+    IVec3 max;
+  };
+
+  float              m_cellSize{ 1.0F };
+  float              m_inverseCellSize{ 1.0F };
+  size_t             m_cellCount{};
+  size_t             m_size{};
+  std::vector<Slot>  m_slots;
+  std::vector<Entry> m_entries;
+
+  static inline bool isSameCell( const IVec3& a, const IVec3& b )
+  {
+    return a.x() == b.x() && a.y() == b.y() && a.z() == b.z();
+  }
+
+  static inline size_t hash( const IVec3& cell )
+  {
+    // Teschner et al.'s primes on y and z only: cells adjacent in x land in adjacent slots, so the
+    // rows of a neighborhood walk touch a third of the cache lines
+    return ( ( static_cast<uint32_t>( cell.y() ) * 19349663U ) ^ ( static_cast<uint32_t>( cell.z() ) * 83492791U ) )
+           + static_cast<uint32_t>( cell.x() );
+  }
+
+  template<typename Function>
+  static inline void forEachCell( const CellRange& range, Function&& function )
+  {
+    for ( int z = range.min.z(); z <= range.max.z(); ++z )
+    {
+      for ( int y = range.min.y(); y <= range.max.y(); ++y )
+      {
+        for ( int x = range.min.x(); x <= range.max.x(); ++x )
+        {
+          function( IVec3{ x, y, z } );
+        }
+      }
+    }
+  }
+
+  // Slot holding cell, or the empty slot where it would be inserted. The table is kept at most half
+  // full, so probing always terminates.
+  [[nodiscard]] inline size_t findSlot( const IVec3& cell ) const
+  {
+    const size_t mask = m_slots.size() - 1;
+    for ( size_t slot = hash( cell ) & mask;; slot = ( slot + 1 ) & mask )
+    {
+      if ( m_slots[slot].count == 0 || isSameCell( m_slots[slot].cell, cell ) )
+      {
+        return slot;
+      }
+    }
+  }
+
+  [[nodiscard]] inline CellRange cellRange( const AABB& box ) const
+  {
+    return CellRange{ cellOf( box.min() ), cellOf( box.max() ) };
+  }
+
+  // Counting sort of the entries into their cells: count per cell, prefix sum, scatter
+  template<typename BoundsOf>
+  void build( size_t count, BoundsOf&& bounds_of )
+  {
+    m_size                 = count;
+    size_t reference_count = 0;
+    for ( size_t i = 0; i != count; ++i )
+    {
+      const CellRange range = cellRange( bounds_of( i ) );
+      reference_count += static_cast<size_t>( range.max.x() - range.min.x() + 1 )
+                         * static_cast<size_t>( range.max.y() - range.min.y() + 1 )
+                         * static_cast<size_t>( range.max.z() - range.min.z() + 1 );
+    }
+
+    m_slots.assign( std::bit_ceil( std::max( reference_count * 2, size_t{ 16 } ) ), Slot{} );
+    m_cellCount = 0;
+    for ( size_t i = 0; i != count; ++i )
+    {
+      forEachCell( cellRange( bounds_of( i ) ), [this]( const IVec3& cell ) {
+        Slot& slot = m_slots[findSlot( cell )];
+        if ( slot.count == 0 )
+        {
+          slot.cell = cell;
+          ++m_cellCount;
+        }
+        ++slot.count;
+      } );
+    }
+
+    uint32_t offset = 0;
+    for ( auto& slot : m_slots )
+    {
+      slot.first = offset;
+      offset += slot.count;
+    }
+
+    // first doubles as the write cursor of each cell and is rewound afterwards
+    m_entries.resize( reference_count );
+    for ( uint32_t i = 0; i != count; ++i )
+    {
+      const AABB      bounds = bounds_of( i );
+      const CellRange range  = cellRange( bounds );
+      forEachCell( range, [&]( const IVec3& cell ) {
+        m_entries[m_slots[findSlot( cell )].first++] = Entry{ bounds, range.min, i };
+      } );
+    }
+    for ( auto& slot : m_slots )
+    {
+      slot.first -= slot.count;
+    }
+  }
+
+  // Calls visitor( entry ) once for every entry stored in a cell of region. Entries spanning several
+  // cells are reported from the first of their cells that lies in the region.
+  template<typename Visitor>
+  void visit( const AABB& region, Visitor&& visitor ) const
+  {
+    if ( m_slots.empty() )
+    {
+      return;
+    }
+
+    const CellRange range = cellRange( region );
+    forEachCell( range, [&]( const IVec3& cell ) {
+      const Slot& slot = m_slots[findSlot( cell )];
+      for ( uint32_t i = slot.first; i != slot.first + slot.count; ++i )
+      {
+        const Entry& entry = m_entries[i];
+        if ( isSameCell( max( range.min, entry.home ), cell ) )
+        {
+          visitor( entry );
+        }
+      }
+    } );
+  }
+
+public:
+  SpatialHash() = default;
+  explicit SpatialHash( float cell_size ) : m_cellSize( cell_size ), m_inverseCellSize( 1.0F / cell_size )
+  {
+    assert( cell_size > 0.0F );
+  }
+
+  [[nodiscard]] inline float  cellSize() const { return m_cellSize; }
+  [[nodiscard]] inline size_t cellCount() const { return m_cellCount; }
+  [[nodiscard]] inline size_t size() const { return m_size; }
+
+  [[nodiscard]] inline IVec3 cellOf( const Point3& point ) const
+  {
+    return IVec3{ static_cast<int>( std::floor( point.x() * m_inverseCellSize ) ),
+      static_cast<int>( std::floor( point.y() * m_inverseCellSize ) ),
+      static_cast<int>( std::floor( point.z() * m_inverseCellSize ) ) };
+  }
+
+  // Replaces the contents with one entry per point or box; entry ids are indices into the input
+  void rebuild( std::span<const Point3> points )
+  {
+    build( points.size(), [points]( size_t i ) { return AABB{ points[i], points[i] }; } );
+  }
+
+  void rebuild( std::span<const AABB> boxes )
+  {
+    build( boxes.size(), [boxes]( size_t i ) { return boxes[i]; } );
+  }
+
+  // Calls callback( id ) for every entry stored in cell, in ascending id order
+  template<typename Callback>
+  void forEachInCell( const IVec3& cell, Callback&& callback ) const
+  {
+    if ( m_slots.empty() )
+    {
+      return;
+    }
+    const Slot& slot = m_slots[findSlot( cell )];
+    for ( uint32_t i = slot.first; i != slot.first + slot.count; ++i )
+    {
+      callback( m_entries[i].id );
+    }
+  }
+
+  // Calls callback( id ) for every entry within radius of center
+  template<typename Callback>
+  void queryRadius( const Point3& center, float radius, Callback&& callback ) const
+  {
+    const AABB  point{ center, center };
+    const float radius_squared = radius * radius;
+    visit( point.expanded( radius ), [&]( const Entry& entry ) {
+      if ( distanceSquared( entry.bounds, point ) <= radius_squared )
+      {
+        callback( entry.id );
+      }
+    } );
+  }
+
+  // Calls callback( id ) for every entry overlapping box
+  template<typename Callback>
+  void queryOverlaps( const AABB& box, Callback&& callback ) const
+  {
+    visit( box, [&]( const Entry& entry ) {
+      if ( overlaps( entry.bounds, box ) )
+      {
+        callback( entry.id );
+      }
+    } );
+  }
+
+  // Calls callback( a, b ) with a < b once for every pair of entries within radius of each other;
+  // a radius of zero reports overlapping boxes. The neighborhood is walked once per cell for all
+  // entries whose home is that cell rather than once per entry.
+  template<typename Callback>
+  void queryPairs( float radius, Callback&& callback ) const
+  {
+    const float        radius_squared = radius * radius;
+    std::vector<Entry> home_entries;
+    for ( const auto& slot : m_slots )
+    {
+      home_entries.clear();
+      AABB region = AABB::empty();
+      for ( uint32_t i = slot.first; i != slot.first + slot.count; ++i )
+      {
+        if ( isSameCell( m_entries[i].home, slot.cell ) )
+        {
+          home_entries.push_back( m_entries[i] );
+          region.expandInPlace( m_entries[i].bounds );
+        }
+      }
+      if ( home_entries.empty() )
+      {
+        continue;
+      }
+
+      visit( region.expanded( radius ), [&]( const Entry& b ) {
+        for ( const auto& a : home_entries )
+        {
+          if ( b.id > a.id && distanceSquared( a.bounds, b.bounds ) <= radius_squared )
+          {
+            callback( a.id, b.id );
+          }
+        }
+      } );
+    }
+  }
+};
+
+} // namespace Mirage::Math
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "batch.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+#include "vec.hpp"
+#include <cmath>
+#include <span>
+
+namespace Mirage::Math {
+
+class Sphere
+{
+  Point3 m_center;
+  float  m_radius{};
+
+public:
+  Sphere() = default;
+  Sphere( const Point3& center, float radius ) : m_center( center ), m_radius( radius ) {}
+
+  [[nodiscard]] inline const Point3& center() const { return m_center; }
+  [[nodiscard]] inline float         radius() const { return m_radius; }
+};
+
+// Candidate spheres for the batched overlap tests, one stream per component
+struct SoASphere
+{
+  SoAVec3                center;
+  std::span<const float> radius;
+
+  [[nodiscard]] inline size_t size() const
+  {
+    assert( center.size() == radius.size() );
+    return radius.size();
+  }
+};
+
+inline bool contains( const Sphere& sphere, const Point3& point )
+{
+  return magnitudeSquared( point - sphere.center() ) <= sphere.radius() * sphere.radius();
+}
+
+inline bool overlaps( const Sphere& a, const Sphere& b )
+{
+  const float radius_sum = a.radius() + b.radius();
+  return magnitudeSquared( b.center() - a.center() ) <= radius_sum * radius_sum;
+}
+
+// The plane is expected to be normalized so dot( Plane, Point3 ) is a signed distance
+inline bool overlaps( const Sphere& sphere, const Plane& plane )
+{
+  return std::fabs( dot( plane, sphere.center() ) ) <= sphere.radius();
+}
+
+// Ritter's bounding sphere: seed from an approximately farthest pair, then grow to cover outliers
+inline Sphere makeBoundingSphere( std::span<const Point3> points )
+{
+  if ( points.empty() )
+  {
+    return Sphere{};
+  }
+
+  const auto farthest_from = [&points]( const Point3& origin ) {
+    const Point3* farthest     = points.data();
+    float         max_distance = -1.0F;
+    for ( const auto& point : points )
+    {
+      const float distance = magnitudeSquared( point - origin );
+      if ( distance > max_distance )
+      {
+        max_distance = distance;
+        farthest     = &point;
+      }
+    }
+    return *farthest;
+  };
+
+  const Point3 a = farthest_from( points.front() );
+  const Point3 b = farthest_from( a );
+
+  Point3 center = a + ( b - a ) * 0.5F;
+  float  radius = magnitude( b - a ) * 0.5F;
+
+  for ( const auto& point : points )
+  {
+    const float distance = magnitude( point - center );
+    if ( distance > radius )
+    {
+      const float new_radius = ( radius + distance ) * 0.5F;
+      center                 = center + ( point - center ) * ( ( new_radius - radius ) / distance );
+      radius                 = new_radius;
+    }
+  }
+
+  return Sphere{ center, radius };
+}
+
+// Tests one query against every candidate and writes one bit per candidate into mask.
+// Returns the number of overlapping candidates.
+inline size_t testOverlaps( const Sphere& query, const SoASphere& candidates, std::span<uint64_t> mask )
+{
+  const float qx = query.center().x();
+  const float qy = query.center().y();
+  const float qz = query.center().z();
+  const float qr = query.radius();
+
+  return fillMask( candidates.size(), mask, [&]( size_t i ) {
+    const float dx         = candidates.center.x[i] - qx;
+    const float dy         = candidates.center.y[i] - qy;
+    const float dz         = candidates.center.z[i] - qz;
+    const float radius_sum = candidates.radius[i] + qr;
+    return dx * dx + dy * dy + dz * dz <= radius_sum * radius_sum;
+  } );
+}
+
+inline size_t testOverlaps( const Plane& plane, const SoASphere& candidates, std::span<uint64_t> mask )
+{
+  return fillMask( candidates.size(), mask, [&]( size_t i ) {
+    const float distance = plane.x() * candidates.center.x[i] + plane.y() * candidates.center.y[i]
+                           + plane.z() * candidates.center.z[i] + plane.w();
+    return std::fabs( distance ) <= candidates.radius[i];
+  } );
+}
+
+} // namespace Mirage::Math
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace Mirage::Math {
+
+// Views of external float buffers, such as interleaved vertex buffers or mapped files, as ranges of
+// Vec/Point3. Element i starts stride bytes after element i - 1 and is copied in and out with
+// memcpy, so the buffer needs neither the alignment of the element type nor to hold objects of it.
+
+template<typename T>
+concept StridedElement = std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+                         && sizeof( T ) % sizeof( float ) == 0;
+
+// Assignable reference to an element of a mutable StridedSpan
+template<StridedElement T>
+class StridedRef
+{
+  std::byte* m_data;
+
+public:
+  explicit StridedRef( std::byte* data ) : m_data( data ) {}
+  StridedRef( const StridedRef& ) = default;
+
+  [[nodiscard]] inline T get() const
+  {
+    T value;
+    std::memcpy( &value, m_data, sizeof( T ) );
+    return value;
+  }
+
+  inline operator T() const { return get(); }
+
+  inline const StridedRef& operator=( const T& value ) const
+  {
+    std::memcpy( m_data, &value, sizeof( T ) );
+    return *this;
+  }
+
+  // Assigns the referenced value, as for a plain reference
+  inline const StridedRef& operator=( const StridedRef& other ) const { return *this = other.get(); }
+};
+
+// T is the element type, const-qualified for read-only views. Elements of read-only views are
+// returned by value, those of mutable views through StridedRef.
+template<typename T>
+  requires StridedElement<std::remove_const_t<T>>
+class StridedSpan
+{
+  using Byte  = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+  using Float = std::conditional_t<std::is_const_v<T>, const float, float>;
+
+  Byte*  m_data{};
+  size_t m_size{};
+  size_t m_stride{ sizeof( T ) };
+
+public:
+  using value_type = std::remove_const_t<T>;
+  using reference  = std::conditional_t<std::is_const_v<T>, value_type, StridedRef<value_type>>;
+
+  class Iterator
+  {
+    Byte*  m_data{};
+    size_t m_stride{};
+
+  public:
+    // A C++20 random access iterator, but only an input iterator to the C++17 requirements, which
+    // need operator* to return a real reference
+    using iterator_concept  = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = StridedSpan::value_type;
+    using difference_type   = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator( Byte* data, size_t stride ) : m_data( data ), m_stride( stride ) {}
+
+    [[nodiscard]] inline reference operator*() const { return StridedSpan::load( m_data ); }
+    [[nodiscard]] inline reference operator[]( difference_type n ) const { return *( *this + n ); }
+
+    inline Iterator& operator+=( difference_type n )
+    {
+      m_data += n * static_cast<difference_type>( m_stride );
+      return *this;
+    }
+    inline Iterator& operator-=( difference_type n ) { return *this += -n; }
+    inline Iterator& operator++() { return *this += 1; }
+    inline Iterator& operator--() { return *this -= 1; }
+
+    inline Iterator operator++( int )
+    {
+      Iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    inline Iterator operator--( int )
+    {
+      Iterator previous = *this;
+      --*this;
+      return previous;
+    }
+
+    [[nodiscard]] friend inline Iterator operator+( Iterator it, difference_type n ) { return it += n; }
+    [[nodiscard]] friend inline Iterator operator+( difference_type n, Iterator it ) { return it += n; }
+    [[nodiscard]] friend inline Iterator operator-( Iterator it, difference_type n ) { return it -= n; }
+
+    [[nodiscard]] friend inline difference_type operator-( const Iterator& a, const Iterator& b )
+    {
+      assert( a.m_stride == b.m_stride && a.m_stride != 0 );
+      return ( a.m_data - b.m_data ) / static_cast<difference_type>( a.m_stride );
+    }
+
+    [[nodiscard]] friend inline bool operator==( const Iterator& a, const Iterator& b ) { return a.m_data == b.m_data; }
+    [[nodiscard]] friend inline auto operator<=>( const Iterator& a, const Iterator& b )
+    {
+      return a.m_data <=> b.m_data;
+    }
+  };
+
+  StridedSpan() = default;
+
+  // size elements, the first at data and each following one stride bytes further
+  StridedSpan( Float* data, size_t size, size_t stride )
+    : m_data( reinterpret_cast<Byte*>( data ) ), m_size( size ), m_stride( stride )
+  {
+    assert( stride >= sizeof( T ) || size <= 1 );
+  }
+
+  // Contiguous elements, such as a std::vector<Point3>. Explicit so that calls with a contiguous
+  // range keep picking the std::span overloads.
+  template<std::ranges::contiguous_range Range>
+    requires std::ranges::sized_range<Range>
+               && std::is_convertible_v<std::ranges::range_reference_t<Range>, T&>
+               && ( sizeof( std::ranges::range_value_t<Range> ) == sizeof( T ) )
+  explicit StridedSpan( Range&& range )
+    : m_data( reinterpret_cast<Byte*>( std::ranges::data( range ) ) ), m_size( std::ranges::size( range ) )
+  {}
+
+  // Mutable views convert to read-only ones
+  template<typename U>
+    requires( std::is_const_v<T> && std::is_same_v<const U, T> )
+  StridedSpan( const StridedSpan<U>& other )
+    : m_data( reinterpret_cast<Byte*>( other.data() ) ), m_size( other.size() ), m_stride( other.stride() )
+  {}
+
+  [[nodiscard]] inline static reference load( Byte* address )
+  {
+    if constexpr ( std::is_const_v<T> )
+    {
+      value_type value;
+      std::memcpy( &value, address, sizeof( value_type ) );
+      return value;
+    } else
+    {
+      return StridedRef<value_type>{ address };
+    }
+  }
+
+  [[nodiscard]] inline Float* data() const { return reinterpret_cast<Float*>( m_data ); }
+  [[nodiscard]] inline size_t size() const { return m_size; }
+  [[nodiscard]] inline size_t stride() const { return m_stride; }
+  [[nodiscard]] inline bool   empty() const { return m_size == 0; }
+
+  // Whether the elements are packed back to back, as in an array of T
+  [[nodiscard]] inline bool isContiguous() const { return m_stride == sizeof( T ); }
+
+  [[nodiscard]] inline reference operator[]( size_t i ) const
+  {
+    assert( i < m_size );
+    return load( m_data + i * m_stride );
+  }
+
+  [[nodiscard]] inline Iterator begin() const { return Iterator{ m_data, m_stride }; }
+  [[nodiscard]] inline Iterator end() const { return Iterator{ m_data + m_size * m_stride, m_stride }; }
+
+  [[nodiscard]] inline StridedSpan subspan( size_t offset, size_t count ) const
+  {
+    assert( offset + count <= m_size );
+    return StridedSpan{ reinterpret_cast<Float*>( m_data + offset * m_stride ), count, m_stride };
+  }
+
+  [[nodiscard]] inline StridedSpan first( size_t count ) const { return subspan( 0, count ); }
+};
+
+// View of the attribute at byte offset within every stride-byte record of an interleaved buffer, for
+// as many records as the buffer holds
+template<typename T, typename Float>
+  requires std::is_same_v<std::remove_const_t<Float>, float>
+inline StridedSpan<std::conditional_t<std::is_const_v<Float>, const T, T>> makeStridedSpan(
+  std::span<Float> buffer, size_t offset, size_t stride )
+{
+  using Element = std::conditional_t<std::is_const_v<Float>, const T, T>;
+  assert( offset % sizeof( float ) == 0 && stride >= sizeof( T ) );
+
+  const size_t bytes = buffer.size_bytes();
+  const size_t count = bytes >= offset + sizeof( T ) ? ( bytes - offset - sizeof( T ) ) / stride + 1 : 0;
+  return StridedSpan<Element>{ buffer.data() + offset / sizeof( float ), count, stride };
+}
+
+} // namespace Mirage::Math
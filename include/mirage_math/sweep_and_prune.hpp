@@ -0,0 +1,178 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "radix_sort.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace Mirage::Math {
+
+struct OverlapPair
+{
+  uint32_t a{};
+  uint32_t b{};
+};
+
+struct SweepAndPruneOptions
+{
+  // An incremental update gives up on insertion sort after this many element moves per box and
+  // falls back to a full radix sort
+  size_t insertionMovesPerBox = 8;
+
+  RadixSortOptions sort;
+};
+
+// Single-axis sweep and prune. Boxes are kept sorted by their minimum on the sweep axis between
+// updates, so when objects move a little from one step to the next the order is repaired with an
+// insertion sort instead of being sorted from scratch. Box ids are indices into the update input.
+class SweepAndPrune
+{
+  SweepAndPruneOptions m_options;
+  size_t               m_axis{};
+
+  // Box ids in sweep order, and the sortable keys of their minimums on the sweep axis
+  std::vector<uint32_t> m_order;
+  std::vector<uint32_t> m_keys;
+  std::vector<uint32_t> m_scratchKeys;
+  std::vector<uint32_t> m_scratchOrder;
+
+  // Bounds gathered in sweep order, so the sweep reads every stream front to back
+  std::array<std::vector<float>, 3> m_sortedMin;
+  std::array<std::vector<float>, 3> m_sortedMax;
+
+  static size_t chooseAxis( std::span<const AABB> boxes )
+  {
+    std::array<double, 3> sum{};
+    std::array<double, 3> sum_squared{};
+    for ( const auto& box : boxes )
+    {
+      for ( size_t axis = 0; axis != 3; ++axis )
+      {
+        const double center = ( static_cast<double>( box.min()[axis] ) + box.max()[axis] ) * 0.5;
+        sum[axis] += center;
+        sum_squared[axis] += center * center;
+      }
+    }
+
+    std::array<double, 3> variance{};
+    for ( size_t axis = 0; axis != 3; ++axis )
+    {
+      variance[axis] = sum_squared[axis] - sum[axis] * sum[axis] / static_cast<double>( boxes.size() );
+    }
+    return static_cast<size_t>( std::max_element( variance.begin(), variance.end() ) - variance.begin() );
+  }
+
+  // Returns false once the move budget is exhausted, leaving a valid but partially sorted order
+  bool insertionSort()
+  {
+    size_t budget = m_options.insertionMovesPerBox * m_keys.size();
+    for ( size_t i = 1; i < m_keys.size(); ++i )
+    {
+      const uint32_t key = m_keys[i];
+      const uint32_t id  = m_order[i];
+      size_t         j   = i;
+      for ( ; j != 0 && m_keys[j - 1] > key; --j )
+      {
+        if ( budget-- == 0 )
+        {
+          m_keys[j]  = key;
+          m_order[j] = id;
+          return false;
+        }
+        m_keys[j]  = m_keys[j - 1];
+        m_order[j] = m_order[j - 1];
+      }
+      m_keys[j]  = key;
+      m_order[j] = id;
+    }
+    return true;
+  }
+
+public:
+  SweepAndPrune() = default;
+  explicit SweepAndPrune( const SweepAndPruneOptions& options ) : m_options( options ) {}
+
+  [[nodiscard]] inline size_t                    axis() const { return m_axis; }
+  [[nodiscard]] inline std::span<const uint32_t> order() const { return m_order; }
+
+  // Sorts the boxes of this step. When the box count matches the previous update the previous order
+  // is the starting point; otherwise the sweep axis is re-chosen and the boxes are radix sorted.
+  void update( std::span<const AABB> boxes )
+  {
+    const size_t count       = boxes.size();
+    const bool   incremental = count == m_order.size();
+    if ( !incremental )
+    {
+      m_axis = count != 0 ? chooseAxis( boxes ) : 0;
+      m_order.resize( count );
+      std::iota( m_order.begin(), m_order.end(), 0U );
+      m_keys.resize( count );
+    }
+
+    for ( size_t i = 0; i != count; ++i )
+    {
+      m_keys[i] = toSortableKey( boxes[m_order[i]].min()[m_axis] );
+    }
+
+    if ( !incremental || !insertionSort() )
+    {
+      m_scratchKeys.resize( count );
+      m_scratchOrder.resize( count );
+      radixSort( m_keys, m_order, m_scratchKeys, m_scratchOrder, m_options.sort );
+    }
+
+    for ( size_t axis = 0; axis != 3; ++axis )
+    {
+      m_sortedMin[axis].resize( count );
+      m_sortedMax[axis].resize( count );
+      for ( size_t i = 0; i != count; ++i )
+      {
+        const AABB& box      = boxes[m_order[i]];
+        m_sortedMin[axis][i] = box.min()[axis];
+        m_sortedMax[axis][i] = box.max()[axis];
+      }
+    }
+  }
+
+  // Writes every overlapping pair of the last update into pairs, with a < b, and returns the total
+  // number of overlapping pairs. Pairs beyond the capacity of the buffer are counted but not
+  // written, so a caller seeing a larger count can grow the buffer and sweep again.
+  size_t findPairs( std::span<OverlapPair> pairs ) const
+  {
+    const size_t axis_u = ( m_axis + 1 ) % 3;
+    const size_t axis_v = ( m_axis + 2 ) % 3;
+
+    const std::span<const float> sweep_min = m_sortedMin[m_axis];
+    const std::span<const float> sweep_max = m_sortedMax[m_axis];
+    const std::span<const float> min_u     = m_sortedMin[axis_u];
+    const std::span<const float> max_u     = m_sortedMax[axis_u];
+    const std::span<const float> min_v     = m_sortedMin[axis_v];
+    const std::span<const float> max_v     = m_sortedMax[axis_v];
+
+    size_t found = 0;
+    for ( size_t i = 0; i < m_order.size(); ++i )
+    {
+      for ( size_t j = i + 1; j < m_order.size() && sweep_min[j] <= sweep_max[i]; ++j )
+      {
+        const bool overlap = ( min_u[i] <= max_u[j] ) & ( min_u[j] <= max_u[i] ) & ( min_v[i] <= max_v[j] )
+                             & ( min_v[j] <= max_v[i] );
+        if ( overlap )
+        {
+          if ( found < pairs.size() )
+          {
+            pairs[found] = OverlapPair{ std::min( m_order[i], m_order[j] ), std::max( m_order[i], m_order[j] ) };
+          }
+          ++found;
+        }
+      }
+    }
+    return found;
+  }
+};
+
+} // namespace Mirage::Math
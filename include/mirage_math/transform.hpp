@@ -108,6 +108,28 @@ inline Point3 operator*( const Transform4& t, const Point3& point )
   };
 }
 
+// The affine transform that applies first and then second
+inline Transform4 compose( const Transform4& first, const Transform4& second )
+{
+  const auto entry = [&first, &second]( size_t row, size_t col ) {
+    const float translation = col == 3 ? second( row, 3 ) : 0.0F;
+    return second( row, 0 ) * first( 0, col ) + second( row, 1 ) * first( 1, col ) + second( row, 2 ) * first( 2, col )
+           + translation;
+  };
+  return Transform4{ entry( 0, 0 ),
+    entry( 0, 1 ),
+    entry( 0, 2 ),
+    entry( 0, 3 ),
+    entry( 1, 0 ),
+    entry( 1, 1 ),
+    entry( 1, 2 ),
+    entry( 1, 3 ),
+    entry( 2, 0 ),
+    entry( 2, 1 ),
+    entry( 2, 2 ),
+    entry( 2, 3 ) };
+}
+
 // This operator is used for normal vector transformation
 // TODO: This should probably be function with a clear name
 inline Vec3 operator*( const Vec3& normal_vec, const Transform4& t )
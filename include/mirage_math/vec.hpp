@@ -270,6 +270,28 @@ inline Vec<T, N> reject( const Vec<T, N>& source, const Vec<T, N>& target )
   return source - project( source, target );
 }
 
+template<typename T, size_t N>
+inline Vec<T, N> min( const Vec<T, N>& left, const Vec<T, N>& right )
+{
+  Vec<T, N> vec{};
+  for ( size_t i = 0; i != N; ++i )
+  {
+    vec[i] = left[i] < right[i] ? left[i] : right[i];
+  }
+  return vec;
+}
+
+template<typename T, size_t N>
+inline Vec<T, N> max( const Vec<T, N>& left, const Vec<T, N>& right )
+{
+  Vec<T, N> vec{};
+  for ( size_t i = 0; i != N; ++i )
+  {
+    vec[i] = left[i] > right[i] ? left[i] : right[i];
+  }
+  return vec;
+}
+
 template<typename T, size_t N>
 inline bool isUnitVector( const Vec<T, N>& vec, const T epsilon = EPSILON )
 {
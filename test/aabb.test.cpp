@@ -0,0 +1,127 @@
+#include "mirage_math/aabb.hpp"
+#include "mirage_math/mat3.hpp"
+#include "test_utils.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class AABBTest : public ::testing::Test
+{
+protected:
+  AABB unitBox{
+    Point3{ -1.0F, -1.0F, -1.0F },
+    Point3{  1.0F,  1.0F,  1.0F }
+  };
+};
+
+TEST_F( AABBTest, CenterAndExtents )
+{
+  AABB box{
+    Point3{ 1.0F, 2.0F, 3.0F },
+    Point3{ 3.0F, 6.0F, 9.0F }
+  };
+  EXPECT_TRUE( areVectorsEqual( box.center(), Vec3{ 2.0F, 4.0F, 6.0F } ) );
+  EXPECT_TRUE( areVectorsEqual( box.extents(), Vec3{ 1.0F, 2.0F, 3.0F } ) );
+  EXPECT_FLOAT_EQ( box.surfaceArea(), 2.0F * ( 2.0F * 4.0F + 4.0F * 6.0F + 6.0F * 2.0F ) );
+}
+
+TEST_F( AABBTest, EmptyExpands )
+{
+  AABB box = AABB::empty();
+  EXPECT_TRUE( box.isEmpty() );
+
+  box.expandInPlace( Point3{ 1.0F, 2.0F, 3.0F } );
+  box.expandInPlace( Point3{ -1.0F, 5.0F, 0.0F } );
+  EXPECT_FALSE( box.isEmpty() );
+  EXPECT_TRUE( areVectorsEqual( box.min(), Vec3{ -1.0F, 2.0F, 0.0F } ) );
+  EXPECT_TRUE( areVectorsEqual( box.max(), Vec3{ 1.0F, 5.0F, 3.0F } ) );
+}
+
+TEST_F( AABBTest, MergeAndIntersection )
+{
+  AABB other{
+    Point3{ 0.0F, 0.0F, 0.0F },
+    Point3{ 2.0F, 3.0F, 4.0F }
+  };
+
+  AABB merged = merge( unitBox, other );
+  EXPECT_TRUE( areVectorsEqual( merged.min(), Vec3{ -1.0F, -1.0F, -1.0F } ) );
+  EXPECT_TRUE( areVectorsEqual( merged.max(), Vec3{ 2.0F, 3.0F, 4.0F } ) );
+
+  auto opt_box = getIntersection( unitBox, other );
+  ASSERT_TRUE( opt_box.has_value() );
+  EXPECT_TRUE( areVectorsEqual( opt_box->min(), Vec3{ 0.0F, 0.0F, 0.0F } ) );
+  EXPECT_TRUE( areVectorsEqual( opt_box->max(), Vec3{ 1.0F, 1.0F, 1.0F } ) );
+
+  AABB far{
+    Point3{ 5.0F, 5.0F, 5.0F },
+    Point3{ 6.0F, 6.0F, 6.0F }
+  };
+  EXPECT_FALSE( overlaps( unitBox, far ) );
+  EXPECT_FALSE( getIntersection( unitBox, far ).has_value() );
+}
+
+TEST_F( AABBTest, Containment )
+{
+  EXPECT_TRUE( contains( unitBox, Point3{ 0.5F, -0.5F, 1.0F } ) );
+  EXPECT_FALSE( contains( unitBox, Point3{ 0.5F, -1.5F, 0.0F } ) );
+
+  AABB inner{
+    Point3{ -0.5F, -0.5F, -0.5F },
+    Point3{  0.5F,  0.5F,  0.5F }
+  };
+  EXPECT_TRUE( contains( unitBox, inner ) );
+  EXPECT_FALSE( contains( inner, unitBox ) );
+}
+
+TEST_F( AABBTest, TransformMatchesCorners )
+{
+  Transform4 transform{ Transform4::identity() };
+  Mat3       rotation = makeRotation( 0.7F, normalized( Vec3{ 1.0F, 2.0F, 3.0F } ) );
+  for ( size_t i = 0; i != 3; ++i )
+  {
+    transform[i] = rotation[i] * 2.0F;
+  }
+  transform.setTranslation( Point3{ 4.0F, -3.0F, 1.0F } );
+
+  AABB box{
+    Point3{ -1.0F, 0.0F, 2.0F },
+    Point3{  3.0F, 1.0F, 5.0F }
+  };
+
+  AABB expected = AABB::empty();
+  for ( int corner = 0; corner != 8; ++corner )
+  {
+    Point3 point{ ( corner & 1 ) != 0 ? box.max().x() : box.min().x(),
+      ( corner & 2 ) != 0 ? box.max().y() : box.min().y(),
+      ( corner & 4 ) != 0 ? box.max().z() : box.min().z() };
+    expected.expandInPlace( transform * point );
+  }
+
+  AABB transformed = transform * box;
+  EXPECT_TRUE( areVectorsEqual( transformed.min(), expected.min(), 1e-4F ) );
+  EXPECT_TRUE( areVectorsEqual( transformed.max(), expected.max(), 1e-4F ) );
+
+  std::vector<AABB>       local( 5, box );
+  std::vector<Transform4> world( 5, transform );
+  std::vector<AABB>       out( 5 );
+  transformBounds( local, world, out );
+  for ( const auto& result : out )
+  {
+    EXPECT_TRUE( areVectorsEqual( result.min(), transformed.min(), 1e-4F ) );
+    EXPECT_TRUE( areVectorsEqual( result.max(), transformed.max(), 1e-4F ) );
+  }
+}
+
+TEST_F( AABBTest, BoundingBoxOfPoints )
+{
+  std::vector<Point3> points{
+    Point3{ 1.0F, 0.0F, -2.0F },
+    Point3{ -3.0F, 4.0F, 0.0F },
+    Point3{ 0.0F, -1.0F, 7.0F },
+  };
+  AABB box = makeBoundingBox( points );
+  EXPECT_TRUE( areVectorsEqual( box.min(), Vec3{ -3.0F, -1.0F, -2.0F } ) );
+  EXPECT_TRUE( areVectorsEqual( box.max(), Vec3{ 1.0F, 4.0F, 7.0F } ) );
+}
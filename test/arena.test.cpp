@@ -0,0 +1,137 @@
+#include "mirage_math/arena.hpp"
+#include "mirage_math/mat4.hpp"
+#include "mirage_math/point.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class ArenaTest : public ::testing::Test
+{
+protected:
+  static bool isAligned( const void* pointer, size_t alignment )
+  {
+    return reinterpret_cast<uintptr_t>( pointer ) % alignment == 0;
+  }
+};
+
+TEST_F( ArenaTest, AllocatesAlignedSpans )
+{
+  Arena arena( 256 );
+
+  const auto points = arena.allocate<Point3>( 10 );
+  ASSERT_EQ( points.size(), 10U );
+  EXPECT_TRUE( isAligned( points.data(), alignof( Point3 ) ) );
+  EXPECT_FLOAT_EQ( points[9].z(), 0.0F );
+
+  const auto bytes = arena.allocate<char>( 3 );
+  const auto mats  = arena.allocate<Mat4>( 2 );
+  EXPECT_TRUE( isAligned( mats.data(), alignof( Mat4 ) ) );
+  EXPECT_GE( static_cast<const void*>( mats.data() ), static_cast<const void*>( bytes.data() + 3 ) );
+
+  EXPECT_TRUE( isAligned( arena.allocate( 1, 128 ), 128 ) );
+  EXPECT_TRUE( isAligned( arena.allocate( 1, 4096 ), 4096 ) );
+
+  // Larger than a block: gets a block of its own
+  const auto large = arena.allocate<Point3>( 1000 );
+  large[999]       = Point3{ 1.0F, 2.0F, 3.0F };
+  EXPECT_FLOAT_EQ( large[999].y(), 2.0F );
+  EXPECT_GE( arena.capacity(), 1000 * sizeof( Point3 ) );
+}
+
+TEST_F( ArenaTest, RewindAndScopesReuseMemory )
+{
+  Arena arena( 1024 );
+
+  const auto  base     = arena.allocate<float>( 4 );
+  const auto  marker   = arena.mark();
+  const auto* first    = arena.allocate<float>( 100 ).data();
+  const auto* spilled  = arena.allocate<float>( 300 ).data();
+  const auto  capacity = arena.capacity();
+  arena.rewind( marker );
+  EXPECT_EQ( arena.allocate<float>( 100 ).data(), first );
+  EXPECT_EQ( arena.allocate<float>( 300 ).data(), spilled );
+  EXPECT_EQ( arena.capacity(), capacity );
+
+  {
+    const ArenaScope scope( arena );
+    for ( int i = 0; i != 100; ++i )
+    {
+      (void)arena.allocate<Point3>( 50 );
+    }
+  }
+  const auto grown = arena.capacity();
+  {
+    const ArenaScope scope( arena );
+    for ( int i = 0; i != 100; ++i )
+    {
+      (void)arena.allocate<Point3>( 50 );
+    }
+  }
+  EXPECT_EQ( arena.capacity(), grown );
+
+  arena.reset();
+  EXPECT_EQ( arena.allocate<float>( 4 ).data(), base.data() );
+
+  arena.release();
+  EXPECT_EQ( arena.capacity(), 0U );
+}
+
+TEST_F( ArenaTest, AllocatorBacksContainers )
+{
+  Arena arena( 4096 );
+  {
+    std::vector<Point3, ArenaAllocator<Point3>> points{ ArenaAllocator<Point3>( arena ) };
+    for ( int i = 0; i != 500; ++i )
+    {
+      points.emplace_back( static_cast<float>( i ), 0.0F, 0.0F );
+    }
+    EXPECT_FLOAT_EQ( points[499].x(), 499.0F );
+
+    // Rebinding keeps the arena
+    const ArenaAllocator<int> ints( points.get_allocator() );
+    EXPECT_EQ( &ints.arena(), &arena );
+    EXPECT_TRUE( ints == points.get_allocator() );
+  }
+  EXPECT_GT( arena.capacity(), 0U );
+}
+
+TEST_F( ArenaTest, PoolRecyclesSlots )
+{
+  struct Node
+  {
+    std::string name;
+    Node*       parent;
+  };
+
+  Pool<Node> pool( 4 );
+  Node*      root  = pool.create( "root", nullptr );
+  Node*      child = pool.create( "child", root );
+  EXPECT_EQ( child->parent, root );
+  EXPECT_EQ( child->name, "child" );
+  EXPECT_EQ( pool.size(), 2U );
+  EXPECT_TRUE( isAligned( child, alignof( Node ) ) );
+
+  pool.destroy( child );
+  Node* reused = pool.create( "again", root );
+  EXPECT_EQ( reused, child );
+
+  std::vector<Node*> nodes;
+  for ( int i = 0; i != 10; ++i )
+  {
+    nodes.push_back( pool.create( std::to_string( i ), root ) );
+  }
+  EXPECT_EQ( pool.size(), 12U );
+  EXPECT_EQ( pool.capacity(), 12U );
+  EXPECT_EQ( nodes[9]->name, "9" );
+
+  for ( auto* node : nodes )
+  {
+    pool.destroy( node );
+  }
+  pool.destroy( reused );
+  pool.destroy( root );
+  EXPECT_EQ( pool.size(), 0U );
+}
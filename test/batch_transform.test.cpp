@@ -0,0 +1,116 @@
+#include "mirage_math/batch_transform.hpp"
+#include "test_utils.hpp"
+#include <array>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class BatchTransformTest : public ::testing::Test
+{
+protected:
+  // Rotation about z, non-uniform scale and a translation
+  const Transform4 transform{ 0.0F, -2.0F, 0.0F, 5.0F, 1.5F, 0.0F, 0.0F, -3.0F, 0.0F, 0.0F, 0.5F, 7.0F };
+
+  // Not a multiple of the SIMD width
+  std::vector<Point3> points;
+  std::vector<Vec3>   vectors;
+  std::vector<Plane>  planes;
+
+  // Every execution, with PAR split into many small jobs
+  JobSystem                            jobs{ 3 };
+  std::array<BatchTransformOptions, 3> executions{};
+
+  void SetUp() override
+  {
+    for ( int i = 0; i != 1003; ++i )
+    {
+      const auto f = static_cast<float>( i );
+      points.emplace_back( std::sin( f ) * 10.0F, std::cos( f * 0.3F ) * 10.0F, f * 0.01F );
+      vectors.emplace_back( std::cos( f ), -std::sin( f * 0.5F ), 0.25F );
+      planes.emplace_back( std::cos( f ), std::sin( f ), 0.0F, -f * 0.1F );
+    }
+    executions[0].execution         = Execution::SEQ;
+    executions[1].execution         = Execution::UNSEQ;
+    executions[2].execution         = Execution::PAR;
+    executions[2].parallelThreshold = 0;
+    executions[2].grainSize         = 64;
+    executions[2].jobSystem         = &jobs;
+  }
+};
+
+TEST_F( BatchTransformTest, MatchesSingleElementOperators )
+{
+  for ( const auto& options : executions )
+  {
+    std::vector<Point3> moved( points.size() );
+    std::vector<Vec3>   turned( vectors.size() );
+    std::vector<Vec3>   normals( vectors.size() );
+    std::vector<Plane>  moved_planes( planes.size() );
+    transformPoints( transform, points, moved, options );
+    transformVectors( transform, vectors, turned, options );
+    transformNormals( transform, vectors, normals, options );
+    transformPlanes( transform, planes, moved_planes, options );
+
+    for ( size_t i = 0; i != points.size(); ++i )
+    {
+      ASSERT_TRUE( areVectorsEqual( moved[i], transform * points[i], 1e-5F ) );
+      ASSERT_TRUE( areVectorsEqual( turned[i], transform * vectors[i], 1e-5F ) );
+      ASSERT_TRUE( areVectorsEqual( normals[i], vectors[i] * transform, 1e-5F ) );
+      ASSERT_TRUE( areVectorsEqual( moved_planes[i], planes[i] * transform, 1e-5F ) );
+    }
+  }
+}
+
+TEST_F( BatchTransformTest, TransformsInPlace )
+{
+  // Planes follow the points when transformed by the inverse
+  const Transform4 inverse_transform = inverse( transform );
+  for ( const auto& options : executions )
+  {
+    std::vector<Point3> moved        = points;
+    std::vector<Plane>  moved_planes = planes;
+    transformPoints( transform, moved, moved, options );
+    transformPlanes( inverse_transform, moved_planes, moved_planes, options );
+
+    for ( size_t i = 0; i != points.size(); ++i )
+    {
+      ASSERT_TRUE( areVectorsEqual( moved[i], transform * points[i], 1e-5F ) );
+      ASSERT_NEAR( dot( moved_planes[i], moved[i] ), dot( planes[i], points[i] ), 1e-3F );
+    }
+  }
+}
+
+TEST_F( BatchTransformTest, TransformsStridedViews )
+{
+  // Interleaved position and normal, 24 bytes per vertex
+  std::vector<float> buffer;
+  for ( size_t i = 0; i != points.size(); ++i )
+  {
+    buffer.insert( buffer.end(),
+      { points[i].x(), points[i].y(), points[i].z(), vectors[i].x(), vectors[i].y(), vectors[i].z() } );
+  }
+  constexpr size_t STRIDE = 6 * sizeof( float );
+
+  for ( const auto& options : executions )
+  {
+    std::vector<float> vertices  = buffer;
+    const auto         positions = makeStridedSpan<Point3>( std::span<float>{ vertices }, 0, STRIDE );
+    const auto         normals   = makeStridedSpan<Vec3>( std::span<float>{ vertices }, 3 * sizeof( float ), STRIDE );
+    transformPoints( transform, positions, positions, options );
+    transformNormals( transform, normals, normals, options );
+
+    // Packed input into a strided output
+    std::vector<float> scattered( buffer.size() );
+    const auto         vecs = makeStridedSpan<Vec3>( std::span<float>{ scattered }, 0, STRIDE );
+    transformVectors( transform, StridedSpan<const Vec3>{ vectors }, vecs, options );
+
+    for ( size_t i = 0; i != points.size(); ++i )
+    {
+      ASSERT_TRUE( areVectorsEqual( positions[i].get(), transform * points[i], 1e-5F ) );
+      ASSERT_TRUE( areVectorsEqual( normals[i].get(), vectors[i] * transform, 1e-5F ) );
+      ASSERT_TRUE( areVectorsEqual( vecs[i].get(), transform * vectors[i], 1e-5F ) );
+    }
+  }
+}
@@ -0,0 +1,154 @@
+#include "mirage_math/binary_file.hpp"
+#include "test_utils.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class BinaryFileTest : public ::testing::Test
+{
+protected:
+  std::filesystem::path path;
+
+  std::vector<Point3>     points;
+  std::vector<Transform4> transforms;
+  std::vector<Plane>      planes;
+
+  void SetUp() override
+  {
+    path = std::filesystem::temp_directory_path()
+           / ( "mirage_binary_file_" + std::to_string( reinterpret_cast<uintptr_t>( this ) ) + ".bin" );
+
+    for ( int i = 0; i != 1000; ++i )
+    {
+      const auto f = static_cast<float>( i );
+      points.emplace_back( f, f * 0.5F, -f );
+    }
+    for ( int i = 0; i != 3; ++i )
+    {
+      const auto f = static_cast<float>( i );
+      transforms.emplace_back( 1.0F, 0.0F, 0.0F, f, 0.0F, 1.0F, 0.0F, 2.0F * f, 0.0F, 0.0F, 1.0F, 3.0F * f );
+    }
+    planes.emplace_back( 0.0F, 1.0F, 0.0F, -2.0F );
+    planes.emplace_back( 1.0F, 0.0F, 0.0F, 5.0F );
+  }
+
+  void TearDown() override { std::filesystem::remove( path ); }
+
+  void writeFile()
+  {
+    BinaryFileWriter writer;
+    ASSERT_TRUE( writer.add<Point3>( "points", points ) );
+    ASSERT_TRUE( writer.add<Transform4>( "transforms", transforms ) );
+    ASSERT_TRUE( writer.add<Plane>( "planes", planes ) );
+    ASSERT_TRUE( writer.add<Point3>( "empty", {} ) );
+    ASSERT_TRUE( writer.write( path ) );
+  }
+
+  std::vector<char> readBytes() const
+  {
+    std::ifstream file( path, std::ios::binary );
+    return std::vector<char>( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+  }
+
+  void writeBytes( const std::vector<char>& bytes ) const
+  {
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    file.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ) );
+  }
+};
+
+TEST_F( BinaryFileTest, RoundTripsSections )
+{
+  writeFile();
+  const auto file = MappedBinaryFile::open( path );
+  ASSERT_TRUE( file.has_value() );
+  EXPECT_EQ( file->sections().size(), 4U );
+
+  const auto loaded_points = file->get<Point3>( "points" );
+  ASSERT_TRUE( loaded_points.has_value() );
+  ASSERT_EQ( loaded_points->size(), points.size() );
+  for ( size_t i = 0; i != points.size(); ++i )
+  {
+    EXPECT_TRUE( areVectorsEqual( ( *loaded_points )[i], points[i], 0.0F ) );
+  }
+
+  // Sections are views into the mapping, aligned for their element type
+  EXPECT_GE( reinterpret_cast<const std::byte*>( loaded_points->data() ), file->bytes().data() );
+  EXPECT_EQ( reinterpret_cast<uintptr_t>( loaded_points->data() ) % BINARY_SECTION_ALIGNMENT, 0U );
+
+  const auto loaded_transforms = file->get<Transform4>( "transforms" );
+  ASSERT_TRUE( loaded_transforms.has_value() );
+  ASSERT_EQ( loaded_transforms->size(), transforms.size() );
+  EXPECT_TRUE( areMatricesEqual( ( *loaded_transforms )[2], transforms[2], 0.0F ) );
+  EXPECT_FLOAT_EQ( ( *loaded_transforms )[2].getTranslation().z(), 6.0F );
+
+  const auto loaded_planes = file->get<Plane>( "planes" );
+  ASSERT_TRUE( loaded_planes.has_value() );
+  EXPECT_FLOAT_EQ( dot( ( *loaded_planes )[0], Point3{ 0.0F, 3.0F, 0.0F } ), 1.0F );
+
+  const auto empty = file->get<Point3>( "empty" );
+  ASSERT_TRUE( empty.has_value() );
+  EXPECT_TRUE( empty->empty() );
+
+  // Lookups match the name and the element type
+  EXPECT_FALSE( file->get<Plane>( "points" ).has_value() );
+  EXPECT_FALSE( file->get<Point3>( "missing" ).has_value() );
+}
+
+TEST_F( BinaryFileTest, WriterRejectsBadNames )
+{
+  BinaryFileWriter writer;
+  EXPECT_TRUE( writer.add<Point3>( "points", points ) );
+  EXPECT_FALSE( writer.add<Plane>( "points", planes ) );
+  EXPECT_FALSE( writer.add<Plane>( std::string( BINARY_SECTION_NAME_SIZE, 'x' ), planes ) );
+  EXPECT_TRUE( writer.add<Plane>( std::string( BINARY_SECTION_NAME_SIZE - 1, 'x' ), planes ) );
+  EXPECT_EQ( writer.sectionCount(), 2U );
+}
+
+TEST_F( BinaryFileTest, OpenValidatesLayout )
+{
+  EXPECT_FALSE( MappedBinaryFile::open( path ).has_value() );
+
+  writeFile();
+  const auto original = readBytes();
+
+  // Truncated, so the last section runs past the end
+  auto bytes = original;
+  bytes.erase( bytes.end() - 4, bytes.end() );
+  writeBytes( bytes );
+  EXPECT_FALSE( MappedBinaryFile::open( path ).has_value() );
+
+  // Wrong magic, version or byte order
+  const std::array<size_t, 3> header_fields{ offsetof( BinaryFileHeader, magic ),
+    offsetof( BinaryFileHeader, version ),
+    offsetof( BinaryFileHeader, endianTag ) };
+  for ( size_t offset : header_fields )
+  {
+    bytes = original;
+    ++bytes[offset];
+    writeBytes( bytes );
+    EXPECT_FALSE( MappedBinaryFile::open( path ).has_value() );
+  }
+
+  // A misaligned section offset
+  bytes = original;
+  bytes[sizeof( BinaryFileHeader ) + offsetof( BinarySectionHeader, offset )] += 4;
+  writeBytes( bytes );
+  EXPECT_FALSE( MappedBinaryFile::open( path ).has_value() );
+
+  // An element size that does not match the type
+  bytes = original;
+  bytes[sizeof( BinaryFileHeader ) + offsetof( BinarySectionHeader, elementSize )] += 1;
+  writeBytes( bytes );
+  EXPECT_FALSE( MappedBinaryFile::open( path ).has_value() );
+
+  writeBytes( original );
+  EXPECT_TRUE( MappedBinaryFile::open( path ).has_value() );
+}
@@ -0,0 +1,169 @@
+#include "mirage_math/bvh.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class BVHTest : public ::testing::Test
+{
+protected:
+  std::vector<AABB> primitives;
+
+  void SetUp() override
+  {
+    for ( int x = 0; x != 20; ++x )
+    {
+      for ( int y = 0; y != 20; ++y )
+      {
+        for ( int z = 0; z != 5; ++z )
+        {
+          Point3 center{ static_cast<float>( x ) * 2.0F, static_cast<float>( y ) * 1.5F, static_cast<float>( z ) * 3.0F };
+          primitives.emplace_back( center - Vec3{ 0.4F, 0.4F, 0.4F }, center + Vec3{ 0.4F, 0.4F, 0.4F } );
+        }
+      }
+    }
+  }
+
+  static std::vector<uint32_t> bruteForce( std::span<const AABB> boxes, const AABB& query )
+  {
+    std::vector<uint32_t> result;
+    for ( uint32_t i = 0; i != boxes.size(); ++i )
+    {
+      if ( overlaps( boxes[i], query ) )
+      {
+        result.push_back( i );
+      }
+    }
+    return result;
+  }
+
+  // The BVH reports candidates from overlapping leaves; the exact test is left to the caller
+  static std::vector<uint32_t> query( const BVH& bvh, std::span<const AABB> boxes, const AABB& box )
+  {
+    std::vector<uint32_t> result;
+    bvh.queryOverlaps( box, [&]( uint32_t primitive ) {
+      if ( overlaps( boxes[primitive], box ) )
+      {
+        result.push_back( primitive );
+      }
+    } );
+    std::sort( result.begin(), result.end() );
+    return result;
+  }
+};
+
+TEST_F( BVHTest, NodeLayoutIsCompact ) { EXPECT_EQ( sizeof( BVHNode ), 32U ); }
+
+TEST_F( BVHTest, BuildCoversEveryPrimitiveOnce )
+{
+  BVH bvh = BVH::build( primitives );
+  ASSERT_FALSE( bvh.isEmpty() );
+
+  std::vector<int> seen( primitives.size() );
+  for ( const auto& node : bvh.nodes() )
+  {
+    if ( node.isLeaf() )
+    {
+      EXPECT_LE( node.count, 4U );
+      for ( uint32_t i = node.leftFirst; i != node.leftFirst + node.count; ++i )
+      {
+        const uint32_t primitive = bvh.primitiveIndices()[i];
+        seen[primitive]++;
+        EXPECT_TRUE( contains( node.bounds(), primitives[primitive] ) );
+      }
+    } else
+    {
+      EXPECT_TRUE( contains( node.bounds(), bvh.nodes()[node.leftFirst].bounds() ) );
+      EXPECT_TRUE( contains( node.bounds(), bvh.nodes()[node.leftFirst + 1].bounds() ) );
+    }
+  }
+  EXPECT_TRUE( std::all_of( seen.begin(), seen.end(), []( int count ) { return count == 1; } ) );
+}
+
+TEST_F( BVHTest, QueryMatchesBruteForce )
+{
+  BVHBuildOptions options;
+  options.parallelThreshold = 64;
+  BVH bvh                   = BVH::build( primitives, options );
+
+  AABB box{
+    Point3{ 3.0F, 2.0F, 1.0F },
+    Point3{ 9.0F, 7.5F, 4.0F }
+  };
+  EXPECT_EQ( query( bvh, primitives, box ), bruteForce( primitives, box ) );
+}
+
+TEST_F( BVHTest, RefitTracksMovedPrimitives )
+{
+  BVH bvh = BVH::build( primitives );
+
+  for ( auto& primitive : primitives )
+  {
+    primitive = AABB{ primitive.min() + Vec3{ 0.0F, 0.0F, 100.0F }, primitive.max() + Vec3{ 0.0F, 0.0F, 100.0F } };
+  }
+  bvh.refit( primitives );
+
+  AABB box{
+    Point3{ 0.0F, 0.0F, 100.0F },
+    Point3{ 5.0F, 5.0F, 103.0F }
+  };
+  EXPECT_EQ( query( bvh, primitives, box ), bruteForce( primitives, box ) );
+  EXPECT_TRUE( contains( bvh.nodes()[0].bounds(), makeBoundingBox( std::vector<Point3>{ primitives.back().max() } ) ) );
+}
+
+TEST_F( BVHTest, DepthStaysWithinLimit )
+{
+  // Boxes this tall have the same surface area whatever their x extent, so every SAH split costs the
+  // same and the first bin is split off; unchecked, the tree ends up deeper than MAX_DEPTH
+  std::vector<AABB> spread;
+  for ( int i = 0; i != 40000; ++i )
+  {
+    const Point3 center{ static_cast<float>( i ), 0.0F, 0.0F };
+    spread.emplace_back( center - Vec3{ 0.1F, 1e12F, 1e12F }, center + Vec3{ 0.1F, 1e12F, 1e12F } );
+  }
+
+  BVH                   bvh = BVH::build( spread, { .maxLeafSize = 1 } );
+  std::vector<uint32_t> depths( bvh.nodes().size() );
+  uint32_t              deepest = 0;
+  for ( uint32_t i = 0; i != bvh.nodes().size(); ++i )
+  {
+    const BVHNode& node = bvh.nodes()[i];
+    deepest             = std::max( deepest, depths[i] );
+    if ( !node.isLeaf() )
+    {
+      depths[node.leftFirst]     = depths[i] + 1;
+      depths[node.leftFirst + 1] = depths[i] + 1;
+    }
+  }
+  EXPECT_GT( deepest, 32U );
+  EXPECT_LE( deepest, BVH::MAX_DEPTH );
+
+  const AABB box{
+    Point3{ 100.0F, 0.0F, 0.0F },
+    Point3{ 200.0F, 1.0F, 1.0F }
+  };
+  EXPECT_EQ( query( bvh, spread, box ), bruteForce( spread, box ) );
+}
+
+// Asserts in debug builds; without assertions the build still terminates
+TEST_F( BVHTest, ZeroLeafSizeIsRejected ) { EXPECT_DEBUG_DEATH( BVH::build( primitives, { .maxLeafSize = 0 } ), "" ); }
+
+TEST_F( BVHTest, TriangleBounds )
+{
+  std::vector<Point3>   positions{ Point3{ 0.0F, 0.0F, 0.0F },
+      Point3{ 1.0F, 0.0F, 0.0F },
+      Point3{ 0.0F, 2.0F, 0.0F },
+      Point3{ 0.0F, 0.0F, -3.0F } };
+  std::vector<uint32_t> indices{ 0, 1, 2, 0, 2, 3 };
+
+  auto bounds = makeTriangleBounds( positions, indices );
+  ASSERT_EQ( bounds.size(), 2U );
+  EXPECT_TRUE( areVectorsEqual( bounds[0].max(), Vec3{ 1.0F, 2.0F, 0.0F } ) );
+  EXPECT_TRUE( areVectorsEqual( bounds[1].min(), Vec3{ 0.0F, 0.0F, -3.0F } ) );
+
+  BVH bvh = BVH::build( bounds );
+  EXPECT_EQ( bvh.nodes().size(), 1U );
+  EXPECT_TRUE( bvh.nodes()[0].isLeaf() );
+}
@@ -0,0 +1,101 @@
+#include "mirage_math/capsule.hpp"
+#include "test_utils.hpp"
+#include <array>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class CapsuleTest : public ::testing::Test
+{
+protected:
+  Capsule vertical{ Point3{ 0.0F, 0.0F, 0.0F }, Point3{ 0.0F, 2.0F, 0.0F }, 0.5F };
+};
+
+TEST_F( CapsuleTest, Contains )
+{
+  EXPECT_TRUE( contains( vertical, Point3{ 0.4F, 1.0F, 0.0F } ) );
+  EXPECT_TRUE( contains( vertical, Point3{ 0.0F, 2.4F, 0.0F } ) );
+  EXPECT_FALSE( contains( vertical, Point3{ 0.4F, 2.4F, 0.0F } ) );
+}
+
+TEST_F( CapsuleTest, SignedDistanceToCapsule )
+{
+  Capsule apart{ Point3{ 3.0F, 1.0F, -1.0F }, Point3{ 3.0F, 1.0F, 1.0F }, 1.0F };
+  Capsule crossing{ Point3{ -1.0F, 1.0F, 0.0F }, Point3{ 1.0F, 1.0F, 0.0F }, 0.25F };
+
+  EXPECT_FLOAT_EQ( distance( vertical, apart ), 1.5F );
+  EXPECT_FLOAT_EQ( distance( vertical, crossing ), -0.75F );
+  EXPECT_FALSE( overlaps( vertical, apart ) );
+  EXPECT_TRUE( overlaps( vertical, crossing ) );
+}
+
+TEST_F( CapsuleTest, SignedDistanceToSphere )
+{
+  Sphere above{ Point3{ 0.0F, 5.0F, 0.0F }, 1.0F };
+  Sphere side{ Point3{ 0.7F, 1.0F, 0.0F }, 0.3F };
+
+  EXPECT_FLOAT_EQ( distance( vertical, above ), 1.5F );
+  EXPECT_FALSE( overlaps( vertical, above ) );
+  EXPECT_TRUE( overlaps( vertical, side ) );
+}
+
+TEST_F( CapsuleTest, BatchedQueriesMatchScalar )
+{
+  constexpr size_t                  count = 90;
+  std::vector<Capsule>              capsules;
+  std::vector<Sphere>               spheres;
+  std::array<std::vector<float>, 7> streams;
+  for ( auto& stream : streams )
+  {
+    stream.resize( count );
+  }
+  for ( size_t i = 0; i != count; ++i )
+  {
+    const auto   f = static_cast<float>( i ) * 0.1F;
+    const Point3 start{ std::sin( f ) * 2.0F, f - 4.0F, 0.5F };
+    const Point3 end{ std::cos( f ), f - 3.0F, std::sin( f * 3.0F ) };
+    capsules.emplace_back( start, end, 0.1F + 0.05F * static_cast<float>( i % 4 ) );
+    spheres.emplace_back( end, capsules.back().radius() );
+    for ( size_t axis = 0; axis != 3; ++axis )
+    {
+      streams[axis][i]     = start[axis];
+      streams[3 + axis][i] = end[axis];
+    }
+    streams[6][i] = capsules.back().radius();
+  }
+  const SoACapsule candidates{
+    SoASegment{ SoAVec3{ streams[0], streams[1], streams[2] }, SoAVec3{ streams[3], streams[4], streams[5] } },
+    streams[6]
+  };
+  const SoASphere sphere_candidates{ SoAVec3{ streams[3], streams[4], streams[5] }, streams[6] };
+
+  std::vector<float>    distances( count );
+  std::vector<uint64_t> mask( maskWordCount( count ) );
+
+  const size_t hits = testOverlaps( vertical, candidates, mask );
+  getDistances( vertical, candidates, distances );
+  size_t expected_hits = 0;
+  for ( size_t i = 0; i != count; ++i )
+  {
+    EXPECT_FLOAT_EQ( distances[i], distance( vertical, capsules[i] ) );
+    EXPECT_EQ( isMaskSet( mask, i ), overlaps( vertical, capsules[i] ) );
+    expected_hits += overlaps( vertical, capsules[i] ) ? 1 : 0;
+  }
+  EXPECT_EQ( hits, expected_hits );
+  EXPECT_GT( hits, 0U );
+
+  getDistances( candidates, candidates, distances );
+  for ( size_t i = 0; i != count; ++i )
+  {
+    EXPECT_FLOAT_EQ( distances[i], -2.0F * capsules[i].radius() );
+  }
+
+  testOverlaps( vertical, sphere_candidates, mask );
+  getDistances( vertical, sphere_candidates, distances );
+  for ( size_t i = 0; i != count; ++i )
+  {
+    EXPECT_FLOAT_EQ( distances[i], distance( vertical, spheres[i] ) );
+    EXPECT_EQ( isMaskSet( mask, i ), overlaps( vertical, spheres[i] ) );
+  }
+}
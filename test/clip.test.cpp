@@ -0,0 +1,170 @@
+#include "mirage_math/clip.hpp"
+#include <array>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class ClipTest : public ::testing::Test
+{
+protected:
+  // Unit square in the z = 0 plane
+  std::array<Point3, 4> square{ Point3{ 0.0F, 0.0F, 0.0F },
+    Point3{ 1.0F, 0.0F, 0.0F },
+    Point3{ 1.0F, 1.0F, 0.0F },
+    Point3{ 0.0F, 1.0F, 0.0F } };
+
+  static float area( std::span<const Point3> polygon )
+  {
+    Vec3 sum{ 0.0F, 0.0F, 0.0F };
+    for ( size_t i = 1; i + 1 < polygon.size(); ++i )
+    {
+      sum = sum + cross( polygon[i] - polygon[0], polygon[i + 1] - polygon[0] );
+    }
+    return magnitude( sum ) * 0.5F;
+  }
+};
+
+TEST_F( ClipTest, ClipAgainstSinglePlane )
+{
+  std::array<Point3, 5> out{};
+
+  // Keep x <= 0.5
+  const size_t count = clipPolygon( square, Plane{ -1.0F, 0.0F, 0.0F, 0.5F }, out );
+  ASSERT_EQ( count, 4U );
+  EXPECT_FLOAT_EQ( area( std::span{ out }.first( count ) ), 0.5F );
+  for ( size_t i = 0; i != count; ++i )
+  {
+    EXPECT_LE( out[i].x(), 0.5F );
+  }
+
+  // Cutting a corner adds a vertex
+  EXPECT_EQ( clipPolygon( square, Plane{ -1.0F, -1.0F, 0.0F, 1.5F }, out ), 5U );
+  EXPECT_EQ( clipPolygon( square, Plane{ 1.0F, 0.0F, 0.0F, -2.0F }, out ), 0U );
+  EXPECT_EQ( clipPolygon( square, Plane{ 1.0F, 0.0F, 0.0F, 2.0F }, out ), 4U );
+}
+
+TEST_F( ClipTest, ClipAgainstPlaneSet )
+{
+  const std::array<Plane, 4> planes{ Plane{ 1.0F, 0.0F, 0.0F, -0.25F },
+    Plane{ -1.0F, 0.0F, 0.0F, 0.75F },
+    Plane{ 0.0F, 1.0F, 0.0F, -0.25F },
+    Plane{ 0.0F, -1.0F, 0.0F, 0.5F } };
+
+  std::array<Point3, clippedVertexCapacity( 4, 4 )> out{};
+  std::array<Point3, clippedVertexCapacity( 4, 4 )> scratch{};
+
+  const auto clipped = clipPolygon( square, planes, out, scratch );
+  EXPECT_EQ( clipped.data(), out.data() );
+  EXPECT_EQ( clipped.size(), 4U );
+  EXPECT_FLOAT_EQ( area( clipped ), 0.5F * 0.25F );
+
+  // Every intermediate parity ends up in out
+  for ( size_t count = 0; count <= planes.size(); ++count )
+  {
+    const auto partial = clipPolygon( square, std::span{ planes }.first( count ), out, scratch );
+    EXPECT_EQ( partial.data(), out.data() );
+    EXPECT_GE( partial.size(), 3U );
+  }
+
+  // A plane rejecting everything empties the result
+  const std::array<Plane, 2> disjoint{ Plane{ 1.0F, 0.0F, 0.0F, -0.25F }, Plane{ 0.0F, 0.0F, 1.0F, -1.0F } };
+  EXPECT_TRUE( clipPolygon( square, disjoint, out, scratch ).empty() );
+}
+
+TEST_F( ClipTest, ClipTrianglesPacksPolygons )
+{
+  const std::vector<Point3>   positions{ Point3{ -1.0F, 0.0F, 0.0F },
+    Point3{ 1.0F, 0.0F, 0.0F },
+    Point3{ 0.0F, 1.0F, 0.0F },
+    Point3{ 2.0F, 0.0F, 0.0F },
+    Point3{ 3.0F, 0.0F, 0.0F },
+    Point3{ 2.0F, 1.0F, 0.0F } };
+  const std::vector<uint32_t> indices{ 0, 1, 2, 3, 4, 5, 1, 3, 2 };
+
+  // Keep x <= 1.5
+  const std::array<Plane, 1> planes{ Plane{ -1.0F, 0.0F, 0.0F, 1.5F } };
+  const size_t               capacity = clippedVertexCapacity( 3, planes.size() );
+
+  std::vector<Point3>   vertices( indices.size() / 3 * capacity );
+  std::vector<uint32_t> offsets( indices.size() / 3 + 1 );
+  std::vector<Point3>   scratch( capacity );
+
+  const size_t count = clipTriangles( positions, indices, planes, vertices, offsets, scratch );
+  EXPECT_EQ( offsets.front(), 0U );
+  EXPECT_EQ( offsets.back(), count );
+
+  // Inside, clipped away and cut into a quad
+  EXPECT_EQ( offsets[1] - offsets[0], 3U );
+  EXPECT_EQ( offsets[2] - offsets[1], 0U );
+  EXPECT_EQ( offsets[3] - offsets[2], 4U );
+  EXPECT_FLOAT_EQ( area( std::span{ vertices }.subspan( offsets[0], 3 ) ), 1.0F );
+  for ( uint32_t i = offsets[2]; i != offsets[3]; ++i )
+  {
+    EXPECT_LE( vertices[i].x(), 1.5F );
+  }
+}
+
+TEST_F( ClipTest, PortalPlanesBoundTheView )
+{
+  // Portal at z = -1 seen from the origin, in either winding
+  const Point3                eye{ 0.0F, 0.0F, 0.0F };
+  const std::array<Point3, 4> portal{ Point3{ -0.5F, -0.5F, -1.0F },
+    Point3{ 0.5F, -0.5F, -1.0F },
+    Point3{ 0.5F, 0.5F, -1.0F },
+    Point3{ -0.5F, 0.5F, -1.0F } };
+  const std::array<Point3, 4> reversed{ portal[3], portal[2], portal[1], portal[0] };
+
+  for ( const auto& corners : { portal, reversed } )
+  {
+    std::array<Plane, 4> planes{};
+    ASSERT_EQ( makePortalPlanes( eye, corners, planes ), 4U );
+    for ( const auto& plane : planes )
+    {
+      EXPECT_GT( dot( plane, Point3{ 0.0F, 0.0F, -2.0F } ), 0.0F );
+      EXPECT_LT( dot( plane, Point3{ 0.0F, 0.0F, 2.0F } ), 0.0F );
+    }
+
+    // A polygon twice as far away is cut down to the portal's footprint of 2x2
+    const std::array<Point3, 4> wall{ Point3{ -3.0F, -3.0F, -2.0F },
+      Point3{ 3.0F, -3.0F, -2.0F },
+      Point3{ 3.0F, 3.0F, -2.0F },
+      Point3{ -3.0F, 3.0F, -2.0F } };
+    std::array<Point3, 8> out{};
+    std::array<Point3, 8> scratch{};
+    EXPECT_NEAR( area( clipPolygon( wall, planes, out, scratch ) ), 4.0F, 1e-4F );
+  }
+
+  const std::array<Point3, 2> degenerate{ portal[0], portal[1] };
+  std::array<Plane, 2>        planes{};
+  EXPECT_EQ( makePortalPlanes( eye, degenerate, planes ), 0U );
+}
+
+TEST_F( ClipTest, ArenaBuffers )
+{
+  Arena arena( 1024 );
+
+  const std::array<Plane, 2> planes{ Plane{ -1.0F, 0.0F, 0.0F, 0.5F }, Plane{ 0.0F, -1.0F, 0.0F, 0.5F } };
+  const auto                 first  = clipPolygon( square, planes, arena );
+  const auto                 second = clipPolygon( square, std::span{ planes }.first( 1 ), arena );
+  EXPECT_FLOAT_EQ( area( first ), 0.25F );
+  EXPECT_FLOAT_EQ( area( second ), 0.5F );
+
+  // Scratch is released after each call, so consecutive results are packed
+  EXPECT_EQ( second.data(), first.data() + clippedVertexCapacity( square.size(), planes.size() ) );
+
+  const std::vector<Point3>   positions{ square.begin(), square.end() };
+  const std::vector<uint32_t> indices{ 0, 1, 2, 0, 2, 3 };
+  const auto                  clipped = clipTriangles( positions, indices, planes, arena );
+  ASSERT_EQ( clipped.offsets.size(), 3U );
+  EXPECT_EQ( clipped.offsets.back(), clipped.vertices.size() );
+  EXPECT_FLOAT_EQ( area( clipped.vertices.subspan( clipped.offsets[0], clipped.offsets[1] - clipped.offsets[0] ) )
+                     + area( clipped.vertices.subspan( clipped.offsets[1], clipped.offsets[2] - clipped.offsets[1] ) ),
+    0.25F );
+
+  // Resetting hands everything back without freeing the block
+  const size_t capacity = arena.capacity();
+  arena.reset();
+  EXPECT_EQ( clipPolygon( square, planes, arena ).data(), first.data() );
+  EXPECT_EQ( arena.capacity(), capacity );
+}
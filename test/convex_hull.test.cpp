@@ -0,0 +1,139 @@
+#include "mirage_math/convex_hull.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class ConvexHullTest : public ::testing::Test
+{
+protected:
+  static std::vector<Point3> cubeWithInterior()
+  {
+    std::vector<Point3> points;
+    for ( int i = 0; i != 8; ++i )
+    {
+      points.emplace_back(
+        static_cast<float>( i & 1 ), static_cast<float>( ( i >> 1 ) & 1 ), static_cast<float>( i >> 2 ) );
+    }
+    for ( int i = 0; i != 200; ++i )
+    {
+      const auto f = static_cast<float>( i );
+      points.emplace_back( 0.5F + 0.45F * std::sin( f * 0.71F ),
+        0.5F + 0.45F * std::cos( f * 1.37F ),
+        0.5F + 0.45F * std::sin( f * 2.11F ) );
+    }
+    return points;
+  }
+
+  static std::vector<Point3> spherePoints( size_t count )
+  {
+    // Fibonacci sphere: every point is a hull vertex
+    std::vector<Point3> points;
+    for ( size_t i = 0; i != count; ++i )
+    {
+      const float z     = 1.0F - 2.0F * ( static_cast<float>( i ) + 0.5F ) / static_cast<float>( count );
+      const float r     = std::sqrt( 1.0F - z * z );
+      const float angle = static_cast<float>( i ) * 2.39996323F;
+      points.emplace_back( r * std::cos( angle ), r * std::sin( angle ), z );
+    }
+    return points;
+  }
+
+  // Every point lies behind every plane, and every edge is shared by exactly two triangles in
+  // opposite directions
+  static void expectValidHull( const ConvexHull& hull, std::span<const Point3> points, float tolerance )
+  {
+    ASSERT_EQ( hull.indices.size(), hull.planes.size() * 3 );
+    for ( const auto& plane : hull.planes )
+    {
+      for ( const auto& point : points )
+      {
+        EXPECT_LE( dot( plane, point ), tolerance );
+      }
+    }
+
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for ( size_t face = 0; face != hull.planes.size(); ++face )
+    {
+      for ( size_t i = 0; i != 3; ++i )
+      {
+        ++edges[{ hull.indices[face * 3 + i], hull.indices[face * 3 + ( i + 1 ) % 3] }];
+      }
+    }
+    for ( const auto& [edge, count] : edges )
+    {
+      EXPECT_EQ( count, 1 );
+      EXPECT_EQ( edges.count( { edge.second, edge.first } ), 1U );
+    }
+
+    // Euler characteristic of a closed triangulated sphere
+    EXPECT_EQ( hull.vertices.size() + hull.planes.size(), edges.size() / 2 + 2 );
+  }
+};
+
+TEST_F( ConvexHullTest, CubeIgnoresInteriorPoints )
+{
+  const auto points = cubeWithInterior();
+  const auto hull   = makeConvexHull( points );
+  ASSERT_TRUE( hull.has_value() );
+
+  // The eight corners, two triangles per side
+  EXPECT_EQ( hull->vertices, ( std::vector<uint32_t>{ 0, 1, 2, 3, 4, 5, 6, 7 } ) );
+  EXPECT_EQ( hull->planes.size(), 12U );
+  expectValidHull( *hull, points, 1e-5F );
+
+  for ( const auto& plane : hull->planes )
+  {
+    EXPECT_NEAR( magnitude( plane.getNormal() ), 1.0F, 1e-5F );
+    EXPECT_GT( dot( plane, Point3{ 0.5F, 0.5F, 0.5F } ), -0.5F - 1e-5F );
+    EXPECT_LT( dot( plane, Point3{ 0.5F, 0.5F, 0.5F } ), 0.0F );
+  }
+}
+
+TEST_F( ConvexHullTest, SphereKeepsEveryPoint )
+{
+  const auto points = spherePoints( 2000 );
+  const auto hull   = makeConvexHull( points );
+  ASSERT_TRUE( hull.has_value() );
+  EXPECT_EQ( hull->vertices.size(), points.size() );
+  expectValidHull( *hull, points, 1e-5F );
+}
+
+TEST_F( ConvexHullTest, BuilderIsReusable )
+{
+  ConvexHullBuilder builder;
+  const auto        sphere = spherePoints( 500 );
+  const auto        cube   = cubeWithInterior();
+
+  const auto first  = builder.build( sphere );
+  const auto second = builder.build( cube );
+  const auto third  = builder.build( sphere );
+  ASSERT_TRUE( first.has_value() && second.has_value() && third.has_value() );
+  EXPECT_EQ( second->vertices.size(), 8U );
+  EXPECT_EQ( first->indices, third->indices );
+}
+
+TEST_F( ConvexHullTest, DegenerateInputFails )
+{
+  EXPECT_FALSE( makeConvexHull( std::vector<Point3>{} ).has_value() );
+  EXPECT_FALSE( makeConvexHull( std::vector<Point3>{ Point3{ 0.0F, 0.0F, 0.0F },
+                                  Point3{ 1.0F, 0.0F, 0.0F },
+                                  Point3{ 0.0F, 1.0F, 0.0F } } )
+                  .has_value() );
+
+  // Coplanar and collinear sets
+  std::vector<Point3> flat;
+  std::vector<Point3> line;
+  for ( int i = 0; i != 50; ++i )
+  {
+    const auto f = static_cast<float>( i );
+    flat.emplace_back( std::sin( f ), std::cos( f * 1.3F ), 2.0F );
+    line.emplace_back( f, 2.0F * f, -f );
+  }
+  EXPECT_FALSE( makeConvexHull( flat ).has_value() );
+  EXPECT_FALSE( makeConvexHull( line ).has_value() );
+}
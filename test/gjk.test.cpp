@@ -0,0 +1,160 @@
+#include "mirage_math/gjk.hpp"
+#include <array>
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace Mirage::Math;
+
+// Box that counts its support queries, to observe warm starting
+struct CountingBox
+{
+  AABB box;
+  int* calls;
+};
+
+inline Point3 support( const CountingBox& shape, const Vec3& direction )
+{
+  ++*shape.calls;
+  return support( shape.box, direction );
+}
+
+inline float supportRadius( const CountingBox& /*shape*/ ) { return 0.0F; }
+
+class GJKTest : public ::testing::Test
+{
+protected:
+  AABB unit_box{ Point3{ 0.0F, 0.0F, 0.0F }, Point3{ 1.0F, 1.0F, 1.0F } };
+
+  std::array<Point3, 8> cube_corners{ Point3{ -0.5F, -0.5F, -0.5F },
+    Point3{ 0.5F, -0.5F, -0.5F },
+    Point3{ -0.5F, 0.5F, -0.5F },
+    Point3{ 0.5F, 0.5F, -0.5F },
+    Point3{ -0.5F, -0.5F, 0.5F },
+    Point3{ 0.5F, -0.5F, 0.5F },
+    Point3{ -0.5F, 0.5F, 0.5F },
+    Point3{ 0.5F, 0.5F, 0.5F } };
+
+  static AABB offsetBox( const AABB& box, const Vec3& offset )
+  {
+    return AABB{ box.min() + offset, box.max() + offset };
+  }
+};
+
+TEST_F( GJKTest, SupportFunctions )
+{
+  const Point3 corner = support( unit_box, Vec3{ 1.0F, -1.0F, 0.5F } );
+  EXPECT_FLOAT_EQ( corner.x(), 1.0F );
+  EXPECT_FLOAT_EQ( corner.y(), 0.0F );
+  EXPECT_FLOAT_EQ( corner.z(), 1.0F );
+
+  const Capsule capsule{ Point3{ 0.0F, 0.0F, 0.0F }, Point3{ 0.0F, 2.0F, 0.0F }, 0.5F };
+  EXPECT_FLOAT_EQ( support( capsule, Vec3{ 0.0F, 1.0F, 0.0F } ).y(), 2.0F );
+  EXPECT_FLOAT_EQ( support( capsule, Vec3{ 0.0F, -1.0F, 0.0F } ).y(), 0.0F );
+  EXPECT_FLOAT_EQ( supportRadius( capsule ), 0.5F );
+
+  // A quarter turn about z maps the local +x corner onto world +y
+  const float                     half = std::sqrt( 0.5F );
+  const Transformed<ConvexPoints> rotated{ ConvexPoints{ cube_corners },
+    Quaternion{ 0.0F, 0.0F, half, half },
+    Point3{ 10.0F, 0.0F, 0.0F } };
+  const Point3                    top = support( rotated, Vec3{ 0.1F, 1.0F, 0.2F } );
+  EXPECT_NEAR( top.x(), 10.5F, 1e-5F );
+  EXPECT_NEAR( top.y(), 0.5F, 1e-5F );
+  EXPECT_NEAR( top.z(), 0.5F, 1e-5F );
+}
+
+TEST_F( GJKTest, DistanceBetweenSeparatedShapes )
+{
+  const auto boxes = getClosestPoints( unit_box, offsetBox( unit_box, Vec3{ 3.0F, 0.5F, 0.0F } ) );
+  ASSERT_TRUE( boxes.has_value() );
+  EXPECT_NEAR( boxes->distance, 2.0F, 1e-5F );
+  EXPECT_NEAR( boxes->a.x(), 1.0F, 1e-5F );
+  EXPECT_NEAR( boxes->b.x(), 3.0F, 1e-5F );
+
+  const auto spheres =
+    getClosestPoints( Sphere{ Point3{ 0.0F, 0.0F, 0.0F }, 1.0F }, Sphere{ Point3{ 0.0F, 4.0F, 3.0F }, 2.0F } );
+  ASSERT_TRUE( spheres.has_value() );
+  EXPECT_NEAR( spheres->distance, 2.0F, 1e-5F );
+  EXPECT_NEAR( spheres->a.y(), 0.8F, 1e-5F );
+  EXPECT_NEAR( spheres->b.z(), 1.8F, 1e-5F );
+
+  // Capsule lying above a box: the distance is along y from the core segment minus the radius
+  const Capsule capsule{ Point3{ -2.0F, 3.0F, 0.5F }, Point3{ 2.0F, 3.0F, 0.5F }, 0.5F };
+  const auto    capsule_box = getClosestPoints( capsule, unit_box );
+  ASSERT_TRUE( capsule_box.has_value() );
+  EXPECT_NEAR( capsule_box->distance, 1.5F, 1e-5F );
+  EXPECT_NEAR( capsule_box->a.y(), 2.5F, 1e-5F );
+  EXPECT_NEAR( capsule_box->b.y(), 1.0F, 1e-5F );
+
+  // A cube turned by 45 degrees reaches sqrt(0.5) towards a sphere on its diagonal axis
+  const float                     half = std::sqrt( 0.5F );
+  const Transformed<ConvexPoints> rotated{ ConvexPoints{ cube_corners },
+    Quaternion{ 0.0F, 0.0F, std::sin( PI / 8.0F ), std::cos( PI / 8.0F ) },
+    Point3{ 0.0F, 0.0F, 0.0F } };
+  const auto                      hull_sphere = getClosestPoints( rotated, Sphere{ Point3{ 3.0F, 0.0F, 0.0F }, 1.0F } );
+  ASSERT_TRUE( hull_sphere.has_value() );
+  EXPECT_NEAR( hull_sphere->distance, 2.0F - half, 1e-5F );
+
+  const OBB obb{ Point3{ 0.0F, -5.0F, 0.0F }, Mat3::identity(), Vec3{ 1.0F, 2.0F, 1.0F } };
+  const auto obb_box = getClosestPoints( obb, unit_box );
+  ASSERT_TRUE( obb_box.has_value() );
+  EXPECT_NEAR( obb_box->distance, 3.0F, 1e-5F );
+}
+
+TEST_F( GJKTest, OverlapsAndPenetration )
+{
+  GJKSimplex simplex;
+  const AABB shifted = offsetBox( unit_box, Vec3{ 0.75F, 0.1F, 0.2F } );
+  EXPECT_TRUE( overlaps( unit_box, shifted, simplex ) );
+  EXPECT_FALSE( getClosestPoints( unit_box, shifted ).has_value() );
+
+  const auto boxes = getPenetration( unit_box, shifted );
+  ASSERT_TRUE( boxes.has_value() );
+  EXPECT_NEAR( boxes->depth, 0.25F, 1e-4F );
+  EXPECT_NEAR( boxes->normal.x(), 1.0F, 1e-4F );
+
+  // Only the radii overlap: resolved without EPA
+  const auto spheres =
+    getPenetration( Sphere{ Point3{ 0.0F, 0.0F, 0.0F }, 1.0F }, Sphere{ Point3{ 1.5F, 0.0F, 0.0F }, 1.0F } );
+  ASSERT_TRUE( spheres.has_value() );
+  EXPECT_NEAR( spheres->depth, 0.5F, 1e-5F );
+  EXPECT_NEAR( spheres->normal.x(), 1.0F, 1e-5F );
+  EXPECT_NEAR( spheres->a.x(), 1.0F, 1e-5F );
+  EXPECT_NEAR( spheres->b.x(), 0.5F, 1e-5F );
+
+  // Sphere center inside the box, just below its top: pushed out upwards by the core depth plus the radius
+  const auto deep = getPenetration( unit_box, Sphere{ Point3{ 0.5F, 0.9F, 0.5F }, 0.25F } );
+  ASSERT_TRUE( deep.has_value() );
+  EXPECT_NEAR( deep->depth, 0.35F, 1e-4F );
+  EXPECT_NEAR( deep->normal.y(), 1.0F, 1e-4F );
+
+  EXPECT_FALSE( getPenetration( unit_box, offsetBox( unit_box, Vec3{ 1.5F, 0.0F, 0.0F } ) ).has_value() );
+}
+
+TEST_F( GJKTest, WarmStartReusesSimplex )
+{
+  int        calls = 0;
+  GJKSimplex warm;
+  float      cold_calls = 0.0F;
+  float      warm_calls = 0.0F;
+
+  // A box sliding past another one in small steps, separated throughout
+  for ( int step = 0; step != 50; ++step )
+  {
+    const CountingBox a{ unit_box, &calls };
+    const float       y = -2.0F + 0.08F * static_cast<float>( step );
+    const CountingBox b{ offsetBox( unit_box, Vec3{ 2.0F, y, 0.3F } ), &calls };
+
+    calls           = 0;
+    const auto cold = getClosestPoints( a, b );
+    cold_calls += static_cast<float>( calls );
+
+    calls           = 0;
+    const auto hot = getClosestPoints( a, b, warm );
+    warm_calls += static_cast<float>( calls );
+
+    ASSERT_TRUE( cold.has_value() && hot.has_value() );
+    EXPECT_NEAR( cold->distance, hot->distance, 1e-5F );
+  }
+  EXPECT_LT( warm_calls, cold_calls );
+}
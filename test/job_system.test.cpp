@@ -0,0 +1,126 @@
+#include "mirage_math/job_system.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class JobSystemTest : public ::testing::Test
+{
+protected:
+  JobSystem jobs{ 4 };
+
+  // Sums [first, last) by splitting it into tasks down to 100 numbers
+  static void sumRange( TaskGroup& group, std::atomic<uint64_t>& total, uint64_t first, uint64_t last )
+  {
+    while ( last - first > 100 )
+    {
+      const uint64_t middle = first + ( last - first ) / 2;
+      group.run( [&group, &total, middle, last]() { sumRange( group, total, middle, last ); } );
+      last = middle;
+    }
+    uint64_t sum = 0;
+    for ( uint64_t i = first; i != last; ++i )
+    {
+      sum += i;
+    }
+    total += sum;
+  }
+};
+
+TEST_F( JobSystemTest, ParallelForVisitsEveryIndexOnce )
+{
+  EXPECT_EQ( jobs.workerCount(), 4U );
+  EXPECT_FALSE( jobs.currentWorker().has_value() );
+
+  std::vector<std::atomic<int>> visits( 100003 );
+  jobs.parallelFor( 0, visits.size(), 64, [&]( size_t first, size_t last ) {
+    EXPECT_LE( last - first, 64U );
+    for ( size_t i = first; i != last; ++i )
+    {
+      ++visits[i];
+    }
+  } );
+  EXPECT_TRUE( std::all_of( visits.begin(), visits.end(), []( const auto& count ) { return count == 1; } ) );
+
+  // Nested loops run on the workers of the outer one
+  std::vector<std::atomic<int>> cells( 200 * 300 );
+  jobs.parallelFor( 0, 200, 8, [&]( size_t row_first, size_t row_last ) {
+    for ( size_t row = row_first; row != row_last; ++row )
+    {
+      EXPECT_TRUE( jobs.currentWorker().has_value() );
+      jobs.parallelFor( 0, 300, 16, [&]( size_t first, size_t last ) {
+        for ( size_t col = first; col != last; ++col )
+        {
+          ++cells[row * 300 + col];
+        }
+      } );
+    }
+  } );
+  EXPECT_TRUE( std::all_of( cells.begin(), cells.end(), []( const auto& count ) { return count == 1; } ) );
+
+  // Empty and single-grain ranges run inline
+  size_t calls = 0;
+  jobs.parallelFor( 5, 5, 16, [&]( size_t, size_t ) { ++calls; } );
+  jobs.parallelFor( 0, 10, 16, [&]( size_t, size_t ) { ++calls; } );
+  EXPECT_EQ( calls, 1U );
+}
+
+TEST_F( JobSystemTest, TaskGroupsJoinSpawnedTasks )
+{
+  std::atomic<uint64_t> total{};
+  TaskGroup             group( jobs );
+  group.run( [&]() { sumRange( group, total, 0, 1000000 ); } );
+  group.wait();
+  EXPECT_EQ( total.load(), 999999ULL * 1000000ULL / 2 );
+
+  // Reusable after a wait, and exceptions reach the waiting thread
+  group.run( []() { throw std::runtime_error( "task failed" ); } );
+  group.run( [&]() { ++total; } );
+  EXPECT_THROW( group.wait(), std::runtime_error );
+
+  group.run( [&]() { total = 0; } );
+  group.wait();
+  EXPECT_EQ( total.load(), 0U );
+
+  EXPECT_THROW( jobs.parallelFor( 0, 1000, 10,
+                  []( size_t first, size_t ) {
+                    if ( first == 500 )
+                    {
+                      throw std::out_of_range( "index" );
+                    }
+                  } ),
+    std::out_of_range );
+}
+
+TEST_F( JobSystemTest, WorkersHaveArenasAndCounters )
+{
+  jobs.resetStats();
+
+  std::vector<float> sums( 64 );
+  jobs.parallelFor( 0, sums.size(), 1, [&]( size_t first, size_t last ) {
+    for ( size_t i = first; i != last; ++i )
+    {
+      const ArenaScope scope( jobs.arena() );
+      auto             scratch = jobs.arena().allocate<float>( 1000 );
+      std::iota( scratch.begin(), scratch.end(), 0.0F );
+      sums[i] = std::accumulate( scratch.begin(), scratch.end(), 0.0F );
+    }
+  } );
+  EXPECT_TRUE( std::all_of( sums.begin(), sums.end(), []( float sum ) { return sum == 499500.0F; } ) );
+
+  const auto stats = jobs.stats();
+  ASSERT_EQ( stats.size(), 4U );
+  uint64_t job_count = 0;
+  for ( const auto& worker : stats )
+  {
+    job_count += worker.jobs;
+    EXPECT_GE( worker.utilization, 0.0 );
+    EXPECT_LE( worker.utilization, 1.0 );
+  }
+  EXPECT_EQ( job_count, sums.size() );
+}
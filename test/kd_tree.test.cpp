@@ -0,0 +1,138 @@
+#include "mirage_math/kd_tree.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class KDTreeTest : public ::testing::Test
+{
+protected:
+  std::vector<Point3> points;
+  std::vector<Point3> queries;
+
+  void SetUp() override
+  {
+    for ( int i = 0; i != 2000; ++i )
+    {
+      const auto f = static_cast<float>( i );
+      points.emplace_back( std::sin( f * 0.37F ) * 10.0F, std::cos( f * 1.91F ) * 10.0F, std::sin( f * 0.07F ) * 3.0F );
+    }
+    // Duplicates must be reported as separate neighbors
+    points.push_back( points[17] );
+    for ( int i = 0; i != 150; ++i )
+    {
+      const auto f = static_cast<float>( i );
+      queries.emplace_back( std::cos( f * 0.5F ) * 11.0F, std::sin( f * 0.11F ) * 9.0F, f * 0.01F );
+    }
+  }
+
+  std::vector<Neighbor> bruteForce( const Point3& query, size_t k ) const
+  {
+    std::vector<Neighbor> all;
+    for ( uint32_t i = 0; i != points.size(); ++i )
+    {
+      all.push_back( Neighbor{ i, magnitudeSquared( points[i] - query ) } );
+    }
+    std::sort( all.begin(), all.end(), []( const Neighbor& a, const Neighbor& b ) {
+      return a.distanceSquared < b.distanceSquared;
+    } );
+    all.resize( std::min( k, all.size() ) );
+    return all;
+  }
+
+  // Ties may come back in any order, so results are compared by distance
+  static void expectSameDistances( std::span<const Neighbor> found, std::span<const Neighbor> expected )
+  {
+    ASSERT_EQ( found.size(), expected.size() );
+    for ( size_t i = 0; i != found.size(); ++i )
+    {
+      EXPECT_FLOAT_EQ( found[i].distanceSquared, expected[i].distanceSquared );
+    }
+  }
+};
+
+TEST_F( KDTreeTest, NearestMatchesBruteForce )
+{
+  KDTree tree{ points };
+  EXPECT_EQ( tree.size(), points.size() );
+
+  for ( const auto& query : queries )
+  {
+    const auto nearest = tree.findNearest( query );
+    ASSERT_TRUE( nearest.has_value() );
+    EXPECT_FLOAT_EQ( nearest->distanceSquared, bruteForce( query, 1 ).front().distanceSquared );
+    EXPECT_FLOAT_EQ( magnitudeSquared( points[nearest->index] - query ), nearest->distanceSquared );
+  }
+  EXPECT_FALSE( KDTree{}.findNearest( queries.front() ).has_value() );
+}
+
+TEST_F( KDTreeTest, KNearestMatchesBruteForce )
+{
+  KDTree tree{
+    points, KDTreeOptions{ 3, 256 }
+  };
+
+  std::vector<Neighbor> found( 12 );
+  for ( const auto& query : queries )
+  {
+    ASSERT_EQ( tree.findNearest( query, found ), found.size() );
+    expectSameDistances( found, bruteForce( query, found.size() ) );
+  }
+
+  // A distance limit cuts the result short
+  const Point3 query    = points[5];
+  const size_t in_limit = tree.findNearest( query, found, 1.0F );
+  const auto   expected = bruteForce( query, found.size() );
+  const auto   in_range = std::count_if( expected.begin(), expected.end(), []( const Neighbor& neighbor ) {
+    return neighbor.distanceSquared < 1.0F;
+  } );
+  EXPECT_EQ( in_limit, static_cast<size_t>( in_range ) );
+}
+
+TEST_F( KDTreeTest, RadiusSearchMatchesBruteForce )
+{
+  KDTree tree{ points };
+  for ( const auto& query : queries )
+  {
+    std::vector<uint32_t> found;
+    tree.queryRadius( query, 1.5F, [&found]( uint32_t index, float ) { found.push_back( index ); } );
+    std::sort( found.begin(), found.end() );
+
+    std::vector<uint32_t> expected;
+    for ( uint32_t i = 0; i != points.size(); ++i )
+    {
+      if ( magnitudeSquared( points[i] - query ) <= 1.5F * 1.5F )
+      {
+        expected.push_back( i );
+      }
+    }
+    EXPECT_EQ( found, expected );
+  }
+}
+
+TEST_F( KDTreeTest, BatchedQueriesMatchSingleQueries )
+{
+  // A low threshold and grain split both the build and the batch into jobs
+  JobSystem jobs{ 3 };
+  KDTree    tree{
+    points, KDTreeOptions{ .leafSize = 8, .parallelThreshold = 64, .grainSize = 16, .jobSystem = &jobs }
+  };
+
+  constexpr size_t      k = 5;
+  std::vector<Neighbor> batched( queries.size() * k );
+  EXPECT_EQ( tree.findNearest( queries, k, batched ), queries.size() * k );
+
+  std::vector<Neighbor> single( k );
+  for ( size_t i = 0; i != queries.size(); ++i )
+  {
+    tree.findNearest( queries[i], single );
+    expectSameDistances( std::span{ batched }.subspan( i * k, k ), single );
+  }
+
+  // Fewer points than k pads the rows
+  KDTree                small{ std::span{ points }.first( 3 ) };
+  std::vector<Neighbor> padded( 2 * k );
+  EXPECT_EQ( small.findNearest( std::span{ queries }.first( 2 ), k, padded ), 6U );
+  EXPECT_EQ( padded[k - 1].distanceSquared, std::numeric_limits<float>::infinity() );
+}
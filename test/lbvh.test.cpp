@@ -0,0 +1,100 @@
+#include "mirage_math/lbvh.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class LinearBVHTest : public ::testing::Test
+{
+protected:
+  std::vector<AABB> primitives;
+
+  void SetUp() override
+  {
+    for ( int i = 0; i != 3000; ++i )
+    {
+      const auto   f = static_cast<float>( i );
+      const Point3 center{ std::sin( f * 0.13F ) * 30.0F, std::cos( f * 0.71F ) * 10.0F, std::sin( f * 1.9F ) * 5.0F };
+      const float  size = 0.2F + 0.1F * static_cast<float>( i % 3 );
+      primitives.emplace_back( center - Vec3{ size, size, size }, center + Vec3{ size, size, size } );
+    }
+    // Duplicates share a Morton code and must still split
+    for ( int i = 0; i != 40; ++i )
+    {
+      primitives.push_back( primitives.front() );
+    }
+  }
+
+  void expectValid( const BVH& bvh, uint32_t max_leaf_size ) const
+  {
+    ASSERT_FALSE( bvh.isEmpty() );
+    std::vector<int> seen( primitives.size() );
+    const auto       nodes = bvh.nodes();
+    for ( size_t index = 0; index != nodes.size(); ++index )
+    {
+      const BVHNode& node = nodes[index];
+      if ( node.isLeaf() )
+      {
+        EXPECT_LE( node.count, max_leaf_size );
+        for ( uint32_t i = node.leftFirst; i != node.leftFirst + node.count; ++i )
+        {
+          const uint32_t primitive = bvh.primitiveIndices()[i];
+          seen[primitive]++;
+          EXPECT_TRUE( contains( node.bounds(), primitives[primitive] ) );
+        }
+      } else
+      {
+        // Children follow their parent so refit's reverse sweep stays valid
+        EXPECT_GT( node.leftFirst, index );
+        EXPECT_TRUE( contains( node.bounds(), nodes[node.leftFirst].bounds() ) );
+        EXPECT_TRUE( contains( node.bounds(), nodes[node.leftFirst + 1].bounds() ) );
+      }
+    }
+    EXPECT_TRUE( std::all_of( seen.begin(), seen.end(), []( int count ) { return count == 1; } ) );
+  }
+};
+
+TEST_F( LinearBVHTest, BuildCoversEveryPrimitiveOnce )
+{
+  expectValid( LinearBVHBuilder::build( primitives ), 4U );
+  expectValid( LinearBVHBuilder::build( primitives, BVHBuildOptions{ 1, 256 } ), 1U );
+  EXPECT_TRUE( LinearBVHBuilder::build( {} ).isEmpty() );
+}
+
+TEST_F( LinearBVHTest, QueriesMatchBruteForce )
+{
+  BVH        bvh = LinearBVHBuilder::build( primitives );
+  const AABB query{ Point3{ -5.0F, -2.0F, -1.0F }, Point3{ 8.0F, 3.0F, 2.0F } };
+
+  std::vector<uint32_t> found;
+  bvh.queryOverlaps( query, [&]( uint32_t primitive ) {
+    if ( overlaps( primitives[primitive], query ) )
+    {
+      found.push_back( primitive );
+    }
+  } );
+  std::sort( found.begin(), found.end() );
+
+  std::vector<uint32_t> expected;
+  for ( uint32_t i = 0; i != primitives.size(); ++i )
+  {
+    if ( overlaps( primitives[i], query ) )
+    {
+      expected.push_back( i );
+    }
+  }
+  EXPECT_FALSE( expected.empty() );
+  EXPECT_EQ( found, expected );
+}
+
+TEST_F( LinearBVHTest, RefitAfterMotion )
+{
+  BVH bvh = LinearBVHBuilder::build( primitives );
+  for ( auto& box : primitives )
+  {
+    box = AABB{ box.min() + Vec3{ 0.5F, -0.25F, 0.0F }, box.max() + Vec3{ 0.5F, -0.25F, 0.0F } };
+  }
+  bvh.refit( primitives );
+  expectValid( bvh, 4U );
+}
@@ -1,6 +1,8 @@
 #include "mirage_math/line.hpp"
+#include <array>
 #include <gtest/gtest-death-test.h>
 #include <gtest/gtest.h>
+#include <vector>
 
 using namespace Mirage::Math;
 
@@ -101,3 +103,65 @@ TEST_F( LineTest, DistanceBetweenIntersectingLines )
   float distance_computed = distance( line_a, line_b );
   EXPECT_FLOAT_EQ( distance_computed, expected );
 }
+
+TEST_F( LineTest, ClosestParametersOfSkewLines )
+{
+  Line line_a( Point3{ 0.0F, 0.0F, 0.0F }, Vec3{ 2.0F, 0.0F, 0.0F } );
+  Line line_b( Point3{ 3.0F, -1.0F, 1.0F }, Vec3{ 0.0F, 1.0F, 0.0F } );
+
+  auto parameters = getClosestParameters( line_a, line_b );
+  ASSERT_TRUE( parameters.has_value() );
+  EXPECT_FLOAT_EQ( parameters->t1, 1.5F );
+  EXPECT_FLOAT_EQ( parameters->t2, 1.0F );
+  EXPECT_FALSE( getClosestParameters( line_a, Line( Point3{ 0.0F, 1.0F, 0.0F }, Vec3{ 1.0F, 0.0F, 0.0F } ) ) );
+}
+
+TEST_F( LineTest, BatchedClosestParametersMatchScalar )
+{
+  constexpr size_t  count = 70;
+  std::vector<Line> lines_a;
+  std::vector<Line> lines_b;
+  for ( size_t i = 0; i != count; ++i )
+  {
+    const auto f = static_cast<float>( i );
+    lines_a.emplace_back( Point3{ f, 0.0F, 1.0F }, Vec3{ 1.0F, std::sin( f ), 0.0F } );
+    // Every fifth pair is parallel
+    lines_b.emplace_back( Point3{ 0.0F, f, -1.0F },
+      i % 5 == 0 ? lines_a.back().vector() * 2.0F : Vec3{ std::cos( f ), 1.0F, 0.5F } );
+  }
+
+  std::array<std::vector<float>, 12> streams;
+  for ( auto& stream : streams )
+  {
+    stream.resize( count );
+  }
+  for ( size_t i = 0; i != count; ++i )
+  {
+    for ( size_t axis = 0; axis != 3; ++axis )
+    {
+      streams[axis][i]     = lines_a[i].point()[axis];
+      streams[3 + axis][i] = lines_a[i].vector()[axis];
+      streams[6 + axis][i] = lines_b[i].point()[axis];
+      streams[9 + axis][i] = lines_b[i].vector()[axis];
+    }
+  }
+  const auto soa = [&streams]( size_t first ) {
+    return SoALine{
+      SoAVec3{ streams[first], streams[first + 1], streams[first + 2] },
+      SoAVec3{ streams[first + 3], streams[first + 4], streams[first + 5] }
+    };
+  };
+
+  std::vector<float>    t1( count );
+  std::vector<float>    t2( count );
+  std::vector<uint64_t> skew( maskWordCount( count ) );
+  EXPECT_EQ( getClosestParameters( soa( 0 ), soa( 6 ), t1, t2, skew ), count - count / 5 );
+
+  for ( size_t i = 0; i != count; ++i )
+  {
+    ClosestParameters expected;
+    EXPECT_EQ( closestParameters( lines_a[i], lines_b[i], expected ), isMaskSet( skew, i ) );
+    EXPECT_FLOAT_EQ( t1[i], expected.t1 );
+    EXPECT_FLOAT_EQ( t2[i], expected.t2 );
+  }
+}
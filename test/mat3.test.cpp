@@ -350,3 +350,21 @@ TEST_F( Mat3Test, NonZeroAngleSkew )
   EXPECT_FLOAT_EQ( output_vec.y(), tan );
   EXPECT_FLOAT_EQ( output_vec.z(), 0.0F );
 }
+
+TEST_F( Mat3Test, EigenDecompositionOfSymmetric )
+{
+  Mat3 symmetric{ 4.0F, 1.0F, 2.0F, 1.0F, 3.0F, 0.5F, 2.0F, 0.5F, 5.0F };
+
+  auto eigen = eigenDecomposition( symmetric );
+  for ( size_t i = 0; i != 3; ++i )
+  {
+    const Vec3& v = eigen.vectors[i];
+    EXPECT_TRUE( isUnitVector( v, 1e-5F ) );
+
+    Vec3 av{ dot( Vec3{ symmetric( 0, 0 ), symmetric( 0, 1 ), symmetric( 0, 2 ) }, v ),
+      dot( Vec3{ symmetric( 1, 0 ), symmetric( 1, 1 ), symmetric( 1, 2 ) }, v ),
+      dot( Vec3{ symmetric( 2, 0 ), symmetric( 2, 1 ), symmetric( 2, 2 ) }, v ) };
+    EXPECT_TRUE( areVectorsEqual( av, v * eigen.values[i], 1e-4F ) );
+  }
+  EXPECT_NEAR( eigen.values[0] + eigen.values[1] + eigen.values[2], 12.0F, 1e-4F );
+}
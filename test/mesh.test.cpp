@@ -0,0 +1,167 @@
+#include "mirage_math/mesh.hpp"
+#include "test_utils.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class MeshTest : public ::testing::Test
+{
+protected:
+  struct Grid
+  {
+    std::vector<Point3>   positions;
+    std::vector<Vec2>     uvs;
+    std::vector<uint32_t> indices;
+  };
+
+  // side x side vertices on z = height( x, y ), uv = ( x, y ), two CCW triangles per cell
+  template<typename Height>
+  static Grid makeGrid( uint32_t side, Height&& height )
+  {
+    Grid grid;
+    for ( uint32_t j = 0; j != side; ++j )
+    {
+      for ( uint32_t i = 0; i != side; ++i )
+      {
+        const auto x = static_cast<float>( i ) / static_cast<float>( side - 1 );
+        const auto y = static_cast<float>( j ) / static_cast<float>( side - 1 );
+        grid.positions.emplace_back( x, y, height( x, y ) );
+        grid.uvs.emplace_back( x, y );
+      }
+    }
+    for ( uint32_t j = 0; j + 1 != side; ++j )
+    {
+      for ( uint32_t i = 0; i + 1 != side; ++i )
+      {
+        const uint32_t v = j * side + i;
+        grid.indices.insert( grid.indices.end(), { v, v + 1, v + side + 1, v, v + side + 1, v + side } );
+      }
+    }
+    return grid;
+  }
+
+  static Grid makeBumpyGrid( uint32_t side )
+  {
+    return makeGrid( side, []( float x, float y ) { return 0.2F * std::sin( 7.0F * x ) * std::cos( 5.0F * y ); } );
+  }
+};
+
+TEST_F( MeshTest, AdjacencyGroupsCornersByVertex )
+{
+  const std::vector<uint32_t> indices{ 0, 1, 2, 2, 1, 3 };
+  const auto                  adjacency = makeVertexAdjacency( indices, 5 );
+
+  ASSERT_EQ( adjacency.vertexCount(), 5U );
+  EXPECT_EQ( adjacency.offsets, ( std::vector<uint32_t>{ 0, 1, 3, 5, 6, 6 } ) );
+  EXPECT_EQ( adjacency.corners, ( std::vector<uint32_t>{ 0, 1, 4, 2, 3, 5 } ) );
+  EXPECT_TRUE( adjacency.cornersOf( 4 ).empty() );
+}
+
+TEST_F( MeshTest, AreaWeightedNormals )
+{
+  // Octahedron: every vertex is surrounded symmetrically, so its normal is its own direction
+  const std::vector<Point3>   positions{ Point3{ 1.0F, 0.0F, 0.0F },
+    Point3{ -1.0F, 0.0F, 0.0F },
+    Point3{ 0.0F, 1.0F, 0.0F },
+    Point3{ 0.0F, -1.0F, 0.0F },
+    Point3{ 0.0F, 0.0F, 1.0F },
+    Point3{ 0.0F, 0.0F, -1.0F } };
+  const std::vector<uint32_t> indices{
+    0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4, 2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5 };
+
+  std::vector<Vec3> normals( positions.size() );
+  computeVertexNormals( positions, indices, normals );
+  for ( size_t i = 0; i != positions.size(); ++i )
+  {
+    EXPECT_NEAR( normals[i].x(), positions[i].x(), 1e-6F );
+    EXPECT_NEAR( normals[i].y(), positions[i].y(), 1e-6F );
+    EXPECT_NEAR( normals[i].z(), positions[i].z(), 1e-6F );
+  }
+
+  // A larger triangle pulls the shared vertex's normal towards its own
+  const std::vector<Point3>   hinge{ Point3{ 0.0F, 0.0F, 0.0F },
+    Point3{ 0.0F, 1.0F, 0.0F },
+    Point3{ 1.0F, 0.0F, 0.0F },
+    Point3{ 0.0F, 0.0F, 3.0F },
+    Point3{ 5.0F, 5.0F, 5.0F } };
+  const std::vector<uint32_t> hinge_indices{ 0, 2, 1, 0, 1, 3 };
+  std::vector<Vec3>           hinge_normals( hinge.size() );
+  computeVertexNormals( hinge, hinge_indices, hinge_normals );
+  EXPECT_NEAR( hinge_normals[0].x(), 3.0F / std::sqrt( 10.0F ), 1e-6F );
+  EXPECT_NEAR( hinge_normals[0].z(), 1.0F / std::sqrt( 10.0F ), 1e-6F );
+  EXPECT_FLOAT_EQ( magnitude( hinge_normals[4] ), 0.0F );
+}
+
+TEST_F( MeshTest, TangentsFollowTextureDirection )
+{
+  auto grid = makeGrid( 8, []( float /*x*/, float /*y*/ ) { return 0.0F; } );
+
+  std::vector<Vec3> normals( grid.positions.size() );
+  std::vector<Vec4> tangents( grid.positions.size() );
+  computeVertexNormals( grid.positions, grid.indices, normals );
+  computeTangents( grid.positions, normals, grid.uvs, grid.indices, tangents );
+  for ( size_t i = 0; i != tangents.size(); ++i )
+  {
+    EXPECT_NEAR( normals[i].z(), 1.0F, 1e-6F );
+    EXPECT_NEAR( tangents[i].x(), 1.0F, 1e-6F );
+    EXPECT_FLOAT_EQ( tangents[i].w(), 1.0F );
+  }
+
+  // Mirrored u: the tangent flips and so does the handedness, keeping the bitangent along +v
+  for ( auto& uv : grid.uvs )
+  {
+    uv = Vec2{ -uv.x(), uv.y() };
+  }
+  computeTangents( grid.positions, normals, grid.uvs, grid.indices, tangents );
+  for ( const auto& tangent : tangents )
+  {
+    EXPECT_NEAR( tangent.x(), -1.0F, 1e-6F );
+    EXPECT_FLOAT_EQ( tangent.w(), -1.0F );
+    const Vec3 bitangent = cross( Vec3{ 0.0F, 0.0F, 1.0F }, tangent.toSubVec<3>() ) * tangent.w();
+    EXPECT_NEAR( bitangent.y(), 1.0F, 1e-6F );
+  }
+
+  // Degenerate texture coordinates still give a frame orthogonal to the normal
+  for ( auto& uv : grid.uvs )
+  {
+    uv = Vec2{ 0.5F, 0.5F };
+  }
+  computeTangents( grid.positions, normals, grid.uvs, grid.indices, tangents );
+  for ( const auto& tangent : tangents )
+  {
+    EXPECT_NEAR( magnitude( tangent.toSubVec<3>() ), 1.0F, 1e-6F );
+    EXPECT_NEAR( tangent.z(), 0.0F, 1e-6F );
+  }
+}
+
+TEST_F( MeshTest, ParallelMatchesSequential )
+{
+  const auto grid      = makeBumpyGrid( 200 );
+  const auto adjacency = makeVertexAdjacency( grid.indices, grid.positions.size() );
+
+  const MeshOptions sequential{ .parallelThreshold = SIZE_MAX };
+  const MeshOptions parallel{ .parallelThreshold = 1, .grainSize = 97 };
+
+  std::vector<Vec3> normals( grid.positions.size() );
+  std::vector<Vec3> parallel_normals( grid.positions.size() );
+  computeVertexNormals( grid.positions, grid.indices, adjacency, normals, sequential );
+  computeVertexNormals( grid.positions, grid.indices, adjacency, parallel_normals, parallel );
+
+  std::vector<Vec4> tangents( grid.positions.size() );
+  std::vector<Vec4> parallel_tangents( grid.positions.size() );
+  computeTangents( grid.positions, normals, grid.uvs, grid.indices, adjacency, tangents, sequential );
+  computeTangents( grid.positions, normals, grid.uvs, grid.indices, adjacency, parallel_tangents, parallel );
+
+  // Gathering sums in the same order on any thread, so the results are bitwise equal
+  for ( size_t i = 0; i != grid.positions.size(); ++i )
+  {
+    ASSERT_TRUE( areVectorsEqual( normals[i], parallel_normals[i], 0.0F ) );
+    ASSERT_TRUE( areVectorsEqual( tangents[i], parallel_tangents[i], 0.0F ) );
+    EXPECT_NEAR( magnitude( normals[i] ), 1.0F, 1e-5F );
+    EXPECT_NEAR( magnitude( tangents[i].toSubVec<3>() ), 1.0F, 1e-5F );
+    EXPECT_NEAR( dot( normals[i], tangents[i].toSubVec<3>() ), 0.0F, 1e-5F );
+    EXPECT_FLOAT_EQ( tangents[i].w(), 1.0F );
+  }
+}
@@ -0,0 +1,111 @@
+#include "mirage_math/morton.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class MortonTest : public ::testing::Test
+{
+protected:
+  // Bit-by-bit interleave, the reference for both codecs
+  static uint64_t interleave( const IVec3& cell, size_t bits )
+  {
+    uint64_t code = 0;
+    for ( size_t bit = 0; bit != bits; ++bit )
+    {
+      for ( size_t axis = 0; axis != 3; ++axis )
+      {
+        code |= static_cast<uint64_t>( ( static_cast<uint32_t>( cell[axis] ) >> bit ) & 1U ) << ( bit * 3 + axis );
+      }
+    }
+    return code;
+  }
+};
+
+TEST_F( MortonTest, Encode30MatchesInterleave )
+{
+  for ( int i = 0; i != 200; ++i )
+  {
+    const IVec3 cell{ ( i * 37 ) % 1024, ( i * 101 + 5 ) % 1024, ( i * 613 + 77 ) % 1024 };
+    const auto  code = encodeMorton30( cell );
+    EXPECT_EQ( code, interleave( cell, 10 ) );
+
+    const IVec3 decoded = decodeMorton30( code );
+    EXPECT_EQ( decoded.x(), cell.x() );
+    EXPECT_EQ( decoded.y(), cell.y() );
+    EXPECT_EQ( decoded.z(), cell.z() );
+    EXPECT_EQ( compactMortonBits30( expandMortonBits30( static_cast<uint32_t>( cell.x() ) ) ), cell.x() );
+  }
+  EXPECT_EQ( encodeMorton30( IVec3{ 1023, 1023, 1023 } ), 0x3FFFFFFFU );
+}
+
+TEST_F( MortonTest, Encode63MatchesInterleave )
+{
+  for ( int i = 0; i != 200; ++i )
+  {
+    const IVec3 cell{ ( i * 104729 ) % ( 1 << 21 ), ( i * 7919 + 13 ) % ( 1 << 21 ), ( i * 1299709 + 3 ) % ( 1 << 21 ) };
+    const auto  code = encodeMorton63( cell );
+    EXPECT_EQ( code, interleave( cell, 21 ) );
+
+    const IVec3 decoded = decodeMorton63( code );
+    EXPECT_EQ( decoded.x(), cell.x() );
+    EXPECT_EQ( decoded.y(), cell.y() );
+    EXPECT_EQ( decoded.z(), cell.z() );
+  }
+  EXPECT_EQ( encodeMorton63( IVec3{ ( 1 << 21 ) - 1, ( 1 << 21 ) - 1, ( 1 << 21 ) - 1 } ), ( uint64_t{ 1 } << 63 ) - 1 );
+}
+
+TEST_F( MortonTest, BatchedEncodingMatchesScalar )
+{
+  const AABB          bounds{ Point3{ -2.0F, 0.0F, 1.0F }, Point3{ 6.0F, 4.0F, 3.0F } };
+  std::vector<Point3> points;
+  std::vector<float>  x;
+  std::vector<float>  y;
+  std::vector<float>  z;
+  for ( int i = 0; i != 100; ++i )
+  {
+    const auto f = static_cast<float>( i );
+    // A few points fall outside the bounds and are clamped
+    points.emplace_back( std::sin( f ) * 5.0F + 2.0F, std::cos( f * 0.3F ) * 2.0F + 2.0F, f * 0.025F + 0.9F );
+    x.push_back( points.back().x() );
+    y.push_back( points.back().y() );
+    z.push_back( points.back().z() );
+  }
+
+  std::vector<uint32_t> codes30( points.size() );
+  std::vector<uint32_t> soa_codes30( points.size() );
+  std::vector<uint64_t> codes63( points.size() );
+  std::vector<uint64_t> soa_codes63( points.size() );
+  encodeMorton30( points, bounds, codes30 );
+  encodeMorton30( SoAVec3{ x, y, z }, bounds, soa_codes30 );
+  encodeMorton63( points, bounds, codes63 );
+  encodeMorton63( SoAVec3{ x, y, z }, bounds, soa_codes63 );
+  for ( size_t i = 0; i != points.size(); ++i )
+  {
+    EXPECT_EQ( codes30[i], encodeMorton30( points[i], bounds ) );
+    EXPECT_EQ( soa_codes30[i], codes30[i] );
+    EXPECT_EQ( codes63[i], encodeMorton63( points[i], bounds ) );
+    EXPECT_EQ( soa_codes63[i], codes63[i] );
+  }
+  EXPECT_EQ( encodeMorton30( bounds.min(), bounds ), 0U );
+  EXPECT_EQ( encodeMorton30( bounds.max(), bounds ), 0x3FFFFFFFU );
+}
+
+TEST_F( MortonTest, MortonOrderFollowsZCurve )
+{
+  std::vector<Point3> points;
+  for ( int i = 0; i != 64; ++i )
+  {
+    points.emplace_back( static_cast<float>( i % 4 ), static_cast<float>( ( i / 4 ) % 4 ), static_cast<float>( i / 16 ) );
+  }
+  std::reverse( points.begin(), points.end() );
+
+  const auto order = makeMortonOrder( points );
+  ASSERT_EQ( order.size(), points.size() );
+  const AABB bounds = makeBoundingBox( points );
+  for ( size_t i = 1; i != order.size(); ++i )
+  {
+    EXPECT_LT( encodeMorton30( points[order[i - 1]], bounds ), encodeMorton30( points[order[i]], bounds ) );
+  }
+}
@@ -0,0 +1,93 @@
+#include "mirage_math/obb.hpp"
+#include "test_utils.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class OBBTest : public ::testing::Test
+{
+protected:
+  OBB unitBox{ Point3{ 0.0F, 0.0F, 0.0F }, Mat3::identity(), Vec3{ 1.0F, 1.0F, 1.0F } };
+};
+
+TEST_F( OBBTest, OverlapsAxisAligned )
+{
+  OBB near{ Point3{ 1.5F, 0.0F, 0.0F }, Mat3::identity(), Vec3{ 1.0F, 1.0F, 1.0F } };
+  OBB far{ Point3{ 2.5F, 0.0F, 0.0F }, Mat3::identity(), Vec3{ 0.4F, 1.0F, 1.0F } };
+  EXPECT_TRUE( overlaps( unitBox, near ) );
+  EXPECT_FALSE( overlaps( unitBox, far ) );
+}
+
+TEST_F( OBBTest, OverlapsRotated )
+{
+  // A box rotated 45 degrees about z reaches sqrt( 2 ) along x
+  Mat3 rotation = makeRotationZ( PI / 4.0F );
+  OBB  reaching{ Point3{ 2.3F, 0.0F, 0.0F }, rotation, Vec3{ 1.0F, 1.0F, 1.0F } };
+  OBB  short_of{ Point3{ 2.5F, 0.0F, 0.0F }, rotation, Vec3{ 1.0F, 1.0F, 1.0F } };
+  EXPECT_TRUE( overlaps( unitBox, reaching ) );
+  EXPECT_FALSE( overlaps( unitBox, short_of ) );
+}
+
+TEST_F( OBBTest, BoundingOBBFollowsPrincipalAxes )
+{
+  // Points along a long thin rotated box
+  Vec3                direction = normalized( Vec3{ 1.0F, 1.0F, 0.0F } );
+  Vec3                side      = normalized( Vec3{ -1.0F, 1.0F, 0.0F } );
+  std::vector<Point3> points;
+  for ( int i = -10; i <= 10; ++i )
+  {
+    for ( int j = -1; j <= 1; ++j )
+    {
+      points.emplace_back( direction * static_cast<float>( i ) + side * ( static_cast<float>( j ) * 0.5F )
+                           + Vec3{ 0.0F, 0.0F, static_cast<float>( j ) * 0.1F } );
+    }
+  }
+
+  OBB box = makeBoundingOBB( points );
+  for ( const auto& point : points )
+  {
+    EXPECT_TRUE( contains( OBB{ box.center(), box.axes(), box.halfExtents() + Vec3{ 1e-4F, 1e-4F, 1e-4F } }, point ) );
+  }
+
+  const float largest = std::max( { box.halfExtents().x(), box.halfExtents().y(), box.halfExtents().z() } );
+  EXPECT_NEAR( largest, 10.0F, 1e-3F );
+}
+
+TEST_F( OBBTest, BatchedOverlapsMatchScalar )
+{
+  constexpr size_t count = 70;
+  std::vector<OBB> boxes;
+  for ( size_t i = 0; i != count; ++i )
+  {
+    const auto f = static_cast<float>( i );
+    boxes.emplace_back( Point3{ std::fmod( f * 0.7F, 6.0F ) - 3.0F, std::fmod( f * 1.3F, 4.0F ) - 2.0F, 0.0F },
+      makeRotation( f * 0.3F, normalized( Vec3{ 1.0F, f, 2.0F } ) ),
+      Vec3{ 0.5F, 0.25F, 0.75F } );
+  }
+
+  std::vector<std::vector<float>> streams( 15, std::vector<float>( count ) );
+  for ( size_t i = 0; i != count; ++i )
+  {
+    for ( size_t c = 0; c != 3; ++c )
+    {
+      streams[c][i]      = boxes[i].center()[c];
+      streams[3 + c][i]  = boxes[i].axis( 0 )[c];
+      streams[6 + c][i]  = boxes[i].axis( 1 )[c];
+      streams[9 + c][i]  = boxes[i].axis( 2 )[c];
+      streams[12 + c][i] = boxes[i].halfExtents()[c];
+    }
+  }
+  const auto soa = [&streams]( size_t first ) {
+    return SoAVec3{ streams[first], streams[first + 1], streams[first + 2] };
+  };
+
+  SoAOBB candidates{ soa( 0 ), { soa( 3 ), soa( 6 ), soa( 9 ) }, soa( 12 ) };
+  std::vector<uint64_t> mask( maskWordCount( count ) );
+  testOverlaps( unitBox, candidates, mask );
+
+  for ( size_t i = 0; i != count; ++i )
+  {
+    EXPECT_EQ( isMaskSet( mask, i ), overlaps( unitBox, boxes[i] ) );
+  }
+}
@@ -0,0 +1,196 @@
+#include "mirage_math/octree.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class LooseOctreeTest : public ::testing::Test
+{
+protected:
+  AABB              world{ Point3{ -10.0F, -10.0F, -10.0F }, Point3{ 10.0F, 10.0F, 10.0F } };
+  std::vector<AABB> boxes;
+
+  void SetUp() override
+  {
+    for ( int i = 0; i != 500; ++i )
+    {
+      const auto   f = static_cast<float>( i );
+      const Point3 point{ std::sin( f * 0.71F ) * 11.0F, std::cos( f * 1.37F ) * 9.0F, std::sin( f * 2.11F ) * 9.5F };
+      const float  size = 0.05F + 0.4F * static_cast<float>( i % 9 ) * static_cast<float>( i % 4 );
+      boxes.emplace_back( point, point + Vec3{ size, size * 0.5F, size * 0.25F } );
+    }
+  }
+
+  // Handles reported by query, and those of the live boxes matching predicate
+  template<typename Query, typename Predicate>
+  static void expectMatches( const LooseOctree& tree,
+    const std::vector<AABB>&                    live_boxes,
+    const std::vector<uint32_t>&                handles,
+    Query&&                                     query,
+    Predicate&&                                 predicate )
+  {
+    std::vector<uint32_t> found;
+    query( tree, [&found]( uint32_t handle ) { found.push_back( handle ); } );
+    std::sort( found.begin(), found.end() );
+    EXPECT_EQ( std::adjacent_find( found.begin(), found.end() ), found.end() );
+
+    std::vector<uint32_t> expected;
+    for ( size_t i = 0; i != handles.size(); ++i )
+    {
+      if ( predicate( live_boxes[i] ) )
+      {
+        expected.push_back( handles[i] );
+      }
+    }
+    std::sort( expected.begin(), expected.end() );
+    EXPECT_EQ( found, expected );
+  }
+};
+
+TEST_F( LooseOctreeTest, ClassifyAgainstFrustumPlanes )
+{
+  // Unit cube as six inward-facing planes
+  const std::array<Plane, 6> planes{ Plane{ 1.0F, 0.0F, 0.0F, 0.0F },
+    Plane{ -1.0F, 0.0F, 0.0F, 1.0F },
+    Plane{ 0.0F, 1.0F, 0.0F, 0.0F },
+    Plane{ 0.0F, -1.0F, 0.0F, 1.0F },
+    Plane{ 0.0F, 0.0F, 1.0F, 0.0F },
+    Plane{ 0.0F, 0.0F, -1.0F, 1.0F } };
+
+  EXPECT_EQ( classify( planes, AABB{ Point3{ 0.25F, 0.25F, 0.25F }, Point3{ 0.75F, 0.75F, 0.75F } } ),
+    Containment::INSIDE );
+  EXPECT_EQ( classify( planes, AABB{ Point3{ 0.5F, 0.5F, 0.5F }, Point3{ 1.5F, 0.75F, 0.75F } } ),
+    Containment::INTERSECTING );
+  EXPECT_EQ( classify( planes, AABB{ Point3{ 2.0F, 0.5F, 0.5F }, Point3{ 3.0F, 0.75F, 0.75F } } ),
+    Containment::OUTSIDE );
+}
+
+TEST_F( LooseOctreeTest, InsertedObjectsAreFound )
+{
+  LooseOctree           tree{ world };
+  std::vector<uint32_t> handles;
+  for ( const auto& box : boxes )
+  {
+    handles.push_back( tree.insert( box ) );
+  }
+  EXPECT_EQ( tree.size(), boxes.size() );
+  EXPECT_GT( tree.nodeCount(), 1U );
+
+  for ( size_t i = 0; i != boxes.size(); ++i )
+  {
+    EXPECT_FLOAT_EQ( tree.bounds( handles[i] ).min().x(), boxes[i].min().x() );
+    EXPECT_FLOAT_EQ( tree.bounds( handles[i] ).max().z(), boxes[i].max().z() );
+  }
+
+  for ( const auto& query_box : { AABB{ Point3{ -3.0F, -2.0F, -4.0F }, Point3{ 2.0F, 3.0F, 1.0F } },
+          AABB{ Point3{ 8.0F, 8.0F, 8.0F }, Point3{ 12.0F, 12.0F, 12.0F } },
+          AABB{ Point3{ -20.0F, -20.0F, -20.0F }, Point3{ 20.0F, 20.0F, 20.0F } } } )
+  {
+    expectMatches(
+      tree,
+      boxes,
+      handles,
+      [&query_box]( const LooseOctree& octree, auto&& callback ) { octree.queryOverlaps( query_box, callback ); },
+      [&query_box]( const AABB& box ) { return overlaps( box, query_box ); } );
+  }
+}
+
+TEST_F( LooseOctreeTest, FrustumQueryMatchesBruteForce )
+{
+  LooseOctree           tree{ world };
+  std::vector<uint32_t> handles;
+  for ( const auto& box : boxes )
+  {
+    handles.push_back( tree.insert( box ) );
+  }
+
+  // A pyramid looking down -z from the origin, closed by near and far planes
+  const std::array<Plane, 6> planes{ Plane{ 1.0F, 0.0F, -0.5F, 0.0F },
+    Plane{ -1.0F, 0.0F, -0.5F, 0.0F },
+    Plane{ 0.0F, 1.0F, -0.5F, 0.0F },
+    Plane{ 0.0F, -1.0F, -0.5F, 0.0F },
+    Plane{ 0.0F, 0.0F, -1.0F, -0.5F },
+    Plane{ 0.0F, 0.0F, 1.0F, 8.0F } };
+
+  expectMatches(
+    tree,
+    boxes,
+    handles,
+    [&planes]( const LooseOctree& octree, auto&& callback ) { octree.queryFrustum( planes, callback ); },
+    [&planes]( const AABB& box ) { return classify( planes, box ) != Containment::OUTSIDE; } );
+}
+
+TEST_F( LooseOctreeTest, UpdatesAndRemovalsAreTracked )
+{
+  LooseOctree           tree{ world };
+  std::vector<uint32_t> handles;
+  for ( const auto& box : boxes )
+  {
+    handles.push_back( tree.insert( box ) );
+  }
+
+  // Small moves mostly stay in their node, large ones and growth relocate the object
+  for ( size_t i = 0; i != boxes.size(); ++i )
+  {
+    const float shift = i % 3 == 0 ? 0.01F : static_cast<float>( i % 5 ) * 3.0F - 6.0F;
+    const float grow  = i % 7 == 0 ? 2.0F : 0.0F;
+    boxes[i]          = AABB{ boxes[i].min() + Vec3{ shift, -shift, shift * 0.5F },
+      boxes[i].max() + Vec3{ shift + grow, -shift + grow, shift * 0.5F + grow } };
+    tree.update( handles[i], boxes[i] );
+  }
+
+  // Remove every fourth object
+  std::vector<AABB>     live_boxes;
+  std::vector<uint32_t> live_handles;
+  std::vector<uint32_t> removed;
+  for ( size_t i = 0; i != boxes.size(); ++i )
+  {
+    if ( i % 4 == 0 )
+    {
+      tree.remove( handles[i] );
+      removed.push_back( handles[i] );
+    } else
+    {
+      live_boxes.push_back( boxes[i] );
+      live_handles.push_back( handles[i] );
+    }
+  }
+  EXPECT_EQ( tree.size(), live_boxes.size() );
+
+  const AABB query_box{ Point3{ -6.0F, -5.0F, -7.0F }, Point3{ 4.0F, 6.0F, 3.0F } };
+  expectMatches(
+    tree,
+    live_boxes,
+    live_handles,
+    [&query_box]( const LooseOctree& octree, auto&& callback ) { octree.queryOverlaps( query_box, callback ); },
+    [&query_box]( const AABB& box ) { return overlaps( box, query_box ); } );
+
+  // Freed handles are reused before new ones are issued
+  const uint32_t reused = tree.insert( Point3{ 1.0F, 2.0F, 3.0F } );
+  EXPECT_NE( std::find( removed.begin(), removed.end(), reused ), removed.end() );
+  EXPECT_FLOAT_EQ( tree.bounds( reused ).min().y(), 2.0F );
+}
+
+TEST_F( LooseOctreeTest, PointsOutsideTheWorldStayQueryable )
+{
+  LooseOctree    tree{ world, LooseOctreeOptions{ 4, 1.5F } };
+  const uint32_t inside  = tree.insert( Point3{ 1.0F, 1.0F, 1.0F } );
+  const uint32_t outside = tree.insert( Point3{ 50.0F, 0.0F, 0.0F } );
+
+  std::vector<uint32_t> found;
+  tree.queryOverlaps( AABB{ Point3{ 40.0F, -1.0F, -1.0F }, Point3{ 60.0F, 1.0F, 1.0F } },
+    [&found]( uint32_t handle ) { found.push_back( handle ); } );
+  ASSERT_EQ( found.size(), 1U );
+  EXPECT_EQ( found.front(), outside );
+
+  tree.update( inside, Point3{ 55.0F, 0.5F, 0.0F } );
+  tree.update( outside, Point3{ -5.0F, 0.0F, 0.0F } );
+  found.clear();
+  tree.queryOverlaps( AABB{ Point3{ 40.0F, -1.0F, -1.0F }, Point3{ 60.0F, 1.0F, 1.0F } },
+    [&found]( uint32_t handle ) { found.push_back( handle ); } );
+  ASSERT_EQ( found.size(), 1U );
+  EXPECT_EQ( found.front(), inside );
+}
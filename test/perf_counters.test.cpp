@@ -0,0 +1,81 @@
+#include "mirage_math/perf_counters.hpp"
+#include <gtest/gtest.h>
+
+using namespace Mirage::Math;
+
+class PerfCountersTest : public ::testing::Test
+{
+protected:
+  PerfRegistry registry;
+
+  // Enough work for the counters to see, kept from being optimized out
+  static float work( size_t count )
+  {
+    volatile float sum = 0.0F;
+    for ( size_t i = 0; i != count; ++i )
+    {
+      sum = sum + static_cast<float>( i ) * 0.5F;
+    }
+    return sum;
+  }
+};
+
+TEST_F( PerfCountersTest, RegistryAccumulatesRegions )
+{
+  registry.record( "kernel", PerfCounts{ 400, 800, 4, 8 }, 100 );
+  registry.record( "kernel", PerfCounts{ 600, 1200, 6, 12 }, 100 );
+  registry.record( "other", PerfCounts{ 10, 5, 0, 0 }, 0 );
+
+  const auto stats = registry.stats();
+  ASSERT_EQ( stats.size(), 2U );
+  const PerfStats& kernel = stats.at( "kernel" );
+  EXPECT_EQ( kernel.calls, 2U );
+  EXPECT_EQ( kernel.elements, 200U );
+  EXPECT_DOUBLE_EQ( kernel.counts.ipc(), 2.0 );
+  EXPECT_DOUBLE_EQ( kernel.perCall().cycles, 500.0 );
+  EXPECT_DOUBLE_EQ( kernel.perElement().instructions, 10.0 );
+  EXPECT_DOUBLE_EQ( kernel.perElement().cacheMisses, 0.05 );
+  EXPECT_DOUBLE_EQ( kernel.perElement().branchMisses, 0.1 );
+
+  // No elements means no rates rather than a division by zero
+  EXPECT_DOUBLE_EQ( stats.at( "other" ).perElement().cycles, 0.0 );
+
+  const std::string report = registry.report();
+  EXPECT_NE( report.find( "kernel" ), std::string::npos );
+  EXPECT_NE( report.find( "other" ), std::string::npos );
+
+  registry.reset();
+  EXPECT_TRUE( registry.stats().empty() );
+}
+
+TEST_F( PerfCountersTest, ScopesRecordWhenCountersAreAvailable )
+{
+  {
+    const PerfScope scope( "work", 100000, registry );
+    work( 100000 );
+  }
+
+  // Disabled builds, and machines without a PMU, record nothing
+  const auto stats = registry.stats();
+  if ( !threadPerfCounters().available() )
+  {
+    EXPECT_TRUE( stats.empty() );
+    GTEST_SKIP() << "hardware counters unavailable";
+  }
+  ASSERT_EQ( stats.size(), 1U );
+  const PerfStats& work_stats = stats.at( "work" );
+  EXPECT_EQ( work_stats.calls, 1U );
+  EXPECT_GT( work_stats.counts.cycles, 0U );
+  EXPECT_GT( work_stats.perElement().instructions, 1.0 );
+}
+
+TEST_F( PerfCountersTest, DisabledScopesDoNotEvaluateArguments )
+{
+  int evaluations = 0;
+  {
+    MIRAGE_MATH_PERF_SCOPE( "macro", ++evaluations );
+    work( 10 );
+  }
+  EXPECT_EQ( evaluations, PERF_COUNTERS_ENABLED ? 1 : 0 );
+  defaultPerfRegistry().reset();
+}
@@ -0,0 +1,224 @@
+#include "mirage_math/morton.hpp"
+#include "mirage_math/pipeline.hpp"
+#include "test_utils.hpp"
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace Mirage::Math;
+
+// Collects every item of a channel
+template<typename T>
+PipelineStage collect( Channel<T>& in, std::vector<T>& items )
+{
+  while ( auto item = co_await in.receive() )
+  {
+    items.push_back( std::move( *item ) );
+  }
+}
+
+// Sends count numbers, recording the fullest the channel got
+PipelineStage produce( Channel<int>& out, int count, size_t& max_queued )
+{
+  for ( int i = 0; i != count; ++i )
+  {
+    max_queued = std::max( max_queued, out.size() );
+    if ( !co_await out.send( i ) )
+    {
+      break;
+    }
+  }
+  out.close();
+}
+
+// Sends copies of items, as a source stage
+template<typename T>
+PipelineStage sendAll( Channel<T>& out, const std::vector<T>& items )
+{
+  for ( const auto& item : items )
+  {
+    if ( !co_await out.send( item ) )
+    {
+      break;
+    }
+  }
+  out.close();
+}
+
+Generator<int> squares( int count )
+{
+  for ( int i = 0; i != count; ++i )
+  {
+    co_yield i * i;
+  }
+}
+
+class PipelineTest : public ::testing::Test
+{
+protected:
+  std::vector<Point3> points;
+
+  void SetUp() override
+  {
+    for ( int i = 0; i != 5003; ++i )
+    {
+      const auto f = static_cast<float>( i );
+      points.emplace_back( std::sin( f ) * 10.0F, std::cos( f * 0.7F ) * 10.0F, f * 0.001F );
+    }
+  }
+};
+
+TEST_F( PipelineTest, ChainsPointStages )
+{
+  Transform4 shift{ Transform4::identity() };
+  shift.setTranslation( Point3{ 5.0F, 0.0F, 0.0F } );
+  const AABB bounds{ Point3{ -5.0F, -10.0F, 0.0F }, Point3{ 15.0F, 10.0F, 5.0F } };
+
+  // One worker runs every stage by interleaving them, two run them side by side
+  for ( size_t worker_count : { 1U, 2U } )
+  {
+    JobSystem           jobs( worker_count );
+    Pipeline            pipeline( jobs );
+    Channel<PointChunk> read( pipeline, 2 );
+    Channel<PointChunk> moved( pipeline, 2 );
+    Channel<PointChunk> kept( pipeline, 1 );
+    Channel<PointChunk> output( pipeline, 1 );
+
+    PointSpanReader                    reader( points );
+    std::vector<PointChunk>            chunks;
+    std::vector<std::vector<uint32_t>> code_chunks;
+    const MortonQuantizer              quantizer( bounds, MORTON30_AXIS_CELLS );
+
+    pipeline.spawn( readPointChunks( reader, read, 97 ) );
+    pipeline.spawn( transformPointChunks( read, moved, shift ) );
+    // The planes are a temporary that is gone before the stage first runs
+    pipeline.spawn( cullPointChunks( moved, kept, { Plane{ 0.0F, 1.0F, 0.0F, 0.0F } } ) );
+    pipeline.spawn( mapChunks( kept, output, []( PointChunk chunk ) { return chunk; } ) );
+    pipeline.spawn( collect( output, chunks ) );
+    EXPECT_TRUE( pipeline.wait() );
+
+    // Run again to quantize what was kept, handing chunks over without buffering
+    Channel<PointChunk>            input( pipeline, 1 );
+    Channel<std::vector<uint32_t>> codes( pipeline, 0 );
+    pipeline.spawn( mapChunks( input, codes, [&quantizer]( PointChunk chunk ) {
+      std::vector<uint32_t> result;
+      for ( const auto& point : chunk )
+      {
+        result.push_back( encodeMorton30( quantizer( point ) ) );
+      }
+      return result;
+    } ) );
+    pipeline.spawn( collect( codes, code_chunks ) );
+    pipeline.spawn( sendAll( input, chunks ) );
+    EXPECT_TRUE( pipeline.wait() );
+
+    std::vector<Point3> expected;
+    for ( const auto& point : points )
+    {
+      const Point3 moved_point = shift * point;
+      if ( moved_point.y() >= 0.0F )
+      {
+        expected.push_back( moved_point );
+      }
+    }
+
+    // Order is kept through every stage
+    size_t index = 0;
+    ASSERT_EQ( chunks.size(), code_chunks.size() );
+    for ( size_t chunk = 0; chunk != chunks.size(); ++chunk )
+    {
+      ASSERT_EQ( chunks[chunk].size(), code_chunks[chunk].size() );
+      for ( size_t i = 0; i != chunks[chunk].size(); ++i, ++index )
+      {
+        ASSERT_LT( index, expected.size() );
+        ASSERT_TRUE( areVectorsEqual( chunks[chunk][i], expected[index], 1e-5F ) );
+        EXPECT_EQ( code_chunks[chunk][i], encodeMorton30( quantizer( expected[index] ) ) );
+      }
+    }
+    EXPECT_EQ( index, expected.size() );
+  }
+}
+
+TEST_F( PipelineTest, ChannelsApplyBackpressure )
+{
+  JobSystem        jobs( 2 );
+  Pipeline         pipeline( jobs );
+  Channel<int>     numbers( pipeline, 3 );
+  std::vector<int> received;
+  size_t           max_queued = 0;
+
+  pipeline.spawn( produce( numbers, 1000, max_queued ) );
+  pipeline.spawn( collect( numbers, received ) );
+  EXPECT_TRUE( pipeline.wait() );
+
+  EXPECT_LE( max_queued, numbers.capacity() );
+  ASSERT_EQ( received.size(), 1000U );
+  for ( int i = 0; i != 1000; ++i )
+  {
+    ASSERT_EQ( received[static_cast<size_t>( i )], i );
+  }
+}
+
+TEST_F( PipelineTest, FailuresCancelThePipeline )
+{
+  JobSystem jobs( 2 );
+
+  // A sink that fails stops the reader through the cancelled channels
+  {
+    Pipeline            pipeline( jobs );
+    Channel<PointChunk> read( pipeline, 1 );
+    PointSpanReader     reader( points );
+    struct FailingSink
+    {
+      bool write( std::span<const Point3> ) { return false; }
+    } sink;
+    pipeline.spawn( readPointChunks( reader, read, 10 ) );
+    pipeline.spawn( writePointChunks( read, sink ) );
+    EXPECT_FALSE( pipeline.wait() );
+  }
+
+  // An exception in a stage is rethrown by wait()
+  {
+    Pipeline         pipeline( jobs );
+    Channel<int>     numbers( pipeline, 1 );
+    Channel<int>     doubled( pipeline, 1 );
+    std::vector<int> received;
+    size_t           max_queued = 0;
+    pipeline.spawn( produce( numbers, 100, max_queued ) );
+    pipeline.spawn( mapChunks( numbers, doubled, []( int value ) {
+      if ( value == 50 )
+      {
+        throw std::runtime_error( "stage failed" );
+      }
+      return value * 2;
+    } ) );
+    pipeline.spawn( collect( doubled, received ) );
+    EXPECT_THROW( pipeline.wait(), std::runtime_error );
+    EXPECT_EQ( received.size(), 50U );
+  }
+}
+
+TEST_F( PipelineTest, GeneratorsYieldLazily )
+{
+  std::vector<int> values;
+  for ( int value : squares( 5 ) )
+  {
+    values.push_back( value );
+  }
+  EXPECT_EQ( values, ( std::vector<int>{ 0, 1, 4, 9, 16 } ) );
+
+  auto thrower = []() -> Generator<int> {
+    co_yield 1;
+    throw std::runtime_error( "generator failed" );
+  };
+  EXPECT_THROW(
+    {
+      for ( int value : thrower() )
+      {
+        EXPECT_EQ( value, 1 );
+      }
+    },
+    std::runtime_error );
+}
@@ -1,7 +1,9 @@
 #include "mirage_math/plane.hpp"
 #include "mirage_math/point.hpp"
+#include "test_utils.hpp"
 #include <gtest/gtest-death-test.h>
 #include <gtest/gtest.h>
+#include <vector>
 
 using namespace Mirage::Math;
 
@@ -147,3 +149,111 @@ TEST_F( PlaneTest, TwoPlanesIntersection )
   EXPECT_FLOAT_EQ( opt_line->vector().y(), -1.0F );
   EXPECT_FLOAT_EQ( opt_line->vector().z(), 3.0F );
 }
+
+TEST_F( PlaneTest, BatchedLineIntersectionsMatchScalar )
+{
+  std::vector<Plane> planes{
+    Plane{ 0.0F, 1.0F, 0.0F, -5.0F },
+    Plane{ 0.0F, 1.0F, 0.0F, -5.0F },
+    Plane{ 1.0F, 1.0F, 1.0F,  2.0F },
+  };
+  std::vector<Line> lines{
+    Line{ Point3{ 1.0F, 0.0F, 1.0F }, Vec3{ 0.0F, 1.0F, 0.0F } },
+    Line{ Point3{ 1.0F, 6.0F, 1.0F }, Vec3{ 1.0F, 0.0F, 1.0F } },
+    Line{ Point3{ 3.0F, -1.0F, 2.0F }, Vec3{ 1.0F, 2.0F, -0.5F } },
+  };
+
+  std::vector<std::vector<float>> plane_streams( 4 );
+  std::vector<std::vector<float>> line_streams( 6 );
+  for ( size_t i = 0; i != planes.size(); ++i )
+  {
+    for ( size_t c = 0; c != 4; ++c )
+    {
+      plane_streams[c].push_back( planes[i][c] );
+    }
+    for ( size_t c = 0; c != 3; ++c )
+    {
+      line_streams[c].push_back( lines[i].point()[c] );
+      line_streams[3 + c].push_back( lines[i].vector()[c] );
+    }
+  }
+
+  SoAPlane soa_planes{ plane_streams[0], plane_streams[1], plane_streams[2], plane_streams[3] };
+  SoALine  soa_lines{
+    { line_streams[0], line_streams[1], line_streams[2] },
+    { line_streams[3], line_streams[4], line_streams[5] }
+  };
+
+  std::vector<float>    x( planes.size() );
+  std::vector<float>    y( planes.size() );
+  std::vector<float>    z( planes.size() );
+  std::vector<uint64_t> valid( maskWordCount( planes.size() ) );
+
+  EXPECT_EQ( getIntersections( soa_planes, soa_lines, { x, y, z }, valid ), 2U );
+  for ( size_t i = 0; i != planes.size(); ++i )
+  {
+    auto expected = getIntersection( planes[i], lines[i] );
+    ASSERT_EQ( isMaskSet( valid, i ), expected.has_value() );
+    if ( expected )
+    {
+      EXPECT_TRUE( areVectorsEqual( Vec3{ x[i], y[i], z[i] }, *expected, 1e-5F ) );
+    }
+  }
+
+  EXPECT_EQ( getIntersections( planes[0], soa_lines, { x, y, z }, valid ), 2U );
+  EXPECT_TRUE( isMaskSet( valid, 0 ) );
+  EXPECT_FALSE( isMaskSet( valid, 1 ) );
+  EXPECT_FLOAT_EQ( y[2], 5.0F );
+}
+
+TEST_F( PlaneTest, BatchedPlaneIntersectionsMatchScalar )
+{
+  std::vector<float> ax{ 1.0F, 2.0F, 2.0F };
+  std::vector<float> ay{ 2.0F, 2.0F, -1.0F };
+  std::vector<float> az{ 3.0F, 2.0F, 1.0F };
+  std::vector<float> aw{ 4.0F, 4.0F, -1.0F };
+  std::vector<float> bx{ 1.0F, 1.0F, 1.0F };
+  std::vector<float> by{ 1.0F, 1.0F, 1.0F };
+  std::vector<float> bz{ 1.0F, 1.0F, 1.0F };
+  std::vector<float> bw{ 1.0F, 1.0F, -6.0F };
+  std::vector<float> cx{ 2.0F, 2.0F, 2.0F };
+  std::vector<float> cy{ 3.0F, 3.0F, -1.0F };
+  std::vector<float> cz{ 2.0F, 2.0F, 1.0F };
+  std::vector<float> cw{ 1.0F, 1.0F, 5.0F };
+
+  SoAPlane a{ ax, ay, az, aw };
+  SoAPlane b{ bx, by, bz, bw };
+  SoAPlane c{ cx, cy, cz, cw };
+
+  std::vector<float>    px( 3 );
+  std::vector<float>    py( 3 );
+  std::vector<float>    pz( 3 );
+  std::vector<float>    vx( 3 );
+  std::vector<float>    vy( 3 );
+  std::vector<float>    vz( 3 );
+  std::vector<uint64_t> valid( 1 );
+
+  getIntersections( a, b, c, { px, py, pz }, valid );
+  for ( size_t i = 0; i != 3; ++i )
+  {
+    auto expected = getIntersection( a[i], b[i], c[i] );
+    ASSERT_EQ( isMaskSet( valid, i ), expected.has_value() );
+    if ( expected )
+    {
+      EXPECT_TRUE( areVectorsEqual( Vec3{ px[i], py[i], pz[i] }, *expected, 1e-5F ) );
+    }
+  }
+
+  getIntersections( a, b, MutableSoAVec3{ px, py, pz }, MutableSoAVec3{ vx, vy, vz }, valid );
+  for ( size_t i = 0; i != 3; ++i )
+  {
+    auto expected = getIntersection( a[i], b[i] );
+    ASSERT_EQ( isMaskSet( valid, i ), expected.has_value() );
+    if ( expected )
+    {
+      EXPECT_TRUE( areVectorsEqual( Vec3{ px[i], py[i], pz[i] }, expected->point(), 1e-5F ) );
+      EXPECT_TRUE( areVectorsEqual( Vec3{ vx[i], vy[i], vz[i] }, expected->vector(), 1e-5F ) );
+    }
+  }
+  EXPECT_FALSE( isMaskSet( valid, 1 ) );
+}
@@ -0,0 +1,165 @@
+#include "mirage_math/binary_file.hpp"
+#include "mirage_math/point_stream.hpp"
+#include "test_utils.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace Mirage::Math;
+
+// Collects everything written, optionally failing after a number of chunks
+struct VectorPointSink
+{
+  std::vector<Point3> points;
+  size_t              chunks{};
+  size_t              failAfter{ SIZE_MAX };
+
+  bool write( std::span<const Point3> chunk )
+  {
+    if ( chunks == failAfter )
+    {
+      return false;
+    }
+    ++chunks;
+    points.insert( points.end(), chunk.begin(), chunk.end() );
+    return true;
+  }
+};
+
+class PointStreamTest : public ::testing::Test
+{
+protected:
+  std::filesystem::path input_path;
+  std::filesystem::path output_path;
+  std::vector<Point3>   points;
+
+  // Small chunks so that every test goes around the buffer ring many times
+  PointStreamOptions options{ .chunkSize = 97, .chunkCount = 3 };
+
+  void SetUp() override
+  {
+    const auto prefix = std::filesystem::temp_directory_path()
+                        / ( "mirage_point_stream_" + std::to_string( reinterpret_cast<uintptr_t>( this ) ) );
+    input_path        = prefix.string() + "_in.bin";
+    output_path       = prefix.string() + "_out.bin";
+
+    for ( int i = 0; i != 10007; ++i )
+    {
+      const auto f = static_cast<float>( i );
+      points.emplace_back( std::sin( f ) * 10.0F, std::cos( f * 0.7F ) * 10.0F, f * 0.001F );
+    }
+    std::ofstream file( input_path, std::ios::binary );
+    file.write( reinterpret_cast<const char*>( points.data() ),
+      static_cast<std::streamsize>( points.size() * sizeof( Point3 ) ) );
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove( input_path );
+    std::filesystem::remove( output_path );
+  }
+
+  static std::vector<Point3> readRaw( const std::filesystem::path& path )
+  {
+    std::vector<Point3> result( std::filesystem::file_size( path ) / sizeof( Point3 ) );
+    std::ifstream       file( path, std::ios::binary );
+    file.read(
+      reinterpret_cast<char*>( result.data() ), static_cast<std::streamsize>( result.size() * sizeof( Point3 ) ) );
+    return result;
+  }
+};
+
+TEST_F( PointStreamTest, TransformsAndCullsRawFiles )
+{
+  Transform4 shift{ Transform4::identity() };
+  shift.setTranslation( Point3{ 5.0F, 0.0F, 0.0F } );
+  const Transform4                rotation{ 0.0F, -1.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F };
+  const std::array<Transform4, 2> chain{ shift, rotation };
+
+  // Keep y >= 0 and z <= 5 after the transform
+  const std::array<Plane, 2> planes{ Plane{ 0.0F, 1.0F, 0.0F, 0.0F }, Plane{ 0.0F, 0.0F, -1.0F, 5.0F } };
+
+  RawPointReader reader( input_path );
+  RawPointWriter writer( output_path );
+  ASSERT_TRUE( reader.isOpen() );
+  const auto stats = streamPoints( reader, writer, std::span{ chain }, planes, options );
+  ASSERT_TRUE( writer.close() );
+  ASSERT_TRUE( stats.has_value() );
+
+  std::vector<Point3> expected;
+  for ( const auto& point : points )
+  {
+    const Point3 moved = rotation * ( shift * point );
+    if ( moved.y() >= 0.0F && moved.z() <= 5.0F )
+    {
+      expected.push_back( moved );
+    }
+  }
+  EXPECT_EQ( stats->read, points.size() );
+  EXPECT_EQ( stats->written, expected.size() );
+  EXPECT_LT( expected.size(), points.size() );
+
+  const auto output = readRaw( output_path );
+  ASSERT_EQ( output.size(), expected.size() );
+  for ( size_t i = 0; i != output.size(); ++i )
+  {
+    ASSERT_TRUE( areVectorsEqual( output[i], expected[i], 1e-5F ) );
+  }
+}
+
+TEST_F( PointStreamTest, StreamsMappedSections )
+{
+  BinaryFileWriter binary;
+  ASSERT_TRUE( binary.add<Point3>( "cloud", points ) );
+  ASSERT_TRUE( binary.write( output_path ) );
+  const auto file = MappedBinaryFile::open( output_path );
+  ASSERT_TRUE( file.has_value() );
+
+  PointSpanReader reader( *file->get<Point3>( "cloud" ) );
+  VectorPointSink sink;
+  const auto      stats = streamPoints( reader, sink, Transform4{ Transform4::identity() }, {}, options );
+  ASSERT_TRUE( stats.has_value() );
+  EXPECT_EQ( stats->written, points.size() );
+  EXPECT_EQ( sink.chunks, ( points.size() + options.chunkSize - 1 ) / options.chunkSize );
+  ASSERT_EQ( sink.points.size(), points.size() );
+  for ( size_t i = 0; i != points.size(); ++i )
+  {
+    ASSERT_TRUE( areVectorsEqual( sink.points[i], points[i], 0.0F ) );
+  }
+}
+
+TEST_F( PointStreamTest, FailuresStopTheStream )
+{
+  const Transform4 identity{ Transform4::identity() };
+
+  // The sink gives up after a few chunks
+  {
+    RawPointReader  reader( input_path );
+    VectorPointSink sink;
+    sink.failAfter = 5;
+    EXPECT_FALSE( streamPoints( reader, sink, identity, {}, options ).has_value() );
+    EXPECT_EQ( sink.points.size(), 5 * options.chunkSize );
+  }
+
+  // A file ending in a partial point
+  {
+    std::ofstream( input_path, std::ios::binary | std::ios::app ).write( "abcd", 4 );
+    RawPointReader  reader( input_path );
+    VectorPointSink sink;
+    EXPECT_FALSE( streamPoints( reader, sink, identity, {}, options ).has_value() );
+  }
+
+  // A missing file
+  {
+    RawPointReader  reader( input_path.string() + ".missing" );
+    VectorPointSink sink;
+    EXPECT_FALSE( reader.isOpen() );
+    EXPECT_FALSE( streamPoints( reader, sink, identity, {}, options ).has_value() );
+    EXPECT_TRUE( sink.points.empty() );
+  }
+}
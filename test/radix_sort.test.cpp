@@ -0,0 +1,65 @@
+#include "mirage_math/radix_sort.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class RadixSortTest : public ::testing::Test
+{
+protected:
+  static void expectSortedStable( std::vector<uint32_t> keys, const RadixSortOptions& options )
+  {
+    std::vector<uint32_t> values( keys.size() );
+    std::iota( values.begin(), values.end(), 0U );
+    std::vector<uint32_t> expected = values;
+    std::stable_sort(
+      expected.begin(), expected.end(), [&keys]( uint32_t a, uint32_t b ) { return keys[a] < keys[b]; } );
+
+    const std::vector<uint32_t> original = keys;
+    radixSort( keys, values, options );
+    EXPECT_EQ( values, expected );
+    for ( size_t i = 0; i != keys.size(); ++i )
+    {
+      EXPECT_EQ( keys[i], original[values[i]] );
+    }
+  }
+};
+
+TEST_F( RadixSortTest, SortableKeysPreserveFloatOrder )
+{
+  std::vector<float> values{ -1e30F, -2.5F, -1.0F, -0.0F, 0.0F, 1e-30F, 1.0F, 2.5F, 1e30F };
+  for ( size_t i = 0; i + 1 != values.size(); ++i )
+  {
+    EXPECT_LE( toSortableKey( values[i] ), toSortableKey( values[i + 1] ) );
+    EXPECT_EQ( fromSortableKey( toSortableKey( values[i] ) ), values[i] );
+  }
+  EXPECT_LT( toSortableKey( -1.0F ), toSortableKey( -0.5F ) );
+}
+
+TEST_F( RadixSortTest, SortsSerialAndParallel )
+{
+  std::mt19937          rng( 7 );
+  std::vector<uint32_t> keys( 5000 );
+  for ( auto& key : keys )
+  {
+    key = rng();
+  }
+
+  expectSortedStable( keys, RadixSortOptions{} );
+  expectSortedStable( keys, RadixSortOptions{ .parallelThreshold = 1, .grainSize = 1700 } );
+}
+
+TEST_F( RadixSortTest, StableWithSkippedPasses )
+{
+  // Only the low byte varies, so three of four passes are skipped and the result ends up in scratch
+  std::vector<uint32_t> keys( 1000 );
+  for ( size_t i = 0; i != keys.size(); ++i )
+  {
+    keys[i] = 0xABCD0000U | static_cast<uint32_t>( ( i * 37 ) % 11 );
+  }
+  expectSortedStable( keys, RadixSortOptions{ .parallelThreshold = 1, .grainSize = 250 } );
+  expectSortedStable( {}, RadixSortOptions{} );
+}
@@ -0,0 +1,264 @@
+#include "mirage_math/ray.hpp"
+#include "test_utils.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class RayTest : public ::testing::Test
+{
+protected:
+  Point3 a{ 0.0F, 0.0F, 0.0F };
+  Point3 b{ 1.0F, 0.0F, 0.0F };
+  Point3 c{ 0.0F, 1.0F, 0.0F };
+
+  std::vector<Point3>   positions;
+  std::vector<uint32_t> indices;
+
+  void SetUp() override
+  {
+    // A 16x16 grid of quads in the z = 0 plane, each split into two triangles
+    constexpr uint32_t size = 17;
+    for ( uint32_t y = 0; y != size; ++y )
+    {
+      for ( uint32_t x = 0; x != size; ++x )
+      {
+        const float height = std::sin( static_cast<float>( x ) * 0.5F ) * std::cos( static_cast<float>( y ) * 0.3F );
+        positions.emplace_back( static_cast<float>( x ), static_cast<float>( y ), height );
+      }
+    }
+    for ( uint32_t y = 0; y != size - 1; ++y )
+    {
+      for ( uint32_t x = 0; x != size - 1; ++x )
+      {
+        const uint32_t i = y * size + x;
+        indices.insert( indices.end(), { i, i + 1, i + size, i + 1, i + size + 1, i + size } );
+      }
+    }
+  }
+
+  std::optional<MeshHit> bruteForce( const Ray& ray ) const
+  {
+    std::optional<MeshHit> closest;
+    Ray                    query = ray;
+    for ( uint32_t primitive = 0; primitive != indices.size() / 3; ++primitive )
+    {
+      auto hit = getIntersectionWatertight( query,
+        positions[indices[primitive * 3]],
+        positions[indices[primitive * 3 + 1]],
+        positions[indices[primitive * 3 + 2]] );
+      if ( hit )
+      {
+        closest = MeshHit{ *hit, primitive };
+        query.setTMax( hit->t );
+      }
+    }
+    return closest;
+  }
+
+  // Every lane runs through the diagonal shared by the triangles abc and bdc, including its end
+  // points: straight down or up, which hits the edge exactly, and tilted so that each axis is the
+  // dominant one of some lanes. Every lane must hit one of the triangles, with the same result as
+  // single rays under the packet's closer-only update.
+  template<size_t Width>
+  void expectPacketMatchesScalarOnSharedEdge() const
+  {
+    const Point3              d{ 1.0F, 1.0F, 0.0F };
+    const std::array<Vec3, 6> directions{ Vec3{ 0.0F, 0.0F, -1.0F },
+      Vec3{ 0.0F, 0.0F, 1.0F },
+      Vec3{ 0.3F, -0.2F, -1.0F },
+      Vec3{ -1.0F, 0.1F, -0.5F },
+      Vec3{ 0.2F, 1.0F, 0.4F },
+      Vec3{ -0.7F, -0.7F, -0.1F } };
+
+    std::vector<Ray> rays;
+    for ( size_t lane = 0; lane != Width; ++lane )
+    {
+      const float  s = static_cast<float>( lane ) / static_cast<float>( Width - 1 );
+      const Point3 on_edge{ 1.0F - s, s, 0.0F };
+      const Vec3&  direction = directions[lane % directions.size()];
+      rays.emplace_back( on_edge - direction, direction );
+    }
+
+    RayPacket<Width> packet = RayPacket<Width>::fromRays( rays );
+    PacketHit<Width> hit;
+    uint32_t         mask = intersect( packet, hit, a, b, c, 0 );
+    mask |= intersect( packet, hit, b, d, c, 1 );
+    EXPECT_EQ( mask, RayPacket<Width>::ALL_LANES ) << Width;
+
+    for ( size_t lane = 0; lane != Width; ++lane )
+    {
+      Ray                    ray = rays[lane];
+      std::optional<MeshHit> expected;
+      for ( const auto& [triangle, primitive] :
+        { std::pair{ std::array{ a, b, c }, 0U }, std::pair{ std::array{ b, d, c }, 1U } } )
+      {
+        const auto single = getIntersectionWatertight( ray, triangle[0], triangle[1], triangle[2] );
+        if ( single && ( !expected || single->t < expected->triangle.t ) )
+        {
+          expected = MeshHit{ *single, primitive };
+          ray.setTMax( single->t );
+        }
+      }
+      ASSERT_TRUE( expected.has_value() ) << Width << " " << lane;
+      EXPECT_EQ( hit.primitive[lane], expected->primitive ) << Width << " " << lane;
+      EXPECT_EQ( hit.t[lane], expected->triangle.t ) << Width << " " << lane;
+      EXPECT_EQ( hit.u[lane], expected->triangle.u ) << Width << " " << lane;
+      EXPECT_EQ( hit.v[lane], expected->triangle.v ) << Width << " " << lane;
+    }
+  }
+};
+
+TEST_F( RayTest, SlabTest )
+{
+  AABB box{
+    Point3{ 1.0F, -1.0F, -1.0F },
+    Point3{ 3.0F,  1.0F,  1.0F }
+  };
+
+  auto entry = getIntersection( Ray{ Point3{ 0.0F, 0.0F, 0.0F }, Vec3{ 1.0F, 0.0F, 0.0F } }, box );
+  ASSERT_TRUE( entry.has_value() );
+  EXPECT_FLOAT_EQ( *entry, 1.0F );
+
+  EXPECT_FALSE( getIntersection( Ray{ Point3{ 0.0F, 2.0F, 0.0F }, Vec3{ 1.0F, 0.0F, 0.0F } }, box ).has_value() );
+  EXPECT_FALSE( getIntersection( Ray{ Point3{ 0.0F, 0.0F, 0.0F }, Vec3{ 1.0F, 0.0F, 0.0F }, 0.0F, 0.5F }, box ) );
+}
+
+TEST_F( RayTest, TriangleIntersection )
+{
+  Ray hit_ray{
+    Point3{ 0.25F, 0.25F, 1.0F },
+    Vec3{ 0.0F, 0.0F, -1.0F }
+  };
+  Ray miss_ray{
+    Point3{ 0.75F, 0.75F, 1.0F },
+    Vec3{ 0.0F, 0.0F, -1.0F }
+  };
+
+  for ( auto hit : { getIntersection( hit_ray, a, b, c ), getIntersectionWatertight( hit_ray, a, b, c ) } )
+  {
+    ASSERT_TRUE( hit.has_value() );
+    EXPECT_FLOAT_EQ( hit->t, 1.0F );
+    EXPECT_FLOAT_EQ( hit->u, 0.25F );
+    EXPECT_FLOAT_EQ( hit->v, 0.25F );
+  }
+
+  EXPECT_FALSE( getIntersection( miss_ray, a, b, c ).has_value() );
+  EXPECT_FALSE( getIntersectionWatertight( miss_ray, a, b, c ).has_value() );
+}
+
+TEST_F( RayTest, WatertightSharedEdge )
+{
+  // A ray exactly through the shared diagonal must hit at least one of the two triangles
+  Point3 d{ 1.0F, 1.0F, 0.0F };
+  Ray    ray{
+    Point3{ 0.5F, 0.5F, 1.0F },
+    Vec3{ 0.0F, 0.0F, -1.0F }
+  };
+  EXPECT_TRUE( getIntersectionWatertight( ray, a, b, c ) || getIntersectionWatertight( ray, b, d, c ) );
+}
+
+TEST_F( RayTest, PacketMatchesScalar )
+{
+  std::vector<Ray> rays;
+  for ( int i = 0; i != 8; ++i )
+  {
+    const float offset = static_cast<float>( i ) * 0.15F - 0.2F;
+    rays.emplace_back( Point3{ offset, 0.3F, 1.0F }, Vec3{ 0.1F, -0.05F, -1.0F } );
+  }
+
+  RayPacket8     packet = RayPacket8::fromRays( rays );
+  PacketHit<8>   hit;
+  const uint32_t mask = intersect( packet, hit, a, b, c, 7 );
+
+  for ( size_t lane = 0; lane != 8; ++lane )
+  {
+    auto scalar = getIntersectionWatertight( rays[lane], a, b, c );
+    EXPECT_EQ( ( mask >> lane ) & 1U, scalar ? 1U : 0U );
+    if ( scalar )
+    {
+      EXPECT_EQ( packet.tMax[lane], scalar->t );
+      EXPECT_EQ( hit.t[lane], scalar->t );
+      EXPECT_EQ( hit.u[lane], scalar->u );
+      EXPECT_EQ( hit.v[lane], scalar->v );
+      EXPECT_EQ( hit.primitive[lane], 7U );
+    } else
+    {
+      EXPECT_EQ( hit.primitive[lane], INVALID_PRIMITIVE );
+    }
+  }
+
+  std::array<float, 8> t_near{};
+  AABB                 box{
+    Point3{ 0.0F, 0.0F, -0.1F },
+    Point3{ 0.5F, 1.0F,  0.1F }
+  };
+  RayPacket8 fresh    = RayPacket8::fromRays( rays );
+  uint32_t   box_mask = intersect( fresh, box, t_near );
+  for ( size_t lane = 0; lane != 8; ++lane )
+  {
+    EXPECT_EQ( ( box_mask >> lane ) & 1U, getIntersection( rays[lane], box ) ? 1U : 0U );
+  }
+}
+
+TEST_F( RayTest, PacketWatertightSharedEdge )
+{
+  expectPacketMatchesScalarOnSharedEdge<4>();
+  expectPacketMatchesScalarOnSharedEdge<8>();
+  expectPacketMatchesScalarOnSharedEdge<16>();
+}
+
+TEST_F( RayTest, PartialPacketLanesNeverHit )
+{
+  std::vector<Ray> rays{
+    Ray{ Point3{ 0.25F, 0.25F, 1.0F }, Vec3{ 0.0F, 0.0F, -1.0F } }
+  };
+  RayPacket4   packet = RayPacket4::fromRays( rays );
+  PacketHit<4> hit;
+  EXPECT_EQ( intersect( packet, hit, a, b, c, 0 ), 1U );
+}
+
+TEST_F( RayTest, BVHTraversalMatchesBruteForce )
+{
+  BVH bvh = BVH::build( makeTriangleBounds( positions, indices ) );
+
+  std::mt19937                          rng( 7 );
+  std::uniform_real_distribution<float> coordinate( -2.0F, 18.0F );
+  std::uniform_real_distribution<float> jitter( -0.3F, 0.3F );
+
+  std::vector<Ray> rays;
+  for ( int i = 0; i != 64; ++i )
+  {
+    rays.emplace_back(
+      Point3{ coordinate( rng ), coordinate( rng ), 3.0F }, Vec3{ jitter( rng ), jitter( rng ), -1.0F } );
+  }
+
+  for ( const auto& ray : rays )
+  {
+    auto expected = bruteForce( ray );
+    auto actual   = intersect( bvh, positions, indices, ray );
+    ASSERT_EQ( expected.has_value(), actual.has_value() );
+    if ( expected )
+    {
+      EXPECT_NEAR( actual->triangle.t, expected->triangle.t, 1e-5F );
+    }
+  }
+
+  for ( size_t first = 0; first != rays.size(); first += 16 )
+  {
+    RayPacket16 packet = RayPacket16::fromRays( std::span{ rays }.subspan( first, 16 ) );
+    auto        hit    = intersect( bvh, positions, indices, packet );
+    for ( size_t lane = 0; lane != 16; ++lane )
+    {
+      auto expected = intersect( bvh, positions, indices, rays[first + lane] );
+      ASSERT_EQ( expected.has_value(), hit.primitive[lane] != INVALID_PRIMITIVE );
+      if ( expected )
+      {
+        EXPECT_EQ( hit.primitive[lane], expected->primitive );
+        EXPECT_EQ( hit.t[lane], expected->triangle.t );
+        EXPECT_EQ( packet.tMax[lane], expected->triangle.t );
+      }
+    }
+  }
+}
@@ -0,0 +1,122 @@
+#include "mirage_math/segment.hpp"
+#include "test_utils.hpp"
+#include <array>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class SegmentTest : public ::testing::Test
+{
+protected:
+  // Dense sampling of both segments, the reference for the closed form
+  static float bruteForceDistance( const Segment& a, const Segment& b )
+  {
+    constexpr int steps = 400;
+    float         best  = std::numeric_limits<float>::max();
+    for ( int i = 0; i <= steps; ++i )
+    {
+      for ( int j = 0; j <= steps; ++j )
+      {
+        const float s = static_cast<float>( i ) / steps;
+        const float t = static_cast<float>( j ) / steps;
+        best          = std::min( best, magnitude( a.at( s ) - b.at( t ) ) );
+      }
+    }
+    return best;
+  }
+};
+
+TEST_F( SegmentTest, ClosestPointToPoint )
+{
+  Segment segment{ Point3{ 0.0F, 0.0F, 0.0F }, Point3{ 4.0F, 0.0F, 0.0F } };
+
+  EXPECT_TRUE( areVectorsEqual( closestPoint( segment, Point3{ 1.0F, 2.0F, 0.0F } ), Point3{ 1.0F, 0.0F, 0.0F } ) );
+  EXPECT_TRUE( areVectorsEqual( closestPoint( segment, Point3{ -3.0F, 1.0F, 0.0F } ), segment.start() ) );
+  EXPECT_FLOAT_EQ( distance( Point3{ 7.0F, 4.0F, 0.0F }, segment ), 5.0F );
+}
+
+TEST_F( SegmentTest, ClosestParametersClampToEndpoints )
+{
+  Segment a{ Point3{ 0.0F, 0.0F, 0.0F }, Point3{ 1.0F, 0.0F, 0.0F } };
+  Segment b{ Point3{ 3.0F, 1.0F, 0.0F }, Point3{ 3.0F, 2.0F, 0.0F } };
+
+  ClosestParameters parameters = closestParameters( a, b );
+  EXPECT_FLOAT_EQ( parameters.t1, 1.0F );
+  EXPECT_FLOAT_EQ( parameters.t2, 0.0F );
+  EXPECT_FLOAT_EQ( distance( a, b ), std::sqrt( 5.0F ) );
+}
+
+TEST_F( SegmentTest, DegenerateAndParallelSegments )
+{
+  Segment point{ Point3{ 1.0F, 1.0F, 0.0F }, Point3{ 1.0F, 1.0F, 0.0F } };
+  Segment a{ Point3{ 0.0F, 0.0F, 0.0F }, Point3{ 2.0F, 0.0F, 0.0F } };
+  Segment b{ Point3{ 1.0F, 3.0F, 0.0F }, Point3{ 5.0F, 3.0F, 0.0F } };
+
+  EXPECT_FLOAT_EQ( distance( point, a ), 1.0F );
+  EXPECT_FLOAT_EQ( distance( a, point ), 1.0F );
+  EXPECT_FLOAT_EQ( distance( point, point ), 0.0F );
+  EXPECT_FLOAT_EQ( distance( a, b ), 3.0F );
+}
+
+TEST_F( SegmentTest, DistanceMatchesSampling )
+{
+  for ( int i = 0; i != 20; ++i )
+  {
+    const auto f = static_cast<float>( i );
+    Segment    a{
+      Point3{ std::sin( f ), std::cos( f * 1.7F ), 0.3F * f },
+      Point3{ std::cos( f * 0.9F ) * 2.0F, 1.0F, std::sin( f * 2.3F ) }
+    };
+    Segment b{
+      Point3{ std::cos( f * 3.1F ), -std::sin( f ), 1.0F },
+      Point3{ 0.5F * f, std::sin( f * 0.4F ), -1.0F }
+    };
+    EXPECT_NEAR( distance( a, b ), bruteForceDistance( a, b ), 1e-2F );
+  }
+}
+
+TEST_F( SegmentTest, BatchedClosestParametersMatchScalar )
+{
+  constexpr size_t     count = 40;
+  std::vector<Segment> segments_a;
+  std::vector<Segment> segments_b;
+  for ( size_t i = 0; i != count; ++i )
+  {
+    const auto f = static_cast<float>( i );
+    segments_a.emplace_back( Point3{ f, 0.0F, 1.0F }, Point3{ f + 1.0F, std::sin( f ), 0.0F } );
+    segments_b.emplace_back( Point3{ 0.0F, f, -1.0F }, Point3{ std::cos( f ), f, 0.5F } );
+  }
+
+  std::array<std::vector<float>, 12> streams;
+  for ( auto& stream : streams )
+  {
+    stream.resize( count );
+  }
+  for ( size_t i = 0; i != count; ++i )
+  {
+    for ( size_t axis = 0; axis != 3; ++axis )
+    {
+      streams[axis][i]     = segments_a[i].start()[axis];
+      streams[3 + axis][i] = segments_a[i].end()[axis];
+      streams[6 + axis][i] = segments_b[i].start()[axis];
+      streams[9 + axis][i] = segments_b[i].end()[axis];
+    }
+  }
+  const auto soa = [&streams]( size_t first ) {
+    return SoASegment{
+      SoAVec3{ streams[first], streams[first + 1], streams[first + 2] },
+      SoAVec3{ streams[first + 3], streams[first + 4], streams[first + 5] }
+    };
+  };
+
+  std::vector<float> t1( count );
+  std::vector<float> t2( count );
+  getClosestParameters( soa( 0 ), soa( 6 ), t1, t2 );
+  for ( size_t i = 0; i != count; ++i )
+  {
+    ClosestParameters expected = closestParameters( segments_a[i], segments_b[i] );
+    EXPECT_FLOAT_EQ( t1[i], expected.t1 );
+    EXPECT_FLOAT_EQ( t2[i], expected.t2 );
+  }
+}
@@ -0,0 +1,143 @@
+#include "mirage_math/spatial_hash.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class SpatialHashTest : public ::testing::Test
+{
+protected:
+  std::vector<Point3> points;
+  std::vector<AABB>   boxes;
+
+  void SetUp() override
+  {
+    for ( int i = 0; i != 400; ++i )
+    {
+      const auto   f = static_cast<float>( i );
+      const Point3 point{ std::sin( f * 0.71F ) * 6.0F, std::cos( f * 1.37F ) * 6.0F, std::sin( f * 2.11F ) * 3.0F };
+      const float  size = 0.1F + 0.3F * static_cast<float>( i % 7 );
+      points.push_back( point );
+      boxes.emplace_back( point, point + Vec3{ size, size * 0.5F, size * 2.0F } );
+    }
+  }
+
+  static std::vector<uint32_t> sorted( std::vector<uint32_t> ids )
+  {
+    std::sort( ids.begin(), ids.end() );
+    return ids;
+  }
+};
+
+TEST_F( SpatialHashTest, CellOfHandlesNegativeCoordinates )
+{
+  SpatialHash grid{ 2.0F };
+  IVec3       cell = grid.cellOf( Point3{ -0.5F, 3.0F, -4.0F } );
+  EXPECT_EQ( cell.x(), -1 );
+  EXPECT_EQ( cell.y(), 1 );
+  EXPECT_EQ( cell.z(), -2 );
+}
+
+TEST_F( SpatialHashTest, CellsHoldTheirPoints )
+{
+  SpatialHash grid{ 1.5F };
+  grid.rebuild( points );
+  EXPECT_EQ( grid.size(), points.size() );
+
+  const auto cell_of = [&grid]( const IVec3& cell ) {
+    std::vector<uint32_t> ids;
+    grid.forEachInCell( cell, [&ids]( uint32_t id ) { ids.push_back( id ); } );
+    return ids;
+  };
+  for ( uint32_t i = 0; i != points.size(); ++i )
+  {
+    auto ids = cell_of( grid.cellOf( points[i] ) );
+    EXPECT_NE( std::find( ids.begin(), ids.end(), i ), ids.end() );
+    EXPECT_TRUE( std::is_sorted( ids.begin(), ids.end() ) );
+  }
+  EXPECT_GT( grid.cellCount(), 1U );
+  EXPECT_LT( grid.cellCount(), points.size() );
+  EXPECT_TRUE( cell_of( IVec3{ 100, 100, 100 } ).empty() );
+}
+
+TEST_F( SpatialHashTest, RadiusQueryMatchesBruteForce )
+{
+  SpatialHash grid{ 1.0F };
+  grid.rebuild( points );
+
+  for ( float radius : { 0.5F, 1.0F, 2.5F } )
+  {
+    const Point3          center{ 1.0F, -2.0F, 0.5F };
+    std::vector<uint32_t> found;
+    grid.queryRadius( center, radius, [&found]( uint32_t entry ) { found.push_back( entry ); } );
+
+    std::vector<uint32_t> expected;
+    for ( uint32_t i = 0; i != points.size(); ++i )
+    {
+      if ( magnitudeSquared( points[i] - center ) <= radius * radius )
+      {
+        expected.push_back( i );
+      }
+    }
+    EXPECT_EQ( sorted( found ), expected );
+  }
+}
+
+TEST_F( SpatialHashTest, BoxQueryReportsEachBoxOnce )
+{
+  SpatialHash grid{ 1.0F };
+  grid.rebuild( boxes );
+
+  const AABB            query{ Point3{ -2.0F, -3.0F, -1.0F }, Point3{ 3.0F, 1.0F, 2.0F } };
+  std::vector<uint32_t> found;
+  grid.queryOverlaps( query, [&found]( uint32_t entry ) { found.push_back( entry ); } );
+
+  std::vector<uint32_t> expected;
+  for ( uint32_t i = 0; i != boxes.size(); ++i )
+  {
+    if ( overlaps( boxes[i], query ) )
+    {
+      expected.push_back( i );
+    }
+  }
+  EXPECT_FALSE( expected.empty() );
+  EXPECT_EQ( sorted( found ), expected );
+}
+
+TEST_F( SpatialHashTest, PairQueriesMatchBruteForce )
+{
+  const auto check = []( const SpatialHash& grid, float radius, const auto& within ) {
+    std::vector<std::pair<uint32_t, uint32_t>> found;
+    grid.queryPairs( radius, [&found]( uint32_t a, uint32_t b ) { found.emplace_back( a, b ); } );
+    std::sort( found.begin(), found.end() );
+
+    std::vector<std::pair<uint32_t, uint32_t>> expected;
+    for ( uint32_t a = 0; a != grid.size(); ++a )
+    {
+      for ( uint32_t b = a + 1; b != grid.size(); ++b )
+      {
+        if ( within( a, b ) )
+        {
+          expected.emplace_back( a, b );
+        }
+      }
+    }
+    EXPECT_FALSE( expected.empty() );
+    EXPECT_EQ( found, expected );
+  };
+
+  SpatialHash point_grid{ 0.75F };
+  point_grid.rebuild( points );
+  check( point_grid, 0.75F, [this]( uint32_t a, uint32_t b ) {
+    return magnitudeSquared( points[a] - points[b] ) <= 0.75F * 0.75F;
+  } );
+
+  // Rebuilding with different input reuses the grid
+  SpatialHash box_grid{ 1.0F };
+  box_grid.rebuild( points );
+  box_grid.rebuild( boxes );
+  EXPECT_EQ( box_grid.size(), boxes.size() );
+  check( box_grid, 0.0F, [this]( uint32_t a, uint32_t b ) { return overlaps( boxes[a], boxes[b] ); } );
+}
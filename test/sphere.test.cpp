@@ -0,0 +1,92 @@
+#include "mirage_math/sphere.hpp"
+#include "test_utils.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class SphereTest : public ::testing::Test
+{
+};
+
+TEST_F( SphereTest, Overlaps )
+{
+  Sphere a{ Point3{ 0.0F, 0.0F, 0.0F }, 1.0F };
+  Sphere b{ Point3{ 1.5F, 0.0F, 0.0F }, 1.0F };
+  Sphere c{ Point3{ 3.0F, 0.0F, 0.0F }, 0.5F };
+
+  EXPECT_TRUE( overlaps( a, b ) );
+  EXPECT_FALSE( overlaps( a, c ) );
+  EXPECT_TRUE( contains( a, Point3{ 0.5F, 0.5F, 0.5F } ) );
+  EXPECT_FALSE( contains( a, Point3{ 1.0F, 1.0F, 0.0F } ) );
+}
+
+TEST_F( SphereTest, OverlapsPlane )
+{
+  Plane  plane{ 0.0F, 1.0F, 0.0F, -2.0F };
+  Sphere touching{ Point3{ 5.0F, 1.5F, 0.0F }, 0.5F };
+  Sphere above{ Point3{ 5.0F, 4.0F, 0.0F }, 1.0F };
+
+  EXPECT_TRUE( overlaps( touching, plane ) );
+  EXPECT_FALSE( overlaps( above, plane ) );
+}
+
+TEST_F( SphereTest, BoundingSphereContainsAllPoints )
+{
+  std::vector<Point3> points;
+  for ( int i = 0; i != 100; ++i )
+  {
+    const float t = static_cast<float>( i ) * 0.37F;
+    points.emplace_back( std::cos( t ) * 3.0F, std::sin( t * 1.3F ) * 2.0F, std::sin( t ) + 4.0F );
+  }
+
+  Sphere sphere = makeBoundingSphere( points );
+  for ( const auto& point : points )
+  {
+    EXPECT_LE( magnitude( point - sphere.center() ), sphere.radius() + 1e-4F );
+  }
+}
+
+TEST_F( SphereTest, BatchedOverlapsMatchScalar )
+{
+  constexpr size_t    count = 150;
+  std::vector<float>  x( count );
+  std::vector<float>  y( count );
+  std::vector<float>  z( count );
+  std::vector<float>  radius( count );
+  std::vector<Sphere> spheres;
+  for ( size_t i = 0; i != count; ++i )
+  {
+    const auto f = static_cast<float>( i );
+    x[i]         = std::fmod( f * 1.7F, 10.0F ) - 5.0F;
+    y[i]         = std::fmod( f * 2.3F, 8.0F ) - 4.0F;
+    z[i]         = std::fmod( f * 0.9F, 6.0F ) - 3.0F;
+    radius[i]    = 0.1F + std::fmod( f, 5.0F ) * 0.2F;
+    spheres.emplace_back( Point3{ x[i], y[i], z[i] }, radius[i] );
+  }
+
+  SoASphere candidates{
+    { x, y, z },
+    radius
+  };
+  Sphere                query{ Point3{ 0.5F, 0.0F, -0.5F }, 1.5F };
+  Plane                 plane{ 1.0F, 0.0F, 0.0F, -1.0F };
+  std::vector<uint64_t> mask( maskWordCount( count ) );
+  std::vector<uint64_t> plane_mask( maskWordCount( count ) );
+
+  size_t hits       = testOverlaps( query, candidates, mask );
+  size_t plane_hits = testOverlaps( plane, candidates, plane_mask );
+
+  size_t expected_hits       = 0;
+  size_t expected_plane_hits = 0;
+  for ( size_t i = 0; i != count; ++i )
+  {
+    EXPECT_EQ( isMaskSet( mask, i ), overlaps( query, spheres[i] ) );
+    EXPECT_EQ( isMaskSet( plane_mask, i ), overlaps( spheres[i], plane ) );
+    expected_hits += overlaps( query, spheres[i] ) ? 1 : 0;
+    expected_plane_hits += overlaps( spheres[i], plane ) ? 1 : 0;
+  }
+  EXPECT_EQ( hits, expected_hits );
+  EXPECT_EQ( plane_hits, expected_plane_hits );
+  EXPECT_EQ( countMask( mask ), hits );
+}
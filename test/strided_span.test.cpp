@@ -0,0 +1,123 @@
+#include "mirage_math/morton.hpp"
+#include "mirage_math/strided_span.hpp"
+#include "test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class StridedSpanTest : public ::testing::Test
+{
+protected:
+  // Interleaved vertices: position, normal and uv, 32 bytes each
+  static constexpr size_t VERTEX_FLOATS = 8;
+  static constexpr size_t STRIDE        = VERTEX_FLOATS * sizeof( float );
+
+  std::vector<float>  buffer;
+  std::vector<Point3> positions;
+
+  void SetUp() override
+  {
+    for ( size_t i = 0; i != 100; ++i )
+    {
+      const auto f = static_cast<float>( i );
+      positions.emplace_back( f, -2.0F * f, 0.5F * f - 10.0F );
+      buffer.insert( buffer.end(), { f, -2.0F * f, 0.5F * f - 10.0F, 0.0F, 0.0F, 1.0F, 0.25F, 0.75F } );
+    }
+  }
+};
+
+TEST_F( StridedSpanTest, ReadsInterleavedAttributes )
+{
+  const auto points = makeStridedSpan<Point3>( std::span<const float>{ buffer }, 0, STRIDE );
+  const auto uvs    = makeStridedSpan<Vec2>( std::span<const float>{ buffer }, 6 * sizeof( float ), STRIDE );
+  ASSERT_EQ( points.size(), positions.size() );
+  ASSERT_EQ( uvs.size(), positions.size() );
+  EXPECT_FALSE( points.isContiguous() );
+
+  for ( size_t i = 0; i != positions.size(); ++i )
+  {
+    EXPECT_TRUE( areVectorsEqual( points[i], positions[i], 0.0F ) );
+    EXPECT_TRUE( areVectorsEqual( uvs[i], Vec2{ 0.25F, 0.75F }, 0.0F ) );
+  }
+
+  // Iterators work with the standard algorithms
+  EXPECT_EQ( std::distance( points.begin(), points.end() ), 100 );
+  EXPECT_EQ( std::count_if( points.begin(), points.end(), []( const Point3& p ) { return p.x() >= 50.0F; } ), 50 );
+  EXPECT_FLOAT_EQ( ( *( points.begin() + 7 ) ).x(), 7.0F );
+
+  const auto tail = points.subspan( 90, 10 );
+  EXPECT_EQ( tail.size(), 10U );
+  EXPECT_FLOAT_EQ( tail[0].x(), 90.0F );
+
+  // A trailing partial record is not part of the view
+  buffer.resize( buffer.size() - 2 );
+  EXPECT_EQ( makeStridedSpan<Point3>( std::span<const float>{ buffer }, 0, STRIDE ).size(), 100U );
+  EXPECT_EQ( makeStridedSpan<Vec2>( std::span<const float>{ buffer }, 6 * sizeof( float ), STRIDE ).size(), 99U );
+}
+
+TEST_F( StridedSpanTest, WritesThroughReferences )
+{
+  const auto normals = makeStridedSpan<Vec3>( std::span<float>{ buffer }, 3 * sizeof( float ), STRIDE );
+  for ( size_t i = 0; i != normals.size(); ++i )
+  {
+    normals[i] = Vec3{ 1.0F, 0.0F, 0.0F } * static_cast<float>( i );
+  }
+  for ( auto normal : normals )
+  {
+    normal = normalized( Vec3{ normal } + Vec3{ 0.0F, 1.0F, 0.0F } );
+  }
+
+  EXPECT_FLOAT_EQ( buffer[VERTEX_FLOATS * 0 + 4], 1.0F );
+  EXPECT_FLOAT_EQ( buffer[VERTEX_FLOATS * 1 + 3], std::sqrt( 0.5F ) );
+
+  // Neighboring attributes are untouched
+  EXPECT_FLOAT_EQ( buffer[VERTEX_FLOATS * 5 + 2], positions[5].z() );
+  EXPECT_FLOAT_EQ( buffer[VERTEX_FLOATS * 5 + 6], 0.25F );
+
+  const StridedSpan<const Vec3> read_only = normals;
+  EXPECT_FLOAT_EQ( read_only[1].y(), std::sqrt( 0.5F ) );
+}
+
+TEST_F( StridedSpanTest, BatchAlgorithmsAcceptViews )
+{
+  const auto points = makeStridedSpan<Point3>( std::span<const float>{ buffer }, 0, STRIDE );
+  const AABB box    = makeBoundingBox( points );
+  const AABB packed = makeBoundingBox( positions );
+  EXPECT_TRUE( areVectorsEqual( box.min(), packed.min(), 0.0F ) );
+  EXPECT_TRUE( areVectorsEqual( box.max(), packed.max(), 0.0F ) );
+
+  std::vector<uint32_t> codes( positions.size() );
+  std::vector<uint32_t> packed_codes( positions.size() );
+  encodeMorton30( points, box, codes );
+  encodeMorton30( positions, box, packed_codes );
+  EXPECT_EQ( codes, packed_codes );
+
+  // Contiguous data can be viewed too
+  const StridedSpan<const Point3> contiguous{ positions };
+  EXPECT_TRUE( contiguous.isContiguous() );
+  std::vector<uint64_t> codes63( positions.size() );
+  std::vector<uint64_t> packed_codes63( positions.size() );
+  encodeMorton63( contiguous, box, codes63 );
+  encodeMorton63( positions, box, packed_codes63 );
+  EXPECT_EQ( codes63, packed_codes63 );
+}
+
+TEST_F( StridedSpanTest, IteratorsAreRandomAccess )
+{
+  using Iterator = StridedSpan<const Point3>::Iterator;
+  static_assert( std::random_access_iterator<Iterator> );
+  static_assert( std::ranges::random_access_range<StridedSpan<Point3>> );
+  // Proxy references rule out the C++17 forward iterator requirements
+  static_assert( std::is_same_v<std::iterator_traits<Iterator>::iterator_category, std::input_iterator_tag> );
+
+  const auto points = makeStridedSpan<Point3>( std::span<const float>{ buffer }, 0, STRIDE );
+  const auto highest
+    = std::ranges::max_element( points, []( const Point3& a, const Point3& b ) { return a.z() < b.z(); } );
+  EXPECT_EQ( highest - points.begin(),
+    std::ranges::max_element( positions, []( const Point3& a, const Point3& b ) { return a.z() < b.z(); } )
+      - positions.begin() );
+  EXPECT_TRUE( areVectorsEqual( points.end()[-1], positions.back(), 0.0F ) );
+}
@@ -0,0 +1,94 @@
+#include "mirage_math/sweep_and_prune.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+using namespace Mirage::Math;
+
+class SweepAndPruneTest : public ::testing::Test
+{
+protected:
+  static std::vector<AABB> makeBoxes( size_t count, float time )
+  {
+    std::vector<AABB> boxes;
+    for ( size_t i = 0; i != count; ++i )
+    {
+      const auto   f = static_cast<float>( i );
+      const Point3 min{ std::sin( f * 0.37F + time ) * 20.0F, std::cos( f * 1.13F ) * 5.0F, std::sin( f * 2.9F ) * 5.0F };
+      const float  size = 0.5F + 0.25F * static_cast<float>( i % 5 );
+      boxes.emplace_back( min, min + Vec3{ size, size, size } );
+    }
+    return boxes;
+  }
+
+  static std::vector<std::pair<uint32_t, uint32_t>> bruteForcePairs( const std::vector<AABB>& boxes )
+  {
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    for ( uint32_t a = 0; a != boxes.size(); ++a )
+    {
+      for ( uint32_t b = a + 1; b != boxes.size(); ++b )
+      {
+        if ( overlaps( boxes[a], boxes[b] ) )
+        {
+          pairs.emplace_back( a, b );
+        }
+      }
+    }
+    return pairs;
+  }
+
+  static std::vector<std::pair<uint32_t, uint32_t>> findPairs( const SweepAndPrune& sap )
+  {
+    std::vector<OverlapPair> buffer( 16 );
+    size_t                   count = sap.findPairs( buffer );
+    if ( count > buffer.size() )
+    {
+      buffer.resize( count );
+      EXPECT_EQ( sap.findPairs( buffer ), count );
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    for ( size_t i = 0; i != count; ++i )
+    {
+      EXPECT_LT( buffer[i].a, buffer[i].b );
+      pairs.emplace_back( buffer[i].a, buffer[i].b );
+    }
+    std::sort( pairs.begin(), pairs.end() );
+    return pairs;
+  }
+};
+
+TEST_F( SweepAndPruneTest, PairsMatchBruteForce )
+{
+  const auto    boxes = makeBoxes( 300, 0.0F );
+  SweepAndPrune sap;
+  sap.update( boxes );
+
+  EXPECT_EQ( sap.axis(), 0U );
+  const auto expected = bruteForcePairs( boxes );
+  EXPECT_GT( expected.size(), 16U );
+  EXPECT_EQ( findPairs( sap ), expected );
+}
+
+TEST_F( SweepAndPruneTest, IncrementalUpdatesTrackMotion )
+{
+  // A tiny budget forces the radix fallback on the large step, the small steps stay incremental
+  SweepAndPrune sap{
+    SweepAndPruneOptions{ 2, RadixSortOptions{ .parallelThreshold = 64, .grainSize = 150 } }
+  };
+  for ( float time : { 0.0F, 0.01F, 0.02F, 1.5F, 1.51F } )
+  {
+    const auto boxes = makeBoxes( 300, time );
+    sap.update( boxes );
+
+    auto order = sap.order();
+    EXPECT_TRUE( std::is_sorted( order.begin(), order.end(), [&boxes]( uint32_t a, uint32_t b ) {
+      return boxes[a].min().x() < boxes[b].min().x();
+    } ) );
+    EXPECT_EQ( findPairs( sap ), bruteForcePairs( boxes ) );
+  }
+
+  sap.update( makeBoxes( 10, 0.0F ) );
+  EXPECT_EQ( findPairs( sap ), bruteForcePairs( makeBoxes( 10, 0.0F ) ) );
+}
@@ -82,3 +82,26 @@ TEST_F( Transform4Test, PointVsVector )
   EXPECT_FLOAT_EQ( point.y() + translate.y(), point_translated.y() );
   EXPECT_FLOAT_EQ( point.z() + translate.z(), point_translated.z() );
 }
+
+TEST_F( Transform4Test, Compose )
+{
+  // Quarter turn about z, then a translation
+  const Transform4 rotation{ 0.0F, -1.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F };
+  Transform4       shift{ Transform4::identity() };
+  shift.setTranslation( Point3{ 1.0F, 2.0F, 3.0F } );
+
+  const Transform4 combined = compose( rotation, shift );
+  const Point3     point{ 1.0F, 0.0F, 0.0F };
+
+  const Point3 expected = shift * ( rotation * point );
+  const Point3 actual   = combined * point;
+  EXPECT_FLOAT_EQ( actual.x(), expected.x() );
+  EXPECT_FLOAT_EQ( actual.y(), expected.y() );
+  EXPECT_FLOAT_EQ( actual.z(), expected.z() );
+  EXPECT_FLOAT_EQ( actual.y(), 3.0F );
+
+  // The other order rotates the translated point
+  const Point3 reversed = compose( shift, rotation ) * point;
+  EXPECT_FLOAT_EQ( reversed.x(), -2.0F );
+  EXPECT_FLOAT_EQ( reversed.y(), 2.0F );
+}